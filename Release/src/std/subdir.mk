@@ -4,18 +4,21 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../src/std/arena.c \
 ../src/std/assert.c \
 ../src/std/input.c \
 ../src/std/memory.c \
 ../src/std/string.c 
 
 OBJS += \
+./src/std/arena.o \
 ./src/std/assert.o \
 ./src/std/input.o \
 ./src/std/memory.o \
 ./src/std/string.o 
 
 C_DEPS += \
+./src/std/arena.d \
 ./src/std/assert.d \
 ./src/std/input.d \
 ./src/std/memory.d \
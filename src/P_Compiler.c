@@ -53,6 +53,7 @@ int main(int argc, char *argv[]) {
     int out_dot = 1;
     PScanner *scanner = scanner_alloc();
     PGrammar *grammar = regexp_grammar();
+    PParser *parser = parser_alloc();
 
     if(2 >= argc) {
         return print_options();
@@ -85,6 +86,7 @@ int main(int argc, char *argv[]) {
                && ('d' == argv[i][1] || 'm' == argv[i][1] || 'n' == argv[i][1])){
 
             regexp_parse(
+                parser,
                 grammar,
                 scanner,
                 nfa,
@@ -112,6 +114,7 @@ int main(int argc, char *argv[]) {
     }
     nfa_free(dfa);
     set_free(set);
+    parser_free(parser);
     scanner_free(scanner);
     grammar_free(grammar);
 
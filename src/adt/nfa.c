@@ -16,6 +16,12 @@
 #define NFA_NUM_DEFAULT_STATES 256
 #define NFA_NUM_DEFAULT_STATE_TRANSITIONS 4
 #define NFA_MAX_EPSILON_STACK 256
+#define NFA_NUM_BYTES 256
+#define NFA_MAX_RUN_RANGES 8 /* S_MAX_RUN_RANGES of the scanner */
+#define NFA_MAX_KEYWORD_SEED 65536
+#define NFA_KEYWORD_BASIS 2166136261U /* S_KEYWORD_BASIS of the scanner */
+#define NFA_KEYWORD_HASH(h, c) /* S_KEYWORD_HASH of the scanner */ \
+    ((uint32_t) ((((uint32_t) (h)) ^ ((uint32_t) (c))) * 16777619U))
 #define NFA_UNUSED_STATE ((void *) 0x1)
 
 static int LABEL_SUBSETS = 0;
@@ -195,6 +201,129 @@ static unsigned int NFA_max_alphabet_char(PNFA *nfa) {
     return max;
 }
 
+/**
+ * Partition the alphabet into byte equivalence classes: two bytes are in the
+ * same class if every transition of the NFA accepts either both of them or
+ * neither of them, which means that no automaton built from this NFA can tell
+ * them apart. classes[c] is set to the class of byte c, where classes are
+ * numbered in order of their smallest byte. Returns the number of classes.
+ */
+static unsigned int NFA_byte_classes(const PNFA *nfa,
+                                     unsigned char *classes) {
+
+    unsigned int num_classes = 1,
+                 next_class,
+                 key;
+
+    int remap[2 * NFA_NUM_BYTES],
+        c,
+        i,
+        in;
+
+    NFA_TransitionGroup *group;
+    NFA_Transition *trans;
+
+    memset(classes, 0, NFA_NUM_BYTES * sizeof(unsigned char));
+
+    /* refine the partition by each transition in turn, splitting every class
+     * into the bytes that the transition accepts and those that it doesn't. */
+    for(group = nfa->transition_group; is_not_null(group); group = group->next) {
+        trans = group->transitions;
+        for(i = group->num_transitions; --i >= 0; ++trans) {
+            if(trans->type != T_VALUE && trans->type != T_SET) {
+                continue;
+            }
+
+            for(c = 2 * num_classes; --c >= 0; ) {
+                remap[c] = -1;
+            }
+
+            for(next_class = 0, c = 0; c < NFA_NUM_BYTES; ++c) {
+                if(trans->type == T_VALUE) {
+                    in = (trans->condition.value == c);
+                } else {
+                    in = set_has_elm(trans->condition.set, (unsigned int) c);
+                }
+
+                key = (2 * classes[c]) + (in ? 1 : 0);
+                if(remap[key] < 0) {
+                    remap[key] = (int) next_class++;
+                }
+                classes[c] = (unsigned char) remap[key];
+            }
+
+            num_classes = next_class;
+        }
+    }
+
+    D( printf("\t found %u byte classes. \n", num_classes); )
+
+    return num_classes;
+}
+
+/**
+ * Partition the alphabet of a DFA into byte equivalence classes. Every
+ * transition of a DFA is on a single byte, so instead of asking which bytes a
+ * transition accepts, two bytes are in the same class if every state goes to
+ * the same state on both of them. classes[c] is set to the class of byte c,
+ * where classes are numbered in order of their smallest byte. Returns the
+ * number of classes.
+ */
+static unsigned int DFA_byte_classes(const PNFA *dfa,
+                                     unsigned char *classes) {
+
+    unsigned int num_classes = 1,
+                 next_class,
+                 state,
+                 dest[NFA_NUM_BYTES],
+                 reps[NFA_NUM_BYTES];
+
+    unsigned char new_classes[NFA_NUM_BYTES];
+
+    int c,
+        k;
+
+    NFA_Transition *trans;
+
+    memset(classes, 0, NFA_NUM_BYTES * sizeof(unsigned char));
+
+    for(state = 0; state < dfa->num_states; ++state) {
+        trans = dfa->state_transitions[state];
+        if(NFA_UNUSED_STATE == trans || is_null(trans)) {
+            continue;
+        }
+
+        for(c = 0; c < NFA_NUM_BYTES; ++c) {
+            dest[c] = dfa->num_states;
+        }
+        for(; is_not_null(trans); trans = trans->trans_next) {
+            dest[(unsigned char) trans->condition.value] = trans->to_state;
+        }
+
+        /* split every class into the bytes that go to the same state from
+         * this state; reps holds the smallest byte of each new class. */
+        for(next_class = 0, c = 0; c < NFA_NUM_BYTES; ++c) {
+            for(k = 0; k < (int) next_class; ++k) {
+                if(classes[reps[k]] == classes[c]
+                && dest[reps[k]] == dest[c]) {
+                    break;
+                }
+            }
+            if(k == (int) next_class) {
+                reps[next_class++] = (unsigned int) c;
+            }
+            new_classes[c] = (unsigned char) k;
+        }
+
+        memcpy(classes, new_classes, sizeof new_classes);
+        num_classes = next_class;
+    }
+
+    D( printf("\t found %u byte classes in the DFA. \n", num_classes); )
+
+    return num_classes;
+}
+
 /**
  * Find the transitive closure of epsilon transitions on a particular set of
  * states. The epsilon closure for the set of states is added to the set of
@@ -357,19 +486,26 @@ static void *uint_to_pointer(unsigned int val) {
 }
 
 /**
- * Perform the subset construction on the NFA to turn it into a DFA.
+ * Perform the subset construction on the NFA to turn it into a DFA. The bytes
+ * of each class in classes behave identically, so the transitions on a class
+ * are only simulated once, on its largest byte, and then copied to the other
+ * bytes of the class.
  */
 static PNFA *NFA_subset_construction(PNFA *nfa,
                                      PSet *priority_set,
-                                     int largest_char) {
+                                     int largest_char,
+                                     const unsigned char *classes) {
 
     unsigned int next_state_id,
                  prev_state_id,
                  num_dfa_states = 0;
 
     int c,
+        b,
         as;
 
+    char simulated[NFA_NUM_BYTES];
+
     DFA_State dfa_state_stack[NFA_NUM_DEFAULT_STATES],
               *state;
 
@@ -456,9 +592,16 @@ static PNFA *NFA_subset_construction(PNFA *nfa,
 
         D( printf("Simulating state transitions... \n"); )
 
+        memset(simulated, 0, sizeof simulated);
+
         /* -1 is for testing alpha-transitions */
         for(c = largest_char; --c >= 0; ) {
 
+            if(simulated[classes[c]]) {
+                continue;
+            }
+            simulated[classes[c]] = 1;
+
             /* for each state in state->nfa_states, attempt to transition on the
              * input c and if a transition on c exists then add the destination
              * state to the return set. */
@@ -534,13 +677,17 @@ static PNFA *NFA_subset_construction(PNFA *nfa,
                 );
             }
 
-            /* add in the new transition */
-            nfa_add_value_transition(
-                dfa,
-                prev_state_id,
-                next_state_id,
-                c
-            );
+            /* add in the new transition on every byte of c's class */
+            for(b = c; b >= 0; --b) {
+                if(classes[b] == classes[c]) {
+                    nfa_add_value_transition(
+                        dfa,
+                        prev_state_id,
+                        next_state_id,
+                        b
+                    );
+                }
+            }
         }
 
         D( printf("done. \n"); )
@@ -571,8 +718,7 @@ static void collect_transitions(
     const unsigned num_states,
     const int largest_char,
     NFA_Transition *trans,
-    unsigned *destination_states,
-    PSet *alphabet
+    unsigned *destination_states
 ) {
     int k;
     for(k = 0; k <= largest_char; ++k) {
@@ -582,28 +728,14 @@ static void collect_transitions(
     for(; NULL != trans; trans = trans->trans_next) {
         assert(T_VALUE == trans->type);
         destination_states[trans->condition.value] = trans->to_state;
-        set_add_elm(alphabet, trans->condition.value);
     }
 }
 
-struct mdfa_state_pair {
-    PNFA *mdfa;
-    unsigned state;
-};
-
-static void add_sink_state_transitions(struct mdfa_state_pair *pair, unsigned int label) {
-    nfa_add_value_transition(
-        pair->mdfa,
-        pair->state,
-        pair->mdfa->num_states - 1,
-        (int) label
-    );
-}
-
-static PNFA *DFA_minimize(PNFA *dfa, const int largest_char) {
+static PNFA *DFA_minimize(PNFA *dfa,
+                          const int largest_char,
+                          const unsigned char *classes) {
 
     PNFA *mdfa;
-    PSet *alphabet = set_alloc();
     PSet *seen_chars = NULL;
     PSet **state_subsets;
     char *distinguishable = NULL;
@@ -618,11 +750,19 @@ static PNFA *DFA_minimize(PNFA *dfa, const int largest_char) {
     NFA_Transition *trans;
     const unsigned i = 0, j = 1;
     unsigned k;
-    unsigned need_sink_state = 0;
-    struct mdfa_state_pair mdfa_and_state_id;
-
-    /* scale the alphabet up */
-    set_add_elm(alphabet, largest_char);
+    unsigned representatives[NFA_NUM_BYTES],
+             num_representatives = 0;
+    char seen_class[NFA_NUM_BYTES];
+
+    /* all bytes of a class go to the same states, so only one byte of each
+     * class needs to be checked when distinguishing states. */
+    memset(seen_class, 0, sizeof seen_class);
+    for(k = 0; k <= ((unsigned) largest_char); ++k) {
+        if(!seen_class[classes[k]]) {
+            seen_class[classes[k]] = 1;
+            representatives[num_representatives++] = k;
+        }
+    }
 
     distinguishable = mem_calloc(
         (num_states + 1) * (num_states + 1),
@@ -656,8 +796,7 @@ static PNFA *DFA_minimize(PNFA *dfa, const int largest_char) {
                 num_states,
                 largest_char,
                 dfa->state_transitions[state_i],
-                destination_states[i],
-                alphabet
+                destination_states[i]
             );
 
             /* for every state j: */
@@ -676,9 +815,12 @@ static PNFA *DFA_minimize(PNFA *dfa, const int largest_char) {
                     continue;
                 }
 
-                /* one state accepts and another doesn't */
-                if(state_i_is_accepting
-                && !set_has_elm(dfa->accepting_states, state_j)) {
+                /* one state accepts and another doesn't, or both accept but
+                 * they conclude different things */
+                if((state_i_is_accepting
+                    && !set_has_elm(dfa->accepting_states, state_j))
+                || (state_i_is_accepting
+                    && dfa->conclusions[state_i] != dfa->conclusions[state_j])) {
 
                     D( printf("\t\tstate %d and state %d are distinguishable (final, non-final)\n", state_i, state_j); )
 
@@ -694,16 +836,15 @@ static PNFA *DFA_minimize(PNFA *dfa, const int largest_char) {
                     num_states,
                     largest_char,
                     dfa->state_transitions[state_j],
-                    destination_states[j],
-                    alphabet
+                    destination_states[j]
                 );
 
                 /* check for distinguishability */
-                for(k = 0; k <= ((unsigned) largest_char); ++k) {
+                for(k = 0; k < num_representatives; ++k) {
 
                     if(1 == distinguishable[AT(
-                        destination_states[i][k],
-                        destination_states[j][k],
+                        destination_states[i][representatives[k]],
+                        destination_states[j][representatives[k]],
                         num_states
                     )]) {
 
@@ -762,6 +903,11 @@ static PNFA *DFA_minimize(PNFA *dfa, const int largest_char) {
                 /* collect the final states */
                 if(set_has_elm(dfa->accepting_states, state_j)) {
                     nfa_add_accepting_state(mdfa, new_state_ids[state_i]);
+                    nfa_add_conclusion(
+                        mdfa,
+                        new_state_ids[state_i],
+                        dfa->conclusions[state_j]
+                    );
                 }
 
                 if(LABEL_SUBSETS) {
@@ -803,13 +949,10 @@ static PNFA *DFA_minimize(PNFA *dfa, const int largest_char) {
         old_state_reps[new_state_ids[k]] = k;
     }
 
-    /* add in the transitions for all states but the sink state */
-    seen_chars = set_copy(alphabet);
-    mdfa_and_state_id.mdfa = mdfa;
-
+    /* add in the transitions for all states but the sink state. the sink state
+     * is the last state, and is dropped: a missing transition already rejects
+     * the input, whereas a scanner in the sink state would keep reading. */
     for(num_states = mdfa->num_states - 1, k = 0; k < num_states; ++k) {
-        set_empty(seen_chars);
-
         for(trans = dfa->state_transitions[old_state_reps[k]];
             NULL != trans;
             trans = trans->trans_next) {
@@ -820,35 +963,10 @@ static PNFA *DFA_minimize(PNFA *dfa, const int largest_char) {
                 new_state_ids[trans->to_state],
                 trans->condition.value
             );
-
-            set_add_elm(seen_chars, trans->condition.value);
         }
-
-        mdfa_and_state_id.state = k;
-        set_complement_inplace(seen_chars);
-        set_intersect_inplace(seen_chars, alphabet);
-        need_sink_state += set_cardinality(seen_chars);
-        set_map(
-            seen_chars,
-            (void *) &mdfa_and_state_id,
-            (PSetMapFunc *) &add_sink_state_transitions
-        );
-    }
-
-    /* add in transitions on the sink state */
-    if(need_sink_state) {
-        mdfa_and_state_id.state = mdfa->num_states - 1;
-        set_map(
-            alphabet,
-            (void *) &mdfa_and_state_id,
-            (PSetMapFunc *) &add_sink_state_transitions
-        );
-    } else {
-        mdfa->num_states -= 1;
     }
 
-    set_free(alphabet);
-    set_free(seen_chars);
+    mdfa->num_states -= 1;
 
     mem_free(old_state_reps);
     mem_free(new_state_ids);
@@ -951,21 +1069,24 @@ void nfa_free(PNFA *nfa) {
 
 PNFA *nfa_to_dfa(PNFA *nfa, PSet *priority_set) {
     int largest_char;
-    PNFA *dfa = NULL;
+    unsigned char classes[NFA_NUM_BYTES];
     assert_not_null(nfa);
 
     largest_char = NFA_max_alphabet_char(nfa);
-    return NFA_subset_construction(nfa, priority_set, largest_char);
+    NFA_byte_classes(nfa, classes);
+    return NFA_subset_construction(nfa, priority_set, largest_char, classes);
 }
 
 PNFA *nfa_to_mdfa(PNFA *nfa, PSet *priority_set) {
     int largest_char;
+    unsigned char classes[NFA_NUM_BYTES];
     PNFA *dfa = NULL;
     assert_not_null(nfa);
 
     largest_char = NFA_max_alphabet_char(nfa);
-    nfa = NFA_subset_construction(nfa, priority_set, largest_char);
-    dfa = DFA_minimize(nfa, largest_char);
+    NFA_byte_classes(nfa, classes);
+    nfa = NFA_subset_construction(nfa, priority_set, largest_char, classes);
+    dfa = DFA_minimize(nfa, largest_char, classes);
     nfa_free(nfa);
     return dfa;
 }
@@ -1021,6 +1142,10 @@ unsigned int nfa_add_state(PNFA *nfa) {
             1
         );
 
+        nfa->state_transitions = (NFA_Transition **) transitions;
+        nfa->destination_states = (NFA_Transition **) destinations;
+        nfa->conclusions = (int *) conclusions;
+
         if(nfa->num_state_slots > old) {
             memset(
                 nfa->destination_states + old,
@@ -1159,6 +1284,78 @@ void nfa_add_set_transition(PNFA *nfa,
     trans->condition.set = test_set;
 }
 
+/**
+ * Run a DFA over some text and return the conclusion of the state that it
+ * ends in if that state is an accepting state, or -1 if it is not.
+ */
+int nfa_match(const PNFA *dfa, const unsigned char *text, unsigned int length) {
+    NFA_Transition *trans;
+    unsigned int state,
+                 i;
+
+    assert_not_null(dfa);
+
+    state = dfa->start_state;
+
+    for(i = 0; i < length; ++i) {
+        trans = dfa->state_transitions[state];
+        if(NFA_UNUSED_STATE == trans) {
+            return -1;
+        }
+        for(; is_not_null(trans); trans = trans->trans_next) {
+            if(T_VALUE == trans->type && text[i] == trans->condition.value) {
+                break;
+            }
+        }
+        if(is_null(trans)) {
+            return -1;
+        }
+        state = trans->to_state;
+    }
+
+    if(!set_has_elm(dfa->accepting_states, state)) {
+        return -1;
+    }
+
+    return dfa->conclusions[state];
+}
+
+/**
+ * If a DFA accepts exactly one string, and that string is at most max_length
+ * characters long, put the string into 'text' and return its length.
+ * Otherwise, return -1.
+ */
+int nfa_only_string(const PNFA *dfa,
+                    unsigned char *text,
+                    unsigned int max_length) {
+    NFA_Transition *trans;
+    unsigned int state,
+                 length = 0;
+
+    assert_not_null(dfa);
+    assert_not_null(text);
+
+    for(state = dfa->start_state; ; state = trans->to_state) {
+        trans = dfa->state_transitions[state];
+        if(NFA_UNUSED_STATE == trans) {
+            trans = NULL;
+        }
+
+        if(set_has_elm(dfa->accepting_states, state)) {
+            return is_null(trans) ? (int) length : -1;
+        }
+
+        if(is_null(trans)
+        || is_not_null(trans->trans_next)
+        || T_VALUE != trans->type
+        || length >= max_length) {
+            return -1;
+        }
+
+        text[length++] = (unsigned char) trans->condition.value;
+    }
+}
+
 /* -------------------------------------------------------------------------- */
 
 typedef struct nfa_state_pair {
@@ -1597,29 +1794,16 @@ void nfa_print_latex(PNFA *nfa) {
 #define P fprintf
 
 /**
- * Print a NFA as a C scanner into the file specified.
+ * Open the file that a scanner will be printed into and print out the parts
+ * of it that come before the scanner function.
  */
-void nfa_print_scanner(const PNFA *nfa,
-                       const char *out_file,
-                       const char *func_name) {
-    FILE *F;
-    PSet *astates;
-    NFA_Transition *trans,
-                   **transitions;
-    int i,
-        n;
-
-    assert_not_null(nfa);
-    assert_not_null(out_file);
-
-    F = fopen(out_file, "w");
+static FILE *NFA_print_scanner_head(const char *out_file,
+                                    const char *func_name) {
+    FILE *F = fopen(out_file, "w");
     if(is_null(F)) {
         std_error("Error: Unable to create file for NFA export");
     }
 
-    astates = nfa->accepting_states;
-    transitions = nfa->state_transitions;
-
     P(F, "\n");
     P(F, "#ifndef _P_SCANNER_%s_\n", func_name);
     P(F, "#define _P_SCANNER_%s_\n", func_name);
@@ -1628,12 +1812,547 @@ void nfa_print_scanner(const PNFA *nfa,
     P(F, "#include <p-types.h>\n");
     P(F, "#include <p-scanner.h>\n\n");
     P(F, "extern G_Terminal %s(PScanner *);\n\n", func_name);
+
+    return F;
+}
+
+/**
+ * Print out the start of a scanner function and the variables that both
+ * scanner backends share. A scanner that reads through a cursor keeps a
+ * pointer to the next character in the buffer and a limit on how far that
+ * pointer can go before the buffer needs to be refilled; otherwise, it keeps
+ * a count of the characters it has advanced past.
+ */
+static void NFA_print_scanner_entry(FILE *F,
+                                    const char *func_name,
+                                    int cursor) {
     P(F, "G_Terminal %s(PScanner *S) {\n", func_name);
     P(F, "    G_Terminal term = -1;\n");
     P(F, "    unsigned int seen_accepting_state = 0;\n");
-    P(F, "    int cc, nc = 0, pnc = 0;\n");
-    P(F, "    scanner_skip(S, &isspace);\n");
-    P(F, "    scanner_mark_lexeme_start(S);\n");
+    if(cursor) {
+        P(F, "    int cc;\n");
+        P(F, "    unsigned char *cursor, *limit;\n");
+    } else {
+        P(F, "    int cc, nc = 0, pnc = 0;\n");
+    }
+}
+
+/**
+ * Print out the statements that begin matching a lexeme.
+ */
+static void NFA_print_scanner_start(FILE *F, int cursor) {
+    P(F, "    scanner_skip_space(S);\n");
+    if(cursor) {
+        P(F, "    cursor = scanner_mark_lexeme_start(S);\n");
+        P(F, "    cursor = scanner_refill(S, cursor, &limit);\n");
+    } else {
+        P(F, "    scanner_mark_lexeme_start(S);\n");
+    }
+}
+
+/**
+ * Print out the statements that read the next character into 'cc', going to
+ * undo_and_commit if there are none left. A scanner that reads through a
+ * cursor only calls into the scanner when its cursor reaches its limit.
+ */
+static void NFA_print_scanner_read(FILE *F, const char *indent, int cursor) {
+    if(cursor) {
+        P(F, "%sif(cursor >= limit) {\n", indent);
+        P(F, "%s    cursor = scanner_refill(S, cursor, &limit);\n", indent);
+        P(F, "%s    if(cursor >= limit) { goto undo_and_commit; }\n", indent);
+        P(F, "%s}\n", indent);
+        P(F, "%scc = *cursor++;\n", indent);
+    } else {
+        P(
+            F,
+            "%sif(!(cc = scanner_advance(S))) { goto undo_and_commit; }\n",
+            indent
+        );
+        P(F, "%s++nc;\n", indent);
+    }
+}
+
+/**
+ * Print out the statements that remember the current position as the end of
+ * the longest lexeme matched so far. A scanner that reads through a cursor
+ * keeps it as the end of the lexeme, which stays correct when the buffer is
+ * flushed.
+ */
+static void NFA_print_scanner_accept(FILE *F, const char *indent, int cursor) {
+    if(cursor) {
+        P(F, "%sS->lexeme.end = cursor;\n", indent);
+    } else {
+        P(F, "%spnc = nc;\n", indent);
+    }
+    P(F, "%sseen_accepting_state = 1;\n", indent);
+}
+
+/**
+ * Return true if a keyword is the first of those covered by its terminal.
+ */
+static int NFA_first_covered(const NFA_Keyword *keywords, unsigned int which) {
+    unsigned int i;
+    for(i = 0; i < which; ++i) {
+        if(keywords[i].covered_by == keywords[which].covered_by) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * Hash some text the same way that scanner_keyword does.
+ */
+static uint32_t NFA_keyword_hash(uint32_t seed,
+                                 const unsigned char *text,
+                                 unsigned int length) {
+    uint32_t hash = NFA_KEYWORD_BASIS ^ seed;
+    unsigned int i;
+
+    for(i = 0; i < length; ++i) {
+        hash = NFA_KEYWORD_HASH(hash, text[i]);
+    }
+
+    return hash;
+}
+
+/**
+ * Try to place the keywords in 'members' into a perfect hash table with
+ * num_slots slots. The keywords are split up into buckets by their hash, and
+ * then, going from the biggest bucket to the smallest, each bucket is given
+ * the first seed that hashes all of its keywords into slots that are still
+ * empty. Returns 0 if some bucket has no such seed.
+ */
+static int NFA_place_keywords(const NFA_Keyword *keywords,
+                              const unsigned int *members,
+                              unsigned int num_members,
+                              uint32_t *seeds,
+                              unsigned int num_buckets,
+                              int *slots,
+                              unsigned int num_slots) {
+    unsigned int *buckets,
+                 *placed,
+                 size,
+                 max_size = 0,
+                 bucket,
+                 num_placed,
+                 i,
+                 j;
+    uint32_t seed;
+    const NFA_Keyword *keyword;
+    int ok = 1;
+
+    buckets = mem_calloc(num_members, sizeof(unsigned int));
+    placed = mem_calloc(num_members, sizeof(unsigned int));
+    if(is_null(buckets) || is_null(placed)) {
+        mem_error("Internal NFA Error: Unable to allocate keyword buckets.");
+    }
+
+    for(i = 0; i < num_slots; ++i) {
+        slots[i] = -1;
+    }
+
+    for(i = 0; i < num_members; ++i) {
+        keyword = keywords + members[i];
+        buckets[i] = NFA_keyword_hash(
+            0,
+            keyword->text,
+            keyword->length
+        ) % num_buckets;
+    }
+
+    for(bucket = 0; bucket < num_buckets; ++bucket) {
+        seeds[bucket] = 0;
+        for(size = 0, i = 0; i < num_members; ++i) {
+            size += (buckets[i] == bucket);
+        }
+        if(size > max_size) {
+            max_size = size;
+        }
+    }
+
+    for(size = max_size; ok && size > 0; --size) {
+        for(bucket = 0; ok && bucket < num_buckets; ++bucket) {
+
+            for(j = 0, i = 0; i < num_members; ++i) {
+                j += (buckets[i] == bucket);
+            }
+            if(j != size) {
+                continue;
+            }
+
+            for(seed = 1; seed < NFA_MAX_KEYWORD_SEED; ++seed) {
+                num_placed = 0;
+                for(i = 0; i < num_members; ++i) {
+                    if(buckets[i] != bucket) {
+                        continue;
+                    }
+                    keyword = keywords + members[i];
+                    j = NFA_keyword_hash(
+                        seed,
+                        keyword->text,
+                        keyword->length
+                    ) % num_slots;
+                    if(slots[j] >= 0) {
+                        break;
+                    }
+                    slots[j] = (int) members[i];
+                    placed[num_placed++] = j;
+                }
+
+                if(i == num_members) {
+                    seeds[bucket] = seed;
+                    break;
+                }
+
+                /* undo the slots that this seed filled */
+                while(num_placed--) {
+                    slots[placed[num_placed]] = -1;
+                }
+            }
+
+            ok = (seed < NFA_MAX_KEYWORD_SEED);
+        }
+    }
+
+    mem_free(buckets);
+    mem_free(placed);
+
+    return ok;
+}
+
+/**
+ * Print out a perfect hash table for the keywords covered by a terminal, as a
+ * PScannerKeywords named after the scanner function and the terminal. The
+ * table starts off with as many slots as there are keywords and grows until
+ * the keywords can be placed into it.
+ */
+static void NFA_print_keywords(FILE *F,
+                               const char *func_name,
+                               const NFA_Keyword *keywords,
+                               unsigned int num_keywords,
+                               int covered_by) {
+    unsigned int *members,
+                 num_members = 0,
+                 num_buckets,
+                 num_slots,
+                 max_length = 0,
+                 i,
+                 j;
+    uint32_t *seeds;
+    int *slots;
+    const NFA_Keyword *keyword;
+
+    members = mem_calloc(num_keywords, sizeof(unsigned int));
+    if(is_null(members)) {
+        mem_error("Internal NFA Error: Unable to allocate keywords.");
+    }
+
+    for(i = 0; i < num_keywords; ++i) {
+        if(keywords[i].covered_by != covered_by) {
+            continue;
+        }
+
+        for(j = 0; j < num_members; ++j) {
+            keyword = keywords + members[j];
+            if(keyword->length == keywords[i].length
+            && 0 == memcmp(keyword->text, keywords[i].text, keyword->length)) {
+                std_error(
+                    "Internal NFA Error: Cannot put the same keyword into a "
+                    "keyword table twice."
+                );
+            }
+        }
+
+        members[num_members++] = i;
+        if(keywords[i].length > max_length) {
+            max_length = keywords[i].length;
+        }
+    }
+
+    num_buckets = (num_members / 2) + 1;
+    num_slots = num_members;
+
+    seeds = mem_calloc(num_buckets, sizeof(uint32_t));
+    slots = mem_calloc(num_members * 2, sizeof(int));
+    if(is_null(seeds) || is_null(slots)) {
+        mem_error("Internal NFA Error: Unable to allocate keyword table.");
+    }
+
+    while(!NFA_place_keywords(keywords,
+                              members,
+                              num_members,
+                              seeds,
+                              num_buckets,
+                              slots,
+                              num_slots)) {
+        ++num_slots;
+        if(num_slots > (num_members * 2)) {
+            std_error(
+                "Internal NFA Error: Unable to find a perfect hash for the "
+                "keywords."
+            );
+        }
+    }
+
+    P(
+        F,
+        "static const uint32_t %s_keyword_seeds_%d[%u] = {",
+        func_name,
+        covered_by,
+        num_buckets
+    );
+    for(i = 0; i < num_buckets; ++i) {
+        P(F, "%s%lu", (0 == (i % 8)) ? "\n    " : "", (unsigned long) seeds[i]);
+        if(i + 1 < num_buckets) {
+            P(F, ",");
+        }
+    }
+    P(F, "\n};\n\n");
+
+    P(
+        F,
+        "static const PScannerKeyword %s_keyword_slots_%d[%u] = {\n",
+        func_name,
+        covered_by,
+        num_slots
+    );
+    for(i = 0; i < num_slots; ++i) {
+
+        /* empty slots hold a keyword that no lexeme matches, or that leaves
+         * its terminal unchanged. */
+        if(slots[i] < 0) {
+            P(F, "    {\"\", 0, %d}", covered_by);
+        } else {
+            keyword = keywords + slots[i];
+            P(F, "    {\"");
+            for(j = 0; j < keyword->length; ++j) {
+                if(isalnum(keyword->text[j]) || '_' == keyword->text[j]) {
+                    P(F, "%c", keyword->text[j]);
+                } else {
+                    P(F, "\\%03o", keyword->text[j]);
+                }
+            }
+            P(F, "\", %u, %d}", keyword->length, keyword->conclusion);
+        }
+        P(F, "%s\n", (i + 1 < num_slots) ? "," : "");
+    }
+    P(F, "};\n\n");
+
+    P(
+        F,
+        "static const PScannerKeywords %s_keywords_%d = {\n",
+        func_name,
+        covered_by
+    );
+    P(F, "    %u, %u, %u,\n", num_buckets, num_slots, max_length);
+    P(F, "    %s_keyword_seeds_%d,\n", func_name, covered_by);
+    P(F, "    %s_keyword_slots_%d\n", func_name, covered_by);
+    P(F, "};\n\n");
+
+    mem_free(members);
+    mem_free(seeds);
+    mem_free(slots);
+}
+
+/**
+ * Print out the keyword tables of a scanner function.
+ */
+static void NFA_print_scanner_keywords(FILE *F,
+                                       const char *func_name,
+                                       const NFA_Keyword *keywords,
+                                       unsigned int num_keywords) {
+    unsigned int i;
+    for(i = 0; i < num_keywords; ++i) {
+        if(NFA_first_covered(keywords, i)) {
+            NFA_print_keywords(
+                F,
+                func_name,
+                keywords,
+                num_keywords,
+                keywords[i].covered_by
+            );
+        }
+    }
+}
+
+/**
+ * Print out the end of a scanner function, which pushes back any characters
+ * read past the last accepting state, commits to the lexeme, and looks up the
+ * lexeme in the keyword table of its terminal, if it has one. Close the file.
+ */
+static void NFA_print_scanner_tail(FILE *F,
+                                   const char *func_name,
+                                   int cursor,
+                                   const NFA_Keyword *keywords,
+                                   unsigned int num_keywords) {
+    unsigned int i;
+
+    P(F, "undo_and_commit:\n");
+    if(cursor) {
+        P(F, "    if(!seen_accepting_state) {\n");
+        P(F, "        S->buffer.next_char = cursor;\n");
+        P(F, "        return -1;\n");
+        P(F, "    }\n");
+        P(F, "    cursor = S->lexeme.end;\n");
+        P(F, "commit:\n");
+        P(F, "    S->buffer.next_char = cursor;\n");
+        P(F, "    S->lexeme.end = cursor;\n");
+    } else {
+        P(F, "    if(!seen_accepting_state) {\n");
+        P(F, "        return -1;\n");
+        P(F, "    }\n");
+        P(F, "    scanner_pushback(S, nc - pnc);\n");
+        P(F, "commit:\n");
+        P(F, "    scanner_mark_lexeme_end(S);\n");
+    }
+    for(i = 0; i < num_keywords; ++i) {
+        if(NFA_first_covered(keywords, i)) {
+            P(F, "    if(%d == term) {\n", keywords[i].covered_by);
+            P(
+                F,
+                "        term = scanner_keyword(S, &%s_keywords_%d, term);\n",
+                func_name,
+                keywords[i].covered_by
+            );
+            P(F, "    }\n");
+        }
+    }
+    P(F, "    return term;\n");
+    P(F, "}\n\n");
+    P(F, "#endif\n\n");
+
+    fclose(F);
+}
+
+/**
+ * Find the characters on which a DFA state transitions back to itself and put
+ * them into the bitmap of a PScannerRun, i.e. set bit (c >> 4) of
+ * low_nibbles[c & 15] for each such character c. Only characters from 1 to
+ * 127 are used: a 0 ends the input, and the printed switch statements compare
+ * against a char. Returns the number of characters found.
+ */
+static unsigned int NFA_self_loop_chars(const PNFA *nfa,
+                                        unsigned int state,
+                                        unsigned char *low_nibbles) {
+    NFA_Transition *trans = nfa->state_transitions[state];
+    unsigned int num_chars = 0;
+    int c;
+
+    memset(low_nibbles, 0, 16);
+
+    if(NFA_UNUSED_STATE == trans) {
+        return 0;
+    }
+
+    for(; is_not_null(trans); trans = trans->trans_next) {
+        c = trans->condition.value;
+        if(T_VALUE == trans->type && state == trans->to_state
+        && 0 < c && c < 128) {
+            low_nibbles[c & 15] |= (unsigned char) (1 << (c >> 4));
+            ++num_chars;
+        }
+    }
+
+    return num_chars;
+}
+
+/**
+ * Print out the PScannerRun for the characters that a state loops on.
+ */
+static void NFA_print_run(FILE *F,
+                          const char *func_name,
+                          unsigned int state,
+                          const unsigned char *low_nibbles) {
+    unsigned int ranges[NFA_MAX_RUN_RANGES][2],
+                 num_ranges = 0;
+    int c,
+        in,
+        was_in = 0;
+    const char *sep = "";
+
+    /* find the ranges of characters in the set; a set with too many of them
+     * is only described by its bitmap. */
+    for(c = 0; c <= 128; ++c) {
+        in = (c < 128) && ((low_nibbles[c & 15] >> (c >> 4)) & 1);
+        if(in && !was_in) {
+            if(num_ranges < NFA_MAX_RUN_RANGES) {
+                ranges[num_ranges][0] = (unsigned int) c;
+            }
+            ++num_ranges;
+        } else if(!in && was_in && num_ranges <= NFA_MAX_RUN_RANGES) {
+            ranges[num_ranges - 1][1] = (
+                (unsigned int) c - 1 - ranges[num_ranges - 1][0]
+            );
+        }
+        was_in = in;
+    }
+
+    if(num_ranges > NFA_MAX_RUN_RANGES) {
+        num_ranges = 0;
+    }
+
+    P(F, "static const PScannerRun %s_run_%u = {\n    {", func_name, state);
+    for(c = 0; c < 16; ++c) {
+        P(F, "%s%u", sep, low_nibbles[c]);
+        sep = ",";
+    }
+    P(F, "},\n    %u,\n    {", num_ranges);
+    sep = "";
+    for(c = 0; c < (int) num_ranges; ++c) {
+        P(F, "%s{%u,%u}", sep, ranges[c][0], ranges[c][1]);
+        sep = ",";
+    }
+    if(0 == num_ranges) {
+        P(F, "{0,0}");
+    }
+    P(F, "}\n};\n\n");
+}
+
+/**
+ * Print a NFA as a C scanner with a switch statement for each state into the
+ * file specified. States that loop on themselves skip over a run of the
+ * characters that they loop on all at once before looking at the next
+ * character.
+ */
+static void NFA_print_switch_scanner(const PNFA *nfa,
+                                     const char *out_file,
+                                     const char *func_name,
+                                     int cursor,
+                                     const NFA_Keyword *keywords,
+                                     unsigned int num_keywords) {
+    FILE *F;
+    PSet *astates;
+    NFA_Transition *trans,
+                   **transitions;
+    int i,
+        n;
+    char *has_run;
+    unsigned char low_nibbles[16];
+
+    assert_not_null(nfa);
+    assert_not_null(out_file);
+
+    F = NFA_print_scanner_head(out_file, func_name);
+    NFA_print_scanner_keywords(F, func_name, keywords, num_keywords);
+
+    astates = nfa->accepting_states;
+    transitions = nfa->state_transitions;
+
+    has_run = mem_calloc(nfa->num_states + 1, sizeof(char));
+    if(is_null(has_run)) {
+        mem_error("Internal NFA Error: Unable to allocate scanner runs.");
+    }
+
+    for(n = 0; n < (int) nfa->num_states; ++n) {
+        if(NFA_self_loop_chars(nfa, (unsigned int) n, low_nibbles) > 0) {
+            NFA_print_run(F, func_name, (unsigned int) n, low_nibbles);
+            has_run[n] = 1;
+        }
+    }
+
+    NFA_print_scanner_entry(F, func_name, cursor);
+    NFA_print_scanner_start(F, cursor);
 
     if(nfa->start_state > 0) {
         P(F, "    goto state_%d;\n", nfa->start_state);
@@ -1648,13 +2367,27 @@ void nfa_print_scanner(const PNFA *nfa,
             P(F, "    term = %d;\n", *(nfa->conclusions+n));
             P(F, "    goto commit;\n");
         } else {
+            if(has_run[n] && cursor) {
+                P(
+                    F,
+                    "    cursor = scanner_run_end(&%s_run_%d, cursor, "
+                    "limit);\n",
+                    func_name,
+                    n
+                );
+            } else if(has_run[n]) {
+                P(
+                    F,
+                    "    nc += (int) scanner_skip_run(S, &%s_run_%d);\n",
+                    func_name,
+                    n
+                );
+            }
             if(set_has_elm(astates, n)) {
                 P(F, "    term = %d;\n", *(nfa->conclusions+n));
-                P(F, "    pnc = nc;\n");
-                P(F, "    seen_accepting_state = 1;\n");
+                NFA_print_scanner_accept(F, "    ", cursor);
             }
-            P(F, "    if(!(cc = scanner_advance(S))) { goto undo_and_commit; }\n");
-            P(F, "    ++nc;\n");
+            NFA_print_scanner_read(F, "    ", cursor);
             P(F, "    switch(cc) {\n");
             for(; is_not_null(trans); trans = trans->trans_next) {
 
@@ -1677,18 +2410,331 @@ void nfa_print_scanner(const PNFA *nfa,
         }
     }
 
-    P(F, "undo_and_commit:\n");
-    P(F, "    if(!seen_accepting_state) {\n");
-    P(F, "        return -1;\n");
+    NFA_print_scanner_tail(F, func_name, cursor, keywords, num_keywords);
+
+    mem_free(has_run);
+
+    return;
+}
+
+/**
+ * Return the name of the smallest unsigned C type able to hold max_value.
+ */
+static const char *NFA_table_type(unsigned int max_value) {
+    if(max_value <= UCHAR_MAX) {
+        return "unsigned char";
+    } else if(max_value <= USHRT_MAX) {
+        return "unsigned short";
+    }
+    return "unsigned int";
+}
+
+/**
+ * Print out one of the scanner tables as a static array.
+ */
+static void NFA_print_table(FILE *F,
+                            const char *func_name,
+                            const char *table_name,
+                            const unsigned int *table,
+                            unsigned int length,
+                            unsigned int max_value) {
+    unsigned int i;
+
+    P(
+        F,
+        "static const %s %s_%s[%u] = {",
+        NFA_table_type(max_value),
+        func_name,
+        table_name,
+        length
+    );
+
+    for(i = 0; i < length; ++i) {
+        P(F, "%s%u", (0 == (i % 16)) ? "\n    " : "", table[i]);
+        if(i + 1 < length) {
+            P(F, ",");
+        }
+    }
+
+    P(F, "\n};\n\n");
+}
+
+/**
+ * Print a DFA as a table-driven C scanner into the file specified. Bytes are
+ * first mapped to their equivalence classes through a 'class' table, so that a
+ * state's row of outgoing transitions has one column per class rather than one
+ * per byte. The rows are then compressed using row displacement: every row is
+ * placed at some offset (its base) into a shared 'next' table such that it
+ * does not overlap any previously placed row, and a parallel 'check' table
+ * records which state owns each slot. Rows are placed densest-first, which
+ * packs the sparse rows into the holes left by the dense ones.
+ *
+ * The emitted scanner is a single loop over these tables rather than a switch
+ * statement per state, which keeps the code size of the scanner independent
+ * of the number of states and transitions in the DFA.
+ */
+static void NFA_print_table_scanner(const PNFA *nfa,
+                                    const char *out_file,
+                                    const char *func_name,
+                                    int cursor,
+                                    const NFA_Keyword *keywords,
+                                    unsigned int num_keywords) {
+    FILE *F;
+    NFA_Transition *trans,
+                   **transitions;
+
+    unsigned int num_states,
+                 state,
+                 count,
+                 base,
+                 max_base = 0,
+                 max_conclusion = 0,
+                 table_size,
+                 no_row,
+                 num_classes,
+                 i,
+                 j;
+
+    unsigned int *bases,
+                 *accepts,
+                 *next,
+                 *check,
+                 *counts,
+                 *order;
+
+    int row[NFA_NUM_BYTES];
+    unsigned char classes[NFA_NUM_BYTES];
+    unsigned int class_table[NFA_NUM_BYTES];
+
+    assert_not_null(nfa);
+    assert_not_null(out_file);
+
+    num_states = nfa->num_states;
+    transitions = nfa->state_transitions;
+    num_classes = DFA_byte_classes(nfa, classes);
+
+    /* a row can always be placed past the end of all previously placed rows,
+     * so this bounds the size of the table. */
+    table_size = (num_states + 1) * num_classes;
+
+    bases = mem_calloc(num_states, sizeof(unsigned int));
+    accepts = mem_calloc(num_states, sizeof(unsigned int));
+    counts = mem_calloc(num_states, sizeof(unsigned int));
+    order = mem_calloc(num_states, sizeof(unsigned int));
+    next = mem_calloc(table_size, sizeof(unsigned int));
+    check = mem_alloc(table_size * sizeof(unsigned int));
+
+    if(is_null(bases) || is_null(accepts) || is_null(counts)
+    || is_null(order) || is_null(next) || is_null(check)) {
+        mem_error("Internal NFA Error: Unable to allocate scanner tables.");
+    }
+
+    /* no state owns a slot until a row is placed over it */
+    for(i = 0; i < table_size; ++i) {
+        check[i] = num_states;
+    }
+
+    for(state = 0; state < num_states; ++state) {
+        trans = transitions[state];
+
+        if(set_has_elm(nfa->accepting_states, state)) {
+            accepts[state] = (unsigned int) nfa->conclusions[state] + 1;
+            if(accepts[state] > max_conclusion) {
+                max_conclusion = accepts[state];
+            }
+        }
+
+        if(NFA_UNUSED_STATE == trans) {
+            continue;
+        }
+
+        for(; is_not_null(trans); trans = trans->trans_next) {
+            if(trans->type != T_VALUE) {
+                std_error(
+                    "Internal NFA Print Error: Cannot print non-value "
+                    "transitions."
+                );
+            }
+            ++(counts[state]);
+        }
+    }
+
+    /* order the states by decreasing number of transitions */
+    for(i = 0, count = NFA_NUM_BYTES + 1; count--; ) {
+        for(state = 0; state < num_states; ++state) {
+            if(counts[state] == count) {
+                order[i++] = state;
+            }
+        }
+    }
+
+    for(i = 0; i < num_states; ++i) {
+        state = order[i];
+
+        if(0 == counts[state]) {
+            continue;
+        }
+
+        for(j = 0; j < num_classes; ++j) {
+            row[j] = -1;
+        }
+
+        for(trans = transitions[state];
+            is_not_null(trans);
+            trans = trans->trans_next) {
+            row[classes[trans->condition.value]] = (int) trans->to_state;
+        }
+
+        /* first fit: find the lowest base where the row fits into the holes
+         * of the table. */
+        for(base = 0; ; ++base) {
+            for(j = 0; j < num_classes; ++j) {
+                if(row[j] >= 0 && check[base + j] != num_states) {
+                    break;
+                }
+            }
+            if(num_classes == j) {
+                break;
+            }
+        }
+
+        for(j = 0; j < num_classes; ++j) {
+            if(row[j] >= 0) {
+                next[base + j] = (unsigned int) row[j];
+                check[base + j] = state;
+            }
+        }
+
+        bases[state] = base;
+        if(base > max_base) {
+            max_base = base;
+        }
+    }
+
+    /* accepting states without any transitions commit to their lexeme
+     * immediately; they are marked with a base that no other state uses. */
+    no_row = (max_base + 1 <= UCHAR_MAX) ? UCHAR_MAX : (
+        (max_base + 1 <= USHRT_MAX) ? USHRT_MAX : UINT_MAX
+    );
+
+    for(state = 0; state < num_states; ++state) {
+        if(0 == counts[state] && 0 != accepts[state]) {
+            bases[state] = no_row;
+        }
+    }
+
+    /* any class can be added to a base, so make sure that the last row can
+     * be indexed by all of them. */
+    table_size = max_base + num_classes;
+
+    for(i = 0; i < NFA_NUM_BYTES; ++i) {
+        class_table[i] = classes[i];
+    }
+
+    F = NFA_print_scanner_head(out_file, func_name);
+    NFA_print_scanner_keywords(F, func_name, keywords, num_keywords);
+
+    NFA_print_table(
+        F,
+        func_name,
+        "class",
+        class_table,
+        NFA_NUM_BYTES,
+        num_classes - 1
+    );
+    NFA_print_table(F, func_name, "accept", accepts, num_states, max_conclusion);
+    NFA_print_table(F, func_name, "base", bases, num_states, no_row);
+    NFA_print_table(F, func_name, "next", next, table_size, num_states);
+    NFA_print_table(F, func_name, "check", check, table_size, num_states);
+
+    NFA_print_scanner_entry(F, func_name, cursor);
+    P(F, "    unsigned int state = %u, row, accept;\n", nfa->start_state);
+    NFA_print_scanner_start(F, cursor);
+    P(F, "    for(;;) {\n");
+    P(F, "        row = %s_base[state];\n", func_name);
+    P(F, "        if(0 != (accept = %s_accept[state])) {\n", func_name);
+    P(F, "            term = (G_Terminal) (accept - 1);\n");
+    P(F, "            if(%uU == row) { goto commit; }\n", no_row);
+    NFA_print_scanner_accept(F, "            ", cursor);
+    P(F, "        }\n");
+    NFA_print_scanner_read(F, "        ", cursor);
+    P(F, "        row += %s_class[(unsigned char) cc];\n", func_name);
+    P(F, "        if(%s_check[row] != state) { goto undo_and_commit; }\n", func_name);
+    P(F, "        state = %s_next[row];\n", func_name);
     P(F, "    }\n");
-    P(F, "    scanner_pushback(S, nc - pnc);\n");
-    P(F, "commit:\n");
-    P(F, "    scanner_mark_lexeme_end(S);\n");
-    P(F, "    return term;\n");
-    P(F, "}\n\n");
-    P(F, "#endif\n\n");
 
-    fclose(F);
+    NFA_print_scanner_tail(F, func_name, cursor, keywords, num_keywords);
+
+    mem_free(bases);
+    mem_free(accepts);
+    mem_free(counts);
+    mem_free(order);
+    mem_free(next);
+    mem_free(check);
 
     return;
 }
+
+/**
+ * Print a DFA as a C scanner into the file specified. The options are a
+ * combination of the NFA_SCANNER_* flags, which choose how the scanner is
+ * printed. Lexemes of a terminal that covers any of the keywords are looked
+ * up in a perfect hash table of those keywords once they have been matched.
+ */
+void nfa_print_scanner_options(const PNFA *nfa,
+                               const char *out_file,
+                               const char *func_name,
+                               unsigned int options,
+                               const NFA_Keyword *keywords,
+                               unsigned int num_keywords) {
+    int cursor = (0 != (options & NFA_SCANNER_CURSOR));
+
+    assert_not_null(nfa);
+    assert_not_null(out_file);
+
+    if(options & NFA_SCANNER_TABLES) {
+        NFA_print_table_scanner(
+            nfa,
+            out_file,
+            func_name,
+            cursor,
+            keywords,
+            num_keywords
+        );
+    } else {
+        NFA_print_switch_scanner(
+            nfa,
+            out_file,
+            func_name,
+            cursor,
+            keywords,
+            num_keywords
+        );
+    }
+}
+
+/**
+ * Print a DFA as a C scanner with a switch statement for each state into the
+ * file specified.
+ */
+void nfa_print_scanner(const PNFA *nfa,
+                       const char *out_file,
+                       const char *func_name) {
+    nfa_print_scanner_options(nfa, out_file, func_name, 0, NULL, 0);
+}
+
+/**
+ * Print a DFA as a table-driven C scanner into the file specified.
+ */
+void nfa_print_table_scanner(const PNFA *nfa,
+                             const char *out_file,
+                             const char *func_name) {
+    nfa_print_scanner_options(
+        nfa,
+        out_file,
+        func_name,
+        NFA_SCANNER_TABLES,
+        NULL,
+        0
+    );
+}
@@ -12,9 +12,9 @@
 
 static unsigned long int num_allocations = 0;
 
-#define tree_mem_alloc(x) mem_alloc(x); ++num_allocations
-#define tree_mem_calloc(x,y) mem_calloc(x,y); ++num_allocations
-#define tree_mem_free(x) mem_free(x); --num_allocations
+#define tree_mem_alloc(x) mem_alloc(x); mem_count_alloc(num_allocations)
+#define tree_mem_calloc(x,y) mem_calloc(x,y); mem_count_alloc(num_allocations)
+#define tree_mem_free(x) mem_free(x); mem_count_free(num_allocations)
 #define tree_mem_error(x) mem_error(x)
 
 unsigned long int tree_num_allocated_pointers(void) {
@@ -93,7 +93,7 @@ static void T_add_branch(PTree *parent, PTree *branch, int force) {
  * structure which *must* contain a PTree as its first field, and the degree
  * is the number of branches that this tree should have.
  */
-void *tree_alloc(const size_t struct_size, const unsigned short degree) {
+void *tree_alloc(const size_t struct_size, const uint32_t degree) {
     PTree *T = NULL;
 
     assert(sizeof(PTree) <= struct_size);
@@ -159,7 +159,7 @@ void delegate_tree_free(PTree *T) {
 /**
  * Return the number of branches allocated for this tree.
  */
-unsigned short tree_get_num_slots(PTree *T) {
+uint32_t tree_get_num_slots(PTree *T) {
     assert_not_null(T);
     return T->_degree;
 }
@@ -167,7 +167,7 @@ unsigned short tree_get_num_slots(PTree *T) {
 /**
  * Return the number of allocated branches that have been filled.
  */
-unsigned short tree_get_num_branches(PTree *T) {
+uint32_t tree_get_num_branches(PTree *T) {
     assert_not_null(T);
     return T->_fill;
 }
@@ -185,7 +185,7 @@ void tree_clear(PTree *tree) {
 /**
  * Clear a certain number of branches from a tree.
  */
-void tree_clear_num(PTree *tree, unsigned short num_branches) {
+void tree_clear_num(PTree *tree, uint32_t num_branches) {
     assert_not_null(tree);
     assert(tree->_fill >= num_branches);
     tree->_fill -= num_branches;
@@ -196,7 +196,7 @@ void tree_clear_num(PTree *tree, unsigned short num_branches) {
  */
 void tree_trim(PTree *T, PDictionary *garbage_set) {
     PTree *branch = NULL;
-    unsigned short i;
+    uint32_t i;
 
     assert_not_null(T);
     assert_not_null(garbage_set);
@@ -231,8 +231,8 @@ void tree_force_add_branch(PTree *parent, PTree *branch) {
 }
 
 void tree_force_add_branch_children(PTree *parent, PTree *branch) {
-    unsigned short i = 0,
-                   fill;
+    uint32_t i = 0,
+             fill;
 
     assert_not_null(parent);
     assert_not_null(branch);
@@ -274,7 +274,7 @@ static void *T_generator_next_df(PTreeGenerator *G) {
     PStack *S = NULL;
     PTree *curr = NULL;
     void *ret = NULL;
-    unsigned short i;
+    uint32_t i;
 
     assert_not_null(G);
 
@@ -306,7 +306,7 @@ static void *T_generator_next_bf(PTreeGenerator *G) {
     PQueue *Q = NULL;
     PTree *curr = NULL;
     void *ret = NULL;
-    unsigned short i;
+    uint32_t i;
 
     assert_not_null(G);
 
@@ -337,7 +337,7 @@ static void *T_generator_next_po(PTreeGenerator *G) {
     PStack *S = NULL;
     PTree *curr = NULL, *top = NULL;
     void *ret = NULL;
-    unsigned short i;
+    uint32_t i;
 
     assert_not_null(G);
 
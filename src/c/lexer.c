@@ -5,7 +5,7 @@ G_Terminal lang_lexer(PScanner *S) {
     G_Terminal term = -1;
     unsigned int seen_accepting_state = 0;
     int cc, nc = 0, pnc = 0;
-    scanner_skip(S, &isspace);
+    scanner_skip_space(S);
     scanner_mark_lexeme_start(S);
 state_0:
     if(!(cc = scanner_advance(S))) { goto undo_and_commit; }
@@ -6,12 +6,14 @@ number : '[0-9]+(\.[0-9]+)?' ;
 bool_true : "true" ;
 bool_false : "false" ;
 
+%sync "def" "type" ;
+
 Program 
-    : ^(-FuncDef Self | -TypeDef Self | <>)
+    : ^(-FuncDef | -TypeDef)*
     ;
 
     TypeDef
-        : "type" -type ":" -(-TypeList "," ^Self | -TypeList) "."
+        : "type" -type ":" -(-TypeList ^("," -TypeList)*) "."
         ;
         
         TypeList
@@ -23,11 +25,11 @@ Program
         ;
 
         FuncParams
-            : -FuncParamList ^(";" ^FuncParams | <>)
+            : -FuncParamList ^(";" -FuncParamList)*
             ;
         
         FuncParamList
-            : -type ^(-id "," ^Self | -id)
+            : -type -id ^("," -id)*
             ;
    
 Stmt
@@ -40,12 +42,11 @@ Stmt
     ;
 
     StmtList
-        : -Stmt "," ^StmtList 
-        | -Stmt "."
+        : -Stmt ("," -Stmt)* "."
         ;
     
     WithStmt
-        : -id "{" ^("bind" -BindStmt ^Self | "bind" -BindStmt) "}"
+        : -id "{" ^("bind" -BindStmt)+ "}"
         ;
         
         BindStmt
@@ -59,7 +60,7 @@ Stmt
                 ;
             
             DestructureStmt
-                : -type "(" ^(^DestructureBind ^Self | ^DestructureBind) ")"
+                : -type "(" ^(^DestructureBind)+ ")"
                 ;
     
     ReturnStmt
@@ -79,5 +80,5 @@ Stmt
         | number
         | bool_true
         | bool_false
-        | "(" id ^(-Expr ^Self | <>) ")"
+        | "(" id ^(-Expr)* ")"
         ;
@@ -8,12 +8,13 @@ cut : "!" ;
 fail : "><" ;
 non_excludable : "-" ;
 raise_children : "^" ;
+kleene_closure : "*" ;
+positive_closure : "+" ;
+optional : "?" ;
 self : "Self" ;
 
 GrammarRules
-    : -Production ^GrammarRules
-    | -Terminal ^GrammarRules
-    | <>
+    : ^(-Production | -Terminal | -SyncTerminals)*
     ;
 
 Production
@@ -24,21 +25,28 @@ Terminal
     : -terminal ":" ^(-regexp | -string) ";"
     ;
 
+SyncTerminals
+    : "%sync" ^SyncTerminal+ ";"
+    ;
+
+SyncTerminal
+    : -terminal
+    | -string
+    ;
+
 ProductionRules
-    : -Rules "|" ^ProductionRules
-    | -Rules
+    : -Rules ^("|" -Rules)*
     ;
 
 Rules
-    : ^Rule ^Rules
-    | ^Rule
+    : ^Rule+
     ;
 
 Rule
     : -fail
     | -cut
-    | ^RuleFlag "(" -ProductionRules ")"
-    | ^RuleFlag ^(-self | -non_terminal | -regexp | -string | -terminal | -epsilon)
+    | ^RuleFlag "(" -ProductionRules ")" ^Repetition
+    | ^RuleFlag ^(-self | -non_terminal | -regexp | -string | -terminal | -epsilon) ^Repetition
     ;
 
 RuleFlag
@@ -46,3 +54,10 @@ RuleFlag
     | -raise_children
     | <>
     ;
+
+Repetition
+    : -kleene_closure
+    | -positive_closure
+    | -optional
+    | <>
+    ;
@@ -21,6 +21,14 @@
 #define NFA_MAX_KNOWN_UNUSED_STATES 64
 #define NFA_NUM_DEFAULT_TRANSITIONS 256
 
+/* options for nfa_print_scanner_options. NFA_SCANNER_TABLES prints a scanner
+ * that runs off of compressed transition tables instead of one with a switch
+ * statement for each state. NFA_SCANNER_CURSOR prints a scanner that reads the
+ * scanner's buffer through its own cursor instead of calling scanner_advance
+ * for every character. */
+#define NFA_SCANNER_TABLES 1
+#define NFA_SCANNER_CURSOR 2
+
 typedef enum {
     T_VALUE,
     T_SET,
@@ -72,6 +80,15 @@ typedef struct PNFA {
     PVector *state_subsets;
 } PNFA;
 
+/* a string that a scanner matches as the terminal 'covered_by', e.g. an
+ * identifier, and then reclassifies as the terminal 'conclusion'. */
+typedef struct NFA_Keyword {
+    unsigned char *text;
+    unsigned int length;
+    int covered_by,
+        conclusion;
+} NFA_Keyword;
+
 PNFA *nfa_alloc(void);
 
 void nfa_free(PNFA *nfa);
@@ -103,6 +120,12 @@ void nfa_add_set_transition(PNFA *nfa,
                             unsigned int end_state,
                             PSet *test_set);
 
+int nfa_match(const PNFA *dfa, const unsigned char *text, unsigned int length);
+
+int nfa_only_string(const PNFA *dfa,
+                    unsigned char *text,
+                    unsigned int max_length);
+
 /* -------------------------------------------------------------------------- */
 
 void nfa_print_dot(PNFA *nfa);
@@ -114,6 +137,17 @@ void nfa_print_scanner(const PNFA *nfa,
                        const char *out_file,
                        const char *func_name);
 
+void nfa_print_table_scanner(const PNFA *nfa,
+                             const char *out_file,
+                             const char *func_name);
+
+void nfa_print_scanner_options(const PNFA *nfa,
+                               const char *out_file,
+                               const char *func_name,
+                               unsigned int options,
+                               const NFA_Keyword *keywords,
+                               unsigned int num_keywords);
+
 int nfa_label_states(int set, int val);
 
 #endif /* ADTDFA_H_ */
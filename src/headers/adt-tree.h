@@ -21,8 +21,8 @@
  * Threaded tree type.
  */
 typedef struct PTree {
-	unsigned short _degree, /* number of allocated branches */
-                   _fill; /* number of branches with children */
+	uint32_t _degree, /* number of allocated branches */
+             _fill; /* number of branches with children */
 
 	struct PTree **_branches; /* array of branches */
 } PTree;
@@ -43,17 +43,17 @@ typedef enum {
 } PTreeTraversalType;
 
 /* tree operations */
-void *tree_alloc(const size_t, const unsigned short );
+void *tree_alloc(const size_t, const uint32_t );
 void tree_free(PTree *, PDelegate);
 void delegate_tree_free(PTree * );
 void tree_clear(PTree *tree);
-void tree_clear_num(PTree *tree, unsigned short num_branches);
+void tree_clear_num(PTree *tree, uint32_t num_branches);
 void tree_trim(PTree *, PDictionary *);
 void tree_add_branch(PTree *, PTree *);
 void tree_force_add_branch(PTree *, PTree *);
 void tree_force_add_branch_children(PTree *, PTree *);
-unsigned short tree_get_num_slots(PTree * );
-unsigned short tree_get_num_branches(PTree * );
+uint32_t tree_get_num_slots(PTree * );
+uint32_t tree_get_num_branches(PTree * );
 void *tree_parent(PTree *);
 
 /* tree generator */
@@ -10,6 +10,7 @@
 #define PPRODCOMMON_H_
 
 #include "adt-tree.h"
+#include "std-arena.h"
 
 /* -------------------------------------------------------------------------- */
 
@@ -37,6 +38,13 @@ typedef enum {
 typedef struct PParseTree {
     PTree _;
     PT_Type type;
+
+    /* used to find garbage trees, see PT_Heap */
+    unsigned int is_marked:1,
+                 is_retained:1,
+                 is_tenured:1;
+
+    struct PParseTree *next_unretained;
 } PParseTree;
 
 /* epsilon tree */
@@ -54,7 +62,9 @@ typedef struct PT_NonTerminal {
 
 } PT_NonTerminal;
 
-/* a parse tree representing a terminal symbol, i.e. a token */
+/* a parse tree representing a terminal symbol, i.e. a token. the lexeme's
+ * characters might refer directly to the scanner's input, in which case the
+ * lexeme is only copied into a string when PT_get_lexeme asks for it. */
 typedef struct PT_Terminal {
     PParseTree _;
 
@@ -62,16 +72,40 @@ typedef struct PT_Terminal {
 
     PString *lexeme;
 
+    const char *text;
+    uint32_t text_length;
+
+    /* the heap that the lexeme is copied into */
+    struct PT_Heap *heap;
+
     uint32_t line,
              column;
 
     uint32_t id;
 
-    struct PT_Terminal *next;
+    /* the token that the tree was made from. for an incremental parse this is
+     * the token's handle, which stays the same when an edit moves the token,
+     * and the token's id and position are brought up to date from it before
+     * the grammar actions see the tree. */
+    uint32_t token;
 } PT_Terminal;
 
-/* a set of parse trees */
-typedef PDictionary PT_Set;
+/* The parse trees made during a parse. Trees are allocated from an arena and
+ * freed all at once along with it. Trees that are not yet known to be part of
+ * the final parse tree are kept on the unretained list so that the garbage
+ * among them can be swept.
+ *
+ * The trees of an incremental parse that outlive a sweep are tenured: they are
+ * moved onto their own list and are neither marked nor swept again until they
+ * are untenured for a full collection. Tenured trees never point to newer
+ * trees, so a sweep after a reparse only has to look at the trees that it
+ * made. */
+typedef struct PT_Heap {
+    PArena *arena;
+    PParseTree *unretained,
+               *tenured;
+    uint32_t num_tenured;
+} PT_Heap;
 
 /* -------------------------------------------------------------------------- */
 
@@ -92,18 +126,32 @@ typedef struct G_Symbol {
                  is_non_excludable:1,
                  children_must_be_raised:1,
                  is_fail:1,
-                 is_cut:1;
+                 is_cut:1,
+                 is_repeated:1,
+                 is_optional:1;
 } G_Symbol;
 
+/* FIRST sets are bitsets of terminals, indexed by terminal. Phrases can only be
+ * skipped by looking at their FIRST sets if they are predictable, i.e. there is
+ * no cut before the first symbol that must match a token. */
 typedef struct G_Phrase {
     G_Symbol *symbols;
     unsigned int num_symbols;
+
+    uint32_t *first_set;
+    unsigned int is_nullable:1,
+                 is_predictable:1;
 } G_Phrase;
 
 typedef struct G_ProductionRule {
     G_Phrase *phrases;
     G_NonTerminal production;
     unsigned int num_phrases;
+
+    uint32_t *first_set;
+    unsigned int is_nullable:1,
+                 is_left_recursive:1,
+                 is_memoized:1;
 } G_ProductionRule;
 
 typedef enum {
@@ -12,6 +12,36 @@
 #include "p-types.h"
 #include "p-parser.h"
 
+/* whether or not 'terminal' is in a FIRST set of the grammar */
+#define G_FIRST_SET_HAS(grammar, set, terminal) ( \
+    (terminal) >= 0 \
+    && (terminal) < (grammar)->num_first_terminals \
+    && ((set)[(terminal) >> 5] & (((uint32_t) 1) << ((terminal) & 31))) \
+)
+
+/* whether or not a production rule might match the tokens starting at a token
+ * with terminal 'terminal' */
+#define G_production_rule_can_start(grammar, rule, terminal) ( \
+    (rule)->is_nullable \
+    || G_FIRST_SET_HAS(grammar, (rule)->first_set, terminal) \
+)
+
+/* whether or not a phrase might match the tokens starting at a token with
+ * terminal 'terminal' */
+#define G_phrase_can_start(grammar, phrase, terminal) ( \
+    !(phrase)->is_predictable \
+    || (phrase)->is_nullable \
+    || G_FIRST_SET_HAS(grammar, (phrase)->first_set, terminal) \
+)
+
+/* whether or not 'terminal' is a synchronization terminal of the grammar */
+#define G_is_sync_terminal(grammar, terminal) ( \
+    (terminal) >= 0 \
+    && (terminal) < ((grammar)->sync_set_size * 32) \
+    && ((grammar)->sync_terminals[(terminal) >> 5] \
+        & (((uint32_t) 1) << ((terminal) & 31))) \
+)
+
 void G_lock(PGrammar *grammar);
 
 void G_unlock(PGrammar *grammar);
@@ -39,6 +39,8 @@ void grammar_add_fail_symbol(PGrammar *grammar);
 
 void grammar_add_epsilon_symbol(PGrammar *grammar, G_TreeOp tree_op);
 
+void grammar_repeat_symbol(PGrammar *grammar, G_Repetition repetition);
+
 short grammar_get_num_production_rules(PGrammar *grammar);
 
 void grammar_null_action(void *s, unsigned char r, unsigned int n, PParseTree *c[]);
@@ -49,4 +51,8 @@ void grammar_add_tree_actions(PGrammar *grammar,
 
 void grammar_add_state_action(PGrammar *grammar, PDelegate *action_fnc);
 
+void grammar_add_sync_terminal(PGrammar *grammar, G_Terminal terminal);
+
+void grammar_freeze(PGrammar *grammar);
+
 #endif /* P_GRAMMAR_H_ */
@@ -13,20 +13,30 @@
 #include "p-types.h"
 #include "p-scanner.h"
 
-PT_Terminal *PT_alloc_terminal(G_Terminal terminal,
-                               PString *lexeme,
+PT_Terminal *PT_alloc_terminal(PT_Heap *heap,
+                               G_Terminal terminal,
+                               const char *lexeme,
+                               uint32_t lexeme_length,
+                               int is_lasting,
                                uint32_t line,
                                uint32_t column,
                                uint32_t id);
 
-PT_NonTerminal *PT_alloc_non_terminal(G_NonTerminal production,
-                                      unsigned short num_branches);
+PString *PT_get_lexeme(PT_Terminal *tree);
 
-PT_Epsilon *PT_alloc_epsilon(void);
+PT_NonTerminal *PT_alloc_non_terminal(PT_Heap *heap,
+                                      G_NonTerminal production,
+                                      uint32_t num_branches);
 
-/* -------------------------------------------------------------------------- */
+PT_Epsilon *PT_alloc_epsilon(PT_Heap *heap);
+
+void PT_add_branch(PT_Heap *heap, PParseTree *parent, PParseTree *branch);
 
-void parse_tree_free(PParseTree *parse_tree);
+void PT_add_branch_children(PT_Heap *heap,
+                            PParseTree *parent,
+                            PParseTree *tree);
+
+/* -------------------------------------------------------------------------- */
 
 void parse_tree_print_dot(PParseTree *parse_tree,
                           char production_names[][40],
@@ -34,14 +44,16 @@ void parse_tree_print_dot(PParseTree *parse_tree,
 
 /* -------------------------------------------------------------------------- */
 
-PT_Set *PTS_alloc(void);
+void PTH_init(PT_Heap *heap, PArena *arena);
+
+void PTH_retain(PT_Heap *heap, PParseTree *tree);
 
-void PTS_free(PT_Set *set);
+void PTH_mark(PT_Heap *heap, PParseTree *tree);
 
-void PTS_add(PT_Set *set, PParseTree *tree);
+void PTH_sweep(PT_Heap *heap);
 
-void PTS_remove(PT_Set *set, PParseTree *tree);
+void PTH_tenure(PT_Heap *heap);
 
-uint32_t PTS_size(PT_Set *set);
+void PTH_untenure(PT_Heap *heap);
 
 #endif /* PTREE_H_ */
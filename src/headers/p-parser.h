@@ -26,9 +26,93 @@
 
 #include "p-parse-tree.h"
 
-void parse_tokens(PGrammar *grammar,
-                  PScanner *scanner,
-                  PScannerFunc *scanner_fnc,
-                  void *state);
+PParser *parser_alloc(void);
+
+void parser_free(PParser *parser);
+
+void parser_tune_memoization(PParser *parser, PGrammar *grammar);
+
+void parser_enable_profiling(PParser *parser);
+
+void parser_print_profile(PParser *parser,
+                          char production_names[][40],
+                          int as_json);
+
+int parser_parse_tokens(PParser *parser,
+                        PGrammar *grammar,
+                        PScanner *scanner,
+                        PScannerFunc *scanner_fnc,
+                        void *state);
+
+int parse_tokens(PGrammar *grammar,
+                 PScanner *scanner,
+                 PScannerFunc *scanner_fnc,
+                 void *state);
+
+int parser_parse_tokens_parallel(PParser *parser,
+                                 PGrammar *grammar,
+                                 PScanner *scanner,
+                                 PScannerFunc *scanner_fnc,
+                                 void *state,
+                                 unsigned int num_workers);
+
+unsigned int parse_files(PGrammar *grammar,
+                         PScannerFunc *scanner_fnc,
+                         const char *file_names[],
+                         void *states[],
+                         P_FileResult results[],
+                         unsigned int num_files,
+                         unsigned int num_workers);
+
+int parser_parse_text(PParser *parser,
+                      PGrammar *grammar,
+                      PScannerFunc *scanner_fnc,
+                      const unsigned char *text,
+                      uint32_t length,
+                      void *state);
+
+int parser_reparse_text(PParser *parser,
+                        uint32_t start,
+                        uint32_t end,
+                        const unsigned char *text,
+                        uint32_t length,
+                        void *state);
+
+int parser_parse_tokens_direct(PParser *parser,
+                               PGrammar *grammar,
+                               PDirectParserFunc *start_fnc,
+                               PScanner *scanner,
+                               PScannerFunc *scanner_fnc,
+                               void *state);
+
+/* -------------------------------------------------------------------------- */
+
+/* the terminal of the current token of a direct-coded parser */
+#define PD_TERMINAL(parser) \
+    ((parser)->tokens.terminals[(parser)->token - (parser)->tokens.first_id])
+
+/* used by the direct-coded parsers that pgen generates */
+
+int PD_enter(PParser *parser, P_DirectFrame *frame, G_NonTerminal production);
+
+void PD_phrase(PParser *parser, P_DirectFrame *frame, unsigned char phrase);
+
+void PD_match(PParser *parser, P_DirectFrame *frame, G_TreeOp tree_op);
+
+void PD_epsilon(PParser *parser, P_DirectFrame *frame, G_TreeOp tree_op);
+
+int PD_non_terminal(PParser *parser,
+                    P_DirectFrame *frame,
+                    PParseTree *parse_tree,
+                    G_TreeOp tree_op);
+
+int PD_repeat(PParser *parser,
+              P_DirectFrame *frame,
+              PParseTree *parse_tree,
+              G_TreeOp tree_op);
+
+int PD_succeed(PParser *parser, P_DirectFrame *frame);
+
+PParseTree *PD_fail(PParser *parser, P_DirectFrame *frame);
 
 #endif /* PPARSER_H_ */
@@ -19,14 +19,16 @@
 #include "adt-set.h"
 #include "adt-nfa.h"
 
-unsigned int regexp_parse(PGrammar *grammar,
+unsigned int regexp_parse(PParser *parser,
+                          PGrammar *grammar,
                           PScanner *scanner,
                           PNFA *nfa,
                           unsigned char *regexp,
                           unsigned int start_state,
                           G_Terminal terminal);
 
-unsigned int regexp_parse_cat(PGrammar *grammar,
+unsigned int regexp_parse_cat(PParser *parser,
+                              PGrammar *grammar,
                               PScanner *scanner,
                               PNFA *nfa,
                               unsigned char *regexp,
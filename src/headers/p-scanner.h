@@ -24,8 +24,14 @@ void scanner_free(PScanner *scanner);
 
 int scanner_use_file(PScanner *scanner, const char *file_name);
 
+int scanner_use_mmap(PScanner *scanner, const char *file_name);
+
 int scanner_use_string(PScanner *scanner, unsigned char *string);
 
+int scanner_use_text(PScanner *scanner,
+                     const unsigned char *text,
+                     uint32_t length);
+
 int scanner_flush(PScanner *scanner, int force_flush);
 
 char scanner_advance(PScanner *scanner);
@@ -36,10 +42,35 @@ int scanner_pushback(PScanner *scanner, int n);
 
 void scanner_skip(PScanner *scanner, PScannerSkipFunc *predicate);
 
+void scanner_skip_space(PScanner *scanner);
+
+uint32_t scanner_skip_run(PScanner *scanner, const PScannerRun *run);
+
+unsigned char *scanner_refill(PScanner *scanner,
+                              unsigned char *cursor,
+                              unsigned char **limit);
+
+unsigned char *scanner_run_end(const PScannerRun *run,
+                               unsigned char *cursor,
+                               unsigned char *limit);
+
+G_Terminal scanner_keyword(PScanner *scanner,
+                           const PScannerKeywords *keywords,
+                           G_Terminal terminal);
+
 unsigned char *scanner_mark_lexeme_start(PScanner *scanner);
 
 void scanner_mark_lexeme_end(PScanner *scanner);
 
 PString *scanner_get_lexeme(PScanner *scanner);
 
+uint32_t scanner_get_lexeme_offset(PScanner *scanner);
+
+void scanner_get_position(PScanner *scanner,
+                          uint32_t offset,
+                          uint32_t *line,
+                          uint32_t *column);
+
+const unsigned char *scanner_get_lexeme_text(PScanner *scanner);
+
 #endif /* PSCANNER_H_ */
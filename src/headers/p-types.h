@@ -30,8 +30,11 @@ typedef struct PToken {
  * machine that matches lexemes and returns tokens. */
 typedef struct PScanner {
 
+    /* the characters being scanned. these are read from a file into 'data',
+     * but characters that are already in memory are scanned in place. */
     struct {
-        unsigned char start[S_INPUT_BUFFER_SIZE],
+        unsigned char data[S_INPUT_BUFFER_SIZE],
+                      *start,
                       *end,
                       *next_char,
                       *flush_point;
@@ -42,24 +45,84 @@ typedef struct PScanner {
         unsigned char *start,
                       *end;
 
-        uint32_t line,
-                 column;
-
         PString *as_string;
     } lexeme;
 
     struct {
         int file_descriptor;
         char eof_read;
+
+        /* the position of the input's first character */
         uint32_t line,
                  column;
+
+        /* the offsets of the input's newlines, in order, as far as the input
+         * has been indexed. lines and columns are found from these. */
+        uint32_t *newlines,
+                 num_newlines,
+                 newlines_capacity,
+                 num_indexed;
+
+        /* text in memory that is scanned in place instead of a file */
+        const unsigned char *text;
+
+        /* the number of characters put into the buffer so far */
+        uint32_t num_read;
+
+        /* a file mapped into memory, and the length of the mapping */
+        unsigned char *map;
+        size_t map_length;
     } input;
 
+    /* state that a scanner function keeps between tokens, e.g. whether or not
+     * it is inside of a character class. it is cleared whenever the scanner
+     * is given new input. */
+    unsigned int lexer_state;
+
 } PScanner;
 
 typedef G_Terminal (PScannerFunc)(PScanner *scanner);
 typedef int (PScannerSkipFunc)(int);
 
+#define S_MAX_RUN_RANGES 8
+
+/* a set of characters below 128 that a scanner function can skip over a whole
+ * run of at once, e.g. the characters that an identifier's state loops on.
+ * character c is in the set if bit (c >> 4) of low_nibbles[c & 15] is set.
+ * where the set is made up of at most S_MAX_RUN_RANGES ranges of characters,
+ * each range [first, first + span] is also listed in 'ranges'; otherwise
+ * num_ranges is 0. */
+typedef struct PScannerRun {
+    unsigned char low_nibbles[16],
+                  num_ranges,
+                  ranges[S_MAX_RUN_RANGES][2];
+} PScannerRun;
+
+/* one step of the hash used to look up keywords: a round of FNV-1a. A hash
+ * starts at S_KEYWORD_BASIS xor a seed. */
+#define S_KEYWORD_BASIS 2166136261U
+#define S_KEYWORD_HASH(h, c) \
+    ((uint32_t) ((((uint32_t) (h)) ^ ((uint32_t) (c))) * 16777619U))
+
+/* a keyword that a scanner function matches as some other terminal, e.g. an
+ * identifier, and then reclassifies as the keyword's own terminal. */
+typedef struct PScannerKeyword {
+    const char *text;
+    uint32_t length;
+    G_Terminal terminal;
+} PScannerKeyword;
+
+/* a perfect hash table of keywords. A lexeme is hashed with a seed of 0 to
+ * find its bucket, and then with the bucket's seed to find the only slot that
+ * it can be in. Every slot holds a keyword. */
+typedef struct PScannerKeywords {
+    uint32_t num_buckets,
+             num_slots,
+             max_length;
+    const uint32_t *seeds;
+    const PScannerKeyword *slots;
+} PScannerKeywords;
+
 /* -------------------------------------------------------------------------- */
 
 typedef enum {
@@ -68,11 +131,22 @@ typedef enum {
     G_RAISE_CHILDREN
 } G_TreeOp;
 
+/* how many times a symbol can be matched in a row: any number of times, at
+ * least once, or at most once. */
+typedef enum {
+    G_ZERO_OR_MORE,
+    G_ONE_OR_MORE,
+    G_ZERO_OR_ONE
+} G_Repetition;
+
 /* base parse types, holds our rewrite rules. */
 typedef struct PGrammar {
 
-    /* on for when we no longer allow rules to be added. */
-    unsigned int is_locked:1;
+    /* on for when we no longer allow rules to be added. a frozen grammar is
+     * locked for good and is never written to again, so any number of threads
+     * can parse with it at once. */
+    unsigned int is_locked:1,
+                 is_frozen:1;
 
     /* keep track of all of the productions for the parsing grammar. */
     G_ProductionRule *production_rules;
@@ -91,6 +165,18 @@ typedef struct PGrammar {
 
     G_ActionRules *actions;
 
+    /* storage for the FIRST sets of all production rules and phrases. they,
+     * along with which production rules are memoized by default, are computed
+     * when the grammar is first locked. */
+    uint32_t *first_sets;
+    unsigned short first_set_size,
+                   num_first_terminals;
+
+    /* the set of terminals that only ever start a new top-level unit of the
+     * start production. a parallel parse splits the tokens at them. */
+    uint32_t *sync_terminals;
+    unsigned short sync_set_size;
+
 } PGrammar;
 
 /* -------------------------------------------------------------------------- */
@@ -107,15 +193,27 @@ typedef struct PGrammar {
  */
 typedef struct P_IntermediateResult {
 
-    PT_Terminal *end_token;
+    uint32_t end_token;
+
+    /* the id of the farthest token that was looked at to get this result */
+    uint32_t farthest_token;
 
     PParseTree *intermediate_tree;
 
     unsigned int uses_indirect_left_recursion:1,
-                 is_being_retested:1;
+                 is_being_retested:1,
+                 is_orphaned:1,
+                 is_recorded:1;
 
 } P_IntermediateResult;
 
+/* where an intermediate result is in the cache table: the id of the token that
+ * it was cached for and its production. */
+typedef struct P_ResultKey {
+    uint32_t id;
+    G_NonTerminal production;
+} P_ResultKey;
+
 /* -------------------------------------------------------------------------- */
 
 /**
@@ -143,7 +241,7 @@ typedef struct P_IntermediateResult {
  *       to match. If the alternative_rules list is null and the 'do_backtrack'
  *       flag is set then it implies that all of the rules for the current
  *       production have failed to match the tokens.
- *    d) the backtrack_point points to where in the token list the parser was
+ *    d) the backtrack_point is the id of the token where the parser was
  *       when it attempted to start matching this production. This is the point
  *       where it will return to on failure in order to try matching another
  *       rule.
@@ -153,10 +251,13 @@ typedef struct P_IntermediateResult {
  *       full failure of the production, cascade the failure to the
  *       calling production.
  *    f) the parse tree as it is being constructed.
- *    g) the calling stack frame. This is used for two reasons, it lets us
- *       manually manage the call stack without the overhead of the generic
- *       stack data structure and it also lets us reclaim stack frames for
- *       future use.
+ *    g) the calling stack frame, which is the frame just below it on the
+ *       parser's stack. Frames are stored by value in a single array that
+ *       grows as needed, so pushing and popping frames doesn't allocate and
+ *       nearby frames share cache lines.
+ *    h) the cached result of applying the frame's production at its
+ *       backtrack_point. The frame holds onto this directly as the result
+ *       might have been evicted from the cache table.
  */
 typedef struct P_Frame {
 
@@ -182,35 +283,223 @@ typedef struct P_Frame {
         unsigned char seed_phrase;
     } left_recursion;
 
+    /* the repeated or optional non-terminal being matched, if any, the token
+     * where the latest attempt at matching it started, and whether or not it
+     * has been matched at least once. */
+    struct {
+        G_Symbol *symbol;
+        uint32_t token;
+        unsigned int has_matched:1;
+    } repetition;
+
     /* deal with backtracking */
-    PT_Terminal *backtrack_point;
+    uint32_t backtrack_point;
+
+    /* the id of the farthest token that this frame, or any frame or cached
+     * result that it used, has looked at. */
+    uint32_t farthest_token;
 
     PParseTree *parse_tree;
 
+    P_IntermediateResult *result;
+
 } P_Frame;
 
+/**
+ * A stack frame of a direct-coded parser, as generated by pgen. Direct-coded
+ * parsers have a C function for each production and so use the C stack; these
+ * frames only hold what is needed to backtrack to another phrase, to stop
+ * repeating a symbol, and to cache the result of the production.
+ */
+typedef struct P_DirectFrame {
+
+    uint32_t backtrack_point,
+             repeat_point;
+
+    PParseTree *parse_tree;
+
+    P_IntermediateResult *result;
+
+} P_DirectFrame;
+
 /* -------------------------------------------------------------------------- */
 
-#define P_MAX_RECURSION_DEPTH 500
+/* the number of frames that a parser's stack starts out with room for. the
+ * stack grows as needed. */
+#define P_INITIAL_STACK_SIZE 64
+
+/* direct-coded parsers recurse on the C stack, so they nest no deeper than
+ * the parser's stack has room for frames. once the stack has grown then they
+ * run on a thread that has this many bytes of C stack for each frame, on top
+ * of what is set aside for the scanner and everything else. */
+#define P_DIRECT_FRAME_STACK_SIZE 512
+#define P_DIRECT_STACK_SIZE (256 * 1024)
+
+/* the number of token positions covered by a single chunk of the cache table,
+ * as a power of two. */
+#define P_MEMO_CHUNK_BITS 6
+#define P_MEMO_CHUNK_SIZE (1 << P_MEMO_CHUNK_BITS)
+#define P_MEMO_CHUNK_MASK (P_MEMO_CHUNK_SIZE - 1)
+
+/* A chunk of the cache table. It holds the intermediate results of every
+ * production for P_MEMO_CHUNK_SIZE consecutive token positions, grouped by
+ * position. */
+typedef P_IntermediateResult **P_MemoChunk;
+
+#define P_TOKEN_STORE_SIZE 256
+#define P_LEXEME_IN_INPUT 0x80000000U
+#define P_TOKEN_NONE 0xFFFFFFFFU
+
+/* the number of pieces that a parallel parse tries to split its tokens into
+ * for each worker thread, so that the workers finish at about the same time. */
+#define P_PARALLEL_CHUNKS_PER_WORKER 4
+
+/* what happened to each of the files of a batch parse. */
+typedef enum {
+    P_FILE_PARSED,
+    P_FILE_NOT_PARSED,
+    P_FILE_NOT_OPENED
+} P_FileResult;
+
+/* The tokens pulled from the scanner that the parser can still reach. Tokens
+ * are stored in parallel arrays indexed by their id less the id of the first
+ * token in the store. Lexemes are stored back-to-back in a single buffer, each
+ * followed by a null character. Parse trees are only made for tokens that end
+ * up in a parse tree. The offset of each token's lexeme into the scanner's
+ * input is kept as well.
+ *
+ * If the scanner's input is text in memory then lexemes aren't copied into the
+ * buffer at all: a token whose lexeme offset has P_LEXEME_IN_INPUT set has its
+ * lexeme at its input offset into 'input' instead.
+ *
+ * Tokens don't keep their lines and columns: those are found from a token's
+ * input offset with scanner_get_position once a parse tree is made for it.
+ *
+ * The tokens of an incremental parse are kept in a gap buffer so that an edit
+ * only moves the tokens between the gap and the edit. A token's id is then the
+ * index of its slot in the arrays, and so the ids of the tokens after the gap
+ * skip over it. Those tokens keep their input offsets from the end of the input
+ * instead of from its start, so that they don't change when an edit before them
+ * changes the input's length. Each token also has a handle that stays the same
+ * however far the token is moved, which is how the terminal trees made from it
+ * find it again. A store without a gap has gap_start set to P_TOKEN_NONE. */
+typedef struct P_TokenStore {
+
+    G_Terminal *terminals;
+
+    uint32_t *lexeme_lengths,
+             *lexeme_offsets,
+             *input_offsets;
+
+    char *lexemes;
+
+    const unsigned char *input;
+
+    /* the id of the first token in the store, and one past the id of the last
+     * token pulled from the scanner. */
+    uint32_t first_id,
+             end_id;
+
+    uint32_t capacity,
+             lexemes_size,
+             lexemes_capacity;
+
+    /* the slots of the gap, and the length of the input that the offsets of
+     * the tokens after it are from the end of. */
+    uint32_t gap_start,
+             gap_length,
+             input_length;
+
+    /* the handle of the token in each slot, and the slot of the token with each
+     * handle. handles that aren't in use are listed from 'free_handle' on,
+     * each one's entry in 'slots' being the next one, up to P_TOKEN_NONE. */
+    uint32_t *handles,
+             *slots,
+             num_handles,
+             free_handle;
+
+} P_TokenStore;
+
+/* The counters kept for each production rule by a parser that is profiling. */
+typedef enum {
+    P_PROFILE_PUSHES,
+    P_PROFILE_MEMO_HITS,
+    P_PROFILE_MEMO_MISSES,
+    P_PROFILE_MEMO_FAILURES,
+    P_PROFILE_LOCAL_BACKTRACKS,
+    P_PROFILE_CASCADING_BACKTRACKS,
+    P_PROFILE_LEFT_RECURSION_GROWTHS,
+    P_PROFILE_NUM_COUNTERS
+} P_ProfileCounter;
 
 /* The current state of the parser. */
 typedef struct PParser {
 
-    uint32_t num_tokens;
+    /* the tokens pulled from the scanner so far. tokens are only pulled as
+     * the parser first needs them. */
+    P_TokenStore tokens;
 
-    /* the cache table, this is a two dimensional array */
-    P_IntermediateResult **intermediate_results;
+    PScanner *scanner;
+    PScannerFunc *scanner_fnc;
 
-    /* the parser call stack */
+    /* when set, tokens are copied out of another token store instead of being
+     * pulled from the scanner. this is how a parallel parse hands each piece
+     * of the token stream to its own parser context. 'id_offset' is added to
+     * the ids of terminal trees so that they match the ids in 'tokens'. */
     struct {
-        P_Frame *stack[P_MAX_RECURSION_DEPTH];
-        char frame;
+        P_TokenStore *tokens;
+        uint32_t next_id,
+                 end_id,
+                 id_offset;
+    } prescanned;
+
+    /* the grammar being parsed with */
+    PGrammar *grammar;
+
+    /* the cache table. token positions are grouped into chunks and a chunk is
+     * only allocated once an intermediate result within it is created, so that
+     * memory grows with the parts of the token stream actually parsed. */
+    struct {
+        P_MemoChunk *chunks;
+        uint32_t num_chunks;
+        unsigned short num_productions;
+
+        /* the number of results cached and the number of times a cached
+         * result was used, per production, over all parses with the same
+         * grammar. */
+        uint32_t *num_writes,
+                 *num_hits;
+
+        /* which productions have their results cached, one bit per
+         * production. this starts out as the grammar's policy and is then
+         * tuned for this parser context alone. */
+        uint32_t *is_memoized;
+    } memo;
+
+    /* the parser call stack. frames are stored one after another and 'frame'
+     * is the index of the frame on top of the stack, or -1 if it is empty. */
+    struct {
+        P_Frame *frames;
+        uint32_t capacity;
+        int frame;
+
+        /* the number of frames, from the bottom of the stack, that can no
+         * longer backtrack, whose trees have been retained and whose results
+         * have been evicted. */
+        int num_retained;
+
+        /* set when a direct-coded parser would have nested deeper than the
+         * stack has room for. */
+        int is_too_deep;
     } call;
 
-    /* the set of all trees. once the parse tree is constructed then we
-     * remove the set of trees in the parse tree from this set so that we
-     * can free all memory held by all trees remaining in the set. */
-    PT_Set *tree_set;
+    /* the region that parse trees and intermediate results are allocated
+     * from. it is emptied all at once when the next parse starts. */
+    PArena *arena;
+
+    /* the parse trees made while parsing. trees are retained once the parser
+     * commits to everything before a cut. */
+    PT_Heap trees;
 
     /* the farthest id into the token stream that we've reached. */
     uint32_t farthest_id_reached;
@@ -218,6 +507,63 @@ typedef struct PParser {
     /* whether or not a backtrack is required */
     char must_backtrack;
 
+    /* the id of the current token of a direct-coded parser */
+    uint32_t token;
+
+    /* counters of what the parser did during the last parse, kept only once
+     * profiling is enabled. phrases are indexed by their position in the
+     * grammar's phrases. */
+    struct {
+        uint32_t (*productions)[P_PROFILE_NUM_COUNTERS];
+        uint32_t *phrase_attempts,
+                 *phrase_backtracks;
+
+        unsigned short num_productions,
+                       num_phrases;
+
+        unsigned int max_depth,
+                     is_enabled:1;
+    } profile;
+
+    /* the text being parsed incrementally. the cache table and the token store
+     * outlive each parse so that a reparse after an edit only redoes the work
+     * that the edit affected. */
+    struct {
+        unsigned char *text;
+        uint32_t length;
+
+        PScanner *scanner;
+        PParseTree *parse_tree;
+
+        /* the results that the last reparse cached or used as a frame's
+         * result. these are the only results before the gap that can look
+         * at or end at a token after it. */
+        P_ResultKey *recorded;
+        uint32_t num_recorded,
+                 recorded_capacity;
+
+        /* a tree of the largest end or farthest token id of the results in
+         * each chunk of the cache table, or in each run of chunks, so that the
+         * results that span an edit are found without looking at every chunk.
+         * leaves are at num_reach + the chunk's index, and the entry for a run
+         * of chunks is at half of the index of either of its halves. entries
+         * are only ever too large, never too small. */
+        uint32_t *reach,
+                 num_reach;
+
+        /* the number of trees left after the last full collection. trees that
+         * outlive a reparse are tenured, and all of the trees are collected
+         * again once twice as many as this have been tenured. */
+        uint32_t num_live_trees;
+
+        unsigned int is_enabled:1,
+                     is_reparsing:1;
+    } incremental;
+
 } PParser;
 
+/* the function of a direct-coded parser for its start production. it returns
+ * the parse tree of the tokens, or NULL if they couldn't be parsed. */
+typedef PParseTree *(PDirectParserFunc)(PParser *parser);
+
 #endif /* PPARSERTYPES_H_ */
@@ -24,6 +24,16 @@
 #include "pgen-grammar.h"
 #include "pgen-lexer.h"
 
+/* options for parser_gen_options. PGEN_DIRECT_PARSER generates a direct-coded
+ * parser along with the grammar, and PGEN_TABLE_LEXER generates a scanner
+ * that runs off of compressed transition tables instead of one that has a
+ * switch statement for every DFA state. PGEN_CURSOR_LEXER generates a scanner
+ * that reads the scanner's buffer through a local cursor, only calling into
+ * the scanner when the cursor reaches the end of what has been buffered. */
+#define PGEN_DIRECT_PARSER 1
+#define PGEN_TABLE_LEXER 2
+#define PGEN_CURSOR_LEXER 4
+
 void parser_gen(char *grammar_input_file,
                 char *grammar_func_name,
                 char *grammar_output_file,
@@ -31,4 +41,19 @@ void parser_gen(char *grammar_input_file,
                 char *lexer_output_file,
                 char *language_name);
 
+void parser_gen_direct(char *grammar_input_file,
+                       char *grammar_func_name,
+                       char *grammar_output_file,
+                       char *lexer_func_name,
+                       char *lexer_output_file,
+                       char *language_name);
+
+void parser_gen_options(char *grammar_input_file,
+                        char *grammar_func_name,
+                        char *grammar_output_file,
+                        char *lexer_func_name,
+                        char *lexer_output_file,
+                        char *language_name,
+                        unsigned int options);
+
 #endif /* PGENGEN_H_ */
@@ -14,40 +14,46 @@
 #include "p-parser.h"
 
 enum {
-    L_pg_string_5=0,
-    L_pg_positive_closure=1,
-    L_pg_epsilon=2,
-    L_pg_string_4=3,
-    L_pg_string_3=4,
-    L_pg_followed_by=5,
-    L_pg_regexp=6,
-    L_pg_regexp_2=7,
-    L_pg_non_terminal=8,
-    L_pg_regexp_1=9,
+    L_pg_string_6=0,
+    L_pg_string_5=1,
+    L_pg_positive_closure=2,
+    L_pg_epsilon=3,
+    L_pg_string_4=4,
+    L_pg_string_3=5,
+    L_pg_string_2=6,
+    L_pg_string_1=7,
+    L_pg_regexp=8,
+    L_pg_non_terminal=9,
     L_pg_kleene_closure=10,
     L_pg_non_excludable=11,
     L_pg_terminal=12,
     L_pg_self=13,
     L_pg_cut=14,
     L_pg_raise_children=15,
-    L_pg_not_followed_by=16,
-    L_pg_string=17,
-    L_pg_optional=18,
-    L_pg_fail=19
+    L_pg_string=16,
+    L_pg_optional=17,
+    L_pg_fail=18
 };
 
 enum {
     P_pg_RuleFlag=0,
     P_pg_ProductionRules=1,
-    P_pg_Terminal=2,
-    P_pg_Production=3,
-    P_pg_Rule=4,
-    P_pg_GrammarRules=5,
-    P_pg_Rules=6,
-    P_pg_subrule_1=7,
-    P_pg_subrule_2=8
+    P_pg_SyncTerminal=2,
+    P_pg_Terminal=3,
+    P_pg_Production=4,
+    P_pg_Repetition=5,
+    P_pg_SyncTerminals=6,
+    P_pg_Rule=7,
+    P_pg_GrammarRules=8,
+    P_pg_Rules=9,
+    P_pg_subrule_2=10,
+    P_pg_subrule_4=11,
+    P_pg_subrule_1=12,
+    P_pg_subrule_3=13
 };
 
+#define P_PG_NUM_PRODUCTIONS 14
+
 PGrammar *parser_grammar_grammar(void);
 
 
@@ -0,0 +1,45 @@
+/*
+ * std-arena.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: petergoodman
+ *     Version: $Id$
+ */
+
+#ifndef STDARENA_H_
+#define STDARENA_H_
+
+#include "std-include.h"
+
+#define A_BLOCK_SIZE 65536
+#define A_ALIGNMENT 8
+#define A_NUM_SIZE_CLASSES 32
+#define A_MAX_CLASS_SIZE (A_NUM_SIZE_CLASSES * A_ALIGNMENT)
+
+/**
+ * A region of memory that objects are allocated from by bumping a pointer and
+ * that is freed all at once. Small objects that are released before then are
+ * kept on free lists, by size, to be re-used.
+ */
+typedef struct PArena {
+
+    struct PArenaBlock *blocks;
+
+    unsigned char *next,
+                  *end;
+
+    void *free_lists[A_NUM_SIZE_CLASSES];
+
+} PArena;
+
+PArena *arena_alloc(void);
+
+void arena_free(PArena *arena);
+
+void arena_reset(PArena *arena);
+
+void *arena_malloc(PArena *arena, size_t size);
+
+void arena_release(PArena *arena, void *pointer, size_t size);
+
+#endif /* STDARENA_H_ */
@@ -17,6 +17,16 @@
 
 unsigned long int mem_num_allocated_pointers(void);
 
+/* update a count of allocated pointers. memory can be allocated by several
+ * threads at once, e.g. by a parallel parse, so the update is atomic. */
+#if defined(__GNUC__)
+#   define mem_count_alloc(counter) __sync_fetch_and_add(&(counter), 1)
+#   define mem_count_free(counter) __sync_fetch_and_sub(&(counter), 1)
+#else
+#   define mem_count_alloc(counter) ++(counter)
+#   define mem_count_free(counter) --(counter)
+#endif
+
 #if defined(P_DEBUG_MEM) && P_DEBUG_MEM == 1
 
 void *_mem_alloc(size_t, const unsigned int, const char * );
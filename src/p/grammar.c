@@ -16,15 +16,291 @@
 
 /* -------------------------------------------------------------------------- */
 
+/**
+ * Free the FIRST sets of a grammar so that they will be re-computed the next
+ * time that the grammar is locked.
+ */
+static void G_forget_first_sets(PGrammar *grammar) {
+    if(is_not_null(grammar->first_sets)) {
+        mem_free(grammar->first_sets);
+        grammar->first_sets = NULL;
+    }
+}
+
+/**
+ * Get the next unused symbol of the grammar. Every kind of symbol is added
+ * through here, so any FIRST sets computed without it are forgotten.
+ */
 static G_Symbol *G_get_next_symbol(PGrammar *grammar) {
 
     assert_not_null(grammar);
     assert(!grammar->is_locked);
     assert(grammar->counter[C_SYMBOLS] < grammar->num_symbols);
 
+    G_forget_first_sets(grammar);
+
     return grammar->symbols + ((grammar->counter[C_SYMBOLS])++);
 }
 
+/**
+ * Add the terminals of one FIRST set into another. Returns 1 if this changed
+ * the set being added to.
+ */
+static int G_first_set_union(uint32_t *set,
+                             uint32_t *other,
+                             unsigned short size) {
+    unsigned short i;
+    uint32_t old;
+    int changed = 0;
+
+    for(i = 0; i < size; ++i) {
+        old = set[i];
+        set[i] |= other[i];
+        changed |= (old != set[i]);
+    }
+
+    return changed;
+}
+
+/**
+ * Update the FIRST set and nullability of a phrase from what is currently
+ * known about the production rules. Returns 1 if either changed.
+ */
+static int G_phrase_update_first_set(PGrammar *grammar, G_Phrase *phrase) {
+
+    unsigned int i,
+                 is_nullable = 1,
+                 is_predictable = 1;
+    int changed = 0;
+    uint32_t bit;
+    G_Symbol *symbol;
+    G_ProductionRule *rule;
+
+    for(i = 0; i < phrase->num_symbols && is_nullable; ++i) {
+        symbol = phrase->symbols + i;
+
+        /* an optional symbol can match the empty string, so the symbols
+         * after it can also start the phrase. */
+        if(symbol->is_terminal) {
+            is_nullable = symbol->is_optional;
+            if(symbol->value.terminal >= 0) {
+                bit = ((uint32_t) 1) << (symbol->value.terminal & 31);
+                changed |= !(phrase->first_set[symbol->value.terminal >> 5] & bit);
+                phrase->first_set[symbol->value.terminal >> 5] |= bit;
+            }
+
+        } else if(symbol->is_non_terminal) {
+            rule = grammar->production_rules + symbol->value.non_terminal;
+            is_nullable = rule->is_nullable || symbol->is_optional;
+            changed |= G_first_set_union(
+                phrase->first_set,
+                rule->first_set,
+                grammar->first_set_size
+            );
+
+        } else if(symbol->is_fail) {
+            is_nullable = 0;
+
+        /* committing before a token is matched means that later phrases
+         * must not be tried, even if this phrase can't match. */
+        } else if(symbol->is_cut) {
+            is_predictable = 0;
+        }
+    }
+
+    phrase->is_predictable = is_predictable;
+
+    if(is_nullable && !phrase->is_nullable) {
+        phrase->is_nullable = 1;
+        changed = 1;
+    }
+
+    return changed;
+}
+
+/**
+ * Find the production rules that can be applied again at the same token
+ * without consuming any tokens, i.e. the left-recursive production rules, and
+ * decide which production rules have their results cached by the parser.
+ *
+ * Left-recursive production rules must be memoized as the parser depends on
+ * the cache to detect left recursion. Otherwise, a production rule that doesn't
+ * apply any other production is cheaper to re-apply than to cache. This
+ * depends on the nullability computed with the FIRST sets.
+ */
+static void G_compute_memo_policy(PGrammar *grammar) {
+
+    unsigned int i,
+                 j,
+                 k,
+                 p,
+                 num_stacked;
+    G_NonTerminal *stack;
+    char *seen;
+    G_ProductionRule *rule;
+    G_Phrase *phrase;
+    G_Symbol *symbol;
+
+    if(0 == grammar->num_productions) {
+        return;
+    }
+
+    stack = mem_alloc(grammar->num_productions * sizeof(G_NonTerminal));
+    seen = mem_alloc(grammar->num_productions * sizeof(char));
+
+    if(is_null(stack) || is_null(seen)) {
+        mem_error("Unable to allocate space to find left recursion.");
+    }
+
+    for(p = 0; p < grammar->num_productions; ++p) {
+
+        memset(seen, 0, grammar->num_productions * sizeof(char));
+        stack[0] = (G_NonTerminal) p;
+        num_stacked = 1;
+
+        grammar->production_rules[p].is_left_recursive = 0;
+        grammar->production_rules[p].is_memoized = 0;
+
+        /* search the production rules that can be applied at the same token
+         * as production rule 'p' to see if 'p' is one of them. */
+        while(num_stacked > 0) {
+            rule = grammar->production_rules + stack[--num_stacked];
+
+            for(j = 0; j < rule->num_phrases; ++j) {
+                phrase = rule->phrases + j;
+
+                for(k = 0; k < phrase->num_symbols; ++k) {
+                    symbol = phrase->symbols + k;
+
+                    if(symbol->is_fail
+                    || (symbol->is_terminal && !symbol->is_optional)) {
+                        break;
+                    } else if(!symbol->is_non_terminal) {
+                        continue;
+                    }
+
+                    i = (unsigned int) symbol->value.non_terminal;
+
+                    if(i == p) {
+
+                        /* the parser grows left recursion by re-applying the
+                         * production, which it can't do for a single match of
+                         * a repeated or optional symbol. */
+                        if(symbol->is_repeated || symbol->is_optional) {
+                            std_error(
+                                "Grammar Error: A repeated or optional symbol "
+                                "cannot be left recursive."
+                            );
+                        }
+
+                        grammar->production_rules[p].is_left_recursive = 1;
+                    } else if(!seen[i]) {
+                        seen[i] = 1;
+                        stack[num_stacked++] = symbol->value.non_terminal;
+                    }
+
+                    if(!grammar->production_rules[i].is_nullable
+                    && !symbol->is_optional) {
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    mem_free(stack);
+    mem_free(seen);
+
+    for(p = 0; p < grammar->num_productions; ++p) {
+        rule = grammar->production_rules + p;
+        rule->is_memoized = rule->is_left_recursive;
+
+        for(j = 0; j < rule->num_phrases && !rule->is_memoized; ++j) {
+            phrase = rule->phrases + j;
+            for(k = 0; k < phrase->num_symbols; ++k) {
+                if(phrase->symbols[k].is_non_terminal) {
+                    rule->is_memoized = 1;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Compute the FIRST sets and nullability of every production rule and phrase
+ * in the grammar. A production rule without any phrases matches the empty
+ * string. Left recursion is dealt with by iterating until nothing changes.
+ */
+static void G_compute_first_sets(PGrammar *grammar) {
+
+    unsigned int i,
+                 j,
+                 num_terminals = grammar->num_tokens;
+    int changed;
+    G_ProductionRule *rule;
+    G_Phrase *phrase;
+
+    /* make room for any terminal used in a phrase */
+    for(i = 0; i < grammar->num_symbols; ++i) {
+        if(grammar->symbols[i].is_terminal
+        && grammar->symbols[i].value.terminal >= (int) num_terminals) {
+            num_terminals = grammar->symbols[i].value.terminal + 1;
+        }
+    }
+
+    grammar->num_first_terminals = num_terminals;
+    grammar->first_set_size = (num_terminals + 31) / 32;
+    grammar->first_sets = mem_calloc(
+        (grammar->num_productions + grammar->num_phrases)
+      * (grammar->first_set_size > 0 ? grammar->first_set_size : 1),
+        sizeof(uint32_t)
+    );
+
+    if(is_null(grammar->first_sets)) {
+        mem_error("Unable to allocate the FIRST sets of a grammar.");
+    }
+
+    for(i = 0; i < grammar->num_productions; ++i) {
+        rule = grammar->production_rules + i;
+        rule->first_set = grammar->first_sets + (i * grammar->first_set_size);
+        rule->is_nullable = (0 == rule->num_phrases);
+    }
+
+    for(i = 0; i < grammar->num_phrases; ++i) {
+        phrase = grammar->phrases + i;
+        phrase->first_set = grammar->first_sets + (
+            (grammar->num_productions + i) * grammar->first_set_size
+        );
+        phrase->is_nullable = 0;
+        phrase->is_predictable = 0;
+    }
+
+    do {
+        changed = 0;
+
+        for(i = 0; i < grammar->num_productions; ++i) {
+            rule = grammar->production_rules + i;
+
+            for(j = 0; j < rule->num_phrases; ++j) {
+                phrase = rule->phrases + j;
+
+                changed |= G_phrase_update_first_set(grammar, phrase);
+                changed |= G_first_set_union(
+                    rule->first_set,
+                    phrase->first_set,
+                    grammar->first_set_size
+                );
+
+                if(phrase->is_nullable && !rule->is_nullable) {
+                    rule->is_nullable = 1;
+                    changed = 1;
+                }
+            }
+        }
+    } while(changed);
+}
+
 /* -------------------------------------------------------------------------- */
 
 /**
@@ -58,6 +334,7 @@ PGrammar *grammar_alloc(G_NonTerminal start_production,
     grammar->num_tokens = num_tokens;
 
     grammar->is_locked = 0;
+    grammar->is_frozen = 0;
     grammar->start_production_rule = start_production;
 
     grammar->counter[C_PRODUCTION_RULES] = 0;
@@ -104,6 +381,11 @@ void grammar_free(PGrammar *grammar) {
         mem_free(curr);
     }
 
+    if(is_not_null(grammar->sync_terminals)) {
+        mem_free(grammar->sync_terminals);
+    }
+
+    G_forget_first_sets(grammar);
     mem_free(grammar);
 }
 
@@ -132,6 +414,8 @@ void grammar_add_production_rule(PGrammar *grammar, G_NonTerminal production) {
 
     assert(which_rule < grammar->num_productions);
 
+    G_forget_first_sets(grammar);
+
     rule = grammar->production_rules + ((unsigned int) production);
 
     if(0 == which_rule) {
@@ -176,6 +460,8 @@ void grammar_add_phrase(PGrammar *grammar) {
 
     assert(which_phrase < grammar->num_phrases);
 
+    G_forget_first_sets(grammar);
+
     phrase = grammar->phrases + which_phrase;
 
     /* this is the first phrase being added */
@@ -244,6 +530,42 @@ void grammar_add_epsilon_symbol(PGrammar *grammar, G_TreeOp tree_op) {
     symbol->is_non_excludable = (tree_op != G_AUTO);
 }
 
+/**
+ * Repeat the most recently added symbol, which must be a terminal or a
+ * non-terminal. In the following grammar:
+ *
+ *     A --> B* c+ d?
+ *
+ * B is matched as many times as possible, c is matched at least once, and d is
+ * optional. Repetitions are greedy: the parser never gives back the matches of
+ * a repeated symbol in order to match the rest of a phrase. Each match of a
+ * repeated symbol adds to the tree of its phrase according to the symbol's tree
+ * op, so a list can be built without recursion, e.g.
+ *
+ *     StmtList --> -Stmt ^("," -Stmt)*
+ */
+void grammar_repeat_symbol(PGrammar *grammar, G_Repetition repetition) {
+
+    G_Symbol *symbol;
+
+    assert_not_null(grammar);
+    assert(!grammar->is_locked);
+    assert(grammar->counter[C_SYMBOLS] > 0);
+
+    G_forget_first_sets(grammar);
+
+    symbol = grammar->symbols + (grammar->counter[C_SYMBOLS] - 1);
+
+    if(!symbol->is_terminal && !symbol->is_non_terminal) {
+        std_error(
+            "Grammar Error: Only terminals and non-terminals can be repeated."
+        );
+    }
+
+    symbol->is_repeated = (repetition != G_ZERO_OR_ONE);
+    symbol->is_optional = (repetition != G_ONE_OR_MORE);
+}
+
 /**
  * A null production rule action function, i.e. it does nothing.
  */
@@ -269,6 +591,7 @@ void grammar_add_tree_actions(PGrammar *grammar,
 
     assert_not_null(grammar);
     assert(grammar->num_productions > 0);
+    assert(!grammar->is_frozen);
 
     data = mem_alloc(
         sizeof(G_ActionRules)
@@ -299,6 +622,46 @@ void grammar_add_tree_actions(PGrammar *grammar,
     }
 }
 
+/**
+ * Declare 'terminal' to be a synchronization terminal. A synchronization
+ * terminal must only ever appear as the first token of a top-level unit of the
+ * start production, e.g. the "def" keyword starting a function definition, so
+ * that the tokens can be split before it and each part parsed on its own.
+ * pgen grammars declare them with '%sync', e.g. %sync "def" "type" ;
+ */
+void grammar_add_sync_terminal(PGrammar *grammar, G_Terminal terminal) {
+
+    unsigned short size;
+    uint32_t *set;
+
+    assert_not_null(grammar);
+    assert(!grammar->is_locked);
+    assert(terminal >= 0);
+
+    size = (terminal >> 5) + 1;
+
+    if(size > grammar->sync_set_size) {
+        set = mem_calloc(size, sizeof(uint32_t));
+        if(is_null(set)) {
+            mem_error("Unable to allocate the synchronization terminals.");
+        }
+
+        if(is_not_null(grammar->sync_terminals)) {
+            memcpy(
+                set,
+                grammar->sync_terminals,
+                grammar->sync_set_size * sizeof(uint32_t)
+            );
+            mem_free(grammar->sync_terminals);
+        }
+
+        grammar->sync_terminals = set;
+        grammar->sync_set_size = size;
+    }
+
+    grammar->sync_terminals[terminal >> 5] |= ((uint32_t) 1) << (terminal & 31);
+}
+
 /**
  * Add an action rule to the grammar to be performed on whatever state is being
  * used.
@@ -308,6 +671,9 @@ void grammar_add_state_action(PGrammar *grammar, PDelegate *action_fnc) {
     G_ActionRules *new,
                   *next;
 
+    assert_not_null(grammar);
+    assert(!grammar->is_frozen);
+
     new = mem_alloc(sizeof(G_ActionRules));
     if(is_null(new)) {
         mem_error("Internal Grammar Error: Unable to add state action function.");
@@ -329,18 +695,55 @@ void grammar_add_state_action(PGrammar *grammar, PDelegate *action_fnc) {
 /* -------------------------------------------------------------------------- */
 
 /**
- * Lock a grammar from further adding of stuff.
+ * Freeze a grammar so that it can be shared between threads. Everything that
+ * the parser would otherwise compute the first time that the grammar is locked
+ * is computed now, and the grammar is locked for good: no rules, actions or
+ * synchronization terminals can be added to it. Parsing with a frozen grammar
+ * only ever reads from it.
+ */
+void grammar_freeze(PGrammar *grammar) {
+    assert_not_null(grammar);
+
+    if(grammar->is_frozen) {
+        return;
+    }
+
+    G_lock(grammar);
+    grammar->is_frozen = 1;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Lock a grammar from further adding of stuff. The FIRST sets of the grammar
+ * are computed the first time that it is locked. Locking a frozen grammar does
+ * nothing.
  */
 void G_lock(PGrammar *grammar) {
     assert_not_null(grammar);
+
+    if(grammar->is_frozen) {
+        return;
+    }
+
     grammar->is_locked = 1;
+
+    if(is_null(grammar->first_sets)) {
+        G_compute_first_sets(grammar);
+        G_compute_memo_policy(grammar);
+    }
 }
 
 /**
- * Unlock a grammar.
+ * Unlock a grammar. Frozen grammars stay locked.
  */
 void G_unlock(PGrammar *grammar) {
     assert_not_null(grammar);
+
+    if(grammar->is_frozen) {
+        return;
+    }
+
     grammar->is_locked = 0;
 }
 
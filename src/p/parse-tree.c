@@ -8,98 +8,220 @@
 
 #include <p-parse-tree.h>
 #include <p-grammar-internal.h>
+#include <adt-stack.h>
 
 #define D(p)
 
 /**
- * Allocate a new terminal tree.
+ * Allocate a tree from the heap's arena and put it on the unretained list.
  */
-PT_Terminal *PT_alloc_terminal(G_Terminal terminal,
-                               PString *lexeme,
+static void *PT_alloc(PT_Heap *heap,
+                      size_t struct_size,
+                      PT_Type type,
+                      uint32_t num_branches) {
+    PParseTree *tree = arena_malloc(heap->arena, struct_size);
+    PTree *as_tree = (PTree *) tree;
+
+    as_tree->_degree = num_branches;
+    as_tree->_fill = 0;
+    as_tree->_branches = NULL;
+
+    if(num_branches > 0) {
+        as_tree->_branches = arena_malloc(
+            heap->arena,
+            num_branches * sizeof(PTree *)
+        );
+    }
+
+    tree->type = type;
+    tree->is_marked = 0;
+    tree->is_retained = 0;
+    tree->is_tenured = 0;
+    tree->next_unretained = heap->unretained;
+    heap->unretained = tree;
+
+    return tree;
+}
+
+/**
+ * Return the memory of a single tree node to the heap's arena.
+ */
+static void PT_release(PT_Heap *heap, PParseTree *tree) {
+    size_t struct_size = sizeof(PT_Epsilon);
+
+    if(tree->type == PT_NON_TERMINAL) {
+        struct_size = sizeof(PT_NonTerminal);
+    } else if(tree->type == PT_TERMINAL) {
+        struct_size = sizeof(PT_Terminal);
+        if(is_not_null(((PT_Terminal *) tree)->lexeme)) {
+            arena_release(
+                heap->arena,
+                ((PT_Terminal *) tree)->lexeme,
+                sizeof(PString) + ((PT_Terminal *) tree)->lexeme->len + 1
+            );
+        }
+    }
+
+    arena_release(
+        heap->arena,
+        ((PTree *) tree)->_branches,
+        ((PTree *) tree)->_degree * sizeof(PTree *)
+    );
+
+    arena_release(heap->arena, tree, struct_size);
+}
+
+/**
+ * Copy a lexeme into a null-terminated string allocated from the heap.
+ */
+static PString *PT_alloc_lexeme(PT_Heap *heap,
+                                const char *lexeme,
+                                uint32_t lexeme_length) {
+    PString *str = arena_malloc(
+        heap->arena,
+        sizeof(PString) + lexeme_length + 1
+    );
+
+    str->len = lexeme_length;
+    str->str = (PChar *) (str + 1);
+    memcpy(str->str, lexeme, lexeme_length);
+    str->str[lexeme_length] = 0;
+
+    D( printf("lexeme: { %s } \n", str->str); )
+
+    return str;
+}
+
+/**
+ * Allocate a new terminal tree. If 'is_lasting' is set then the lexeme's
+ * characters outlive the tree and are only copied into the heap once
+ * PT_get_lexeme is called, otherwise they are copied into the heap now.
+ */
+PT_Terminal *PT_alloc_terminal(PT_Heap *heap,
+                               G_Terminal terminal,
+                               const char *lexeme,
+                               uint32_t lexeme_length,
+                               int is_lasting,
                                uint32_t line,
                                uint32_t column,
                                uint32_t id) {
     PT_Terminal *tree = NULL;
 
-    tree = tree_alloc(sizeof(PT_Terminal), 0);
-    ((PParseTree *) tree)->type = PT_TERMINAL;
-
-    D(if(is_not_null(lexeme)) {
-        printf("lexeme: { %s } %d \n", lexeme->str, terminal);
-    })
-
+    tree = PT_alloc(heap, sizeof(PT_Terminal), PT_TERMINAL, 0);
 
     tree->terminal = terminal;
-    tree->lexeme = lexeme;
+    tree->lexeme = NULL;
+    tree->text = lexeme;
+    tree->text_length = lexeme_length;
+    tree->heap = heap;
     tree->line = line;
     tree->column = column;
-    tree->next = NULL;
     tree->id = id;
+    tree->token = id;
+
+    if(is_not_null(lexeme) && !is_lasting) {
+        tree->lexeme = PT_alloc_lexeme(heap, lexeme, lexeme_length);
+        tree->text = tree->lexeme->str;
+    }
 
     return tree;
 }
 
+/**
+ * Return the lexeme of a terminal tree, or NULL if it has none. The lexeme is
+ * copied out of the scanner's input the first time that it is asked for.
+ */
+PString *PT_get_lexeme(PT_Terminal *tree) {
+    assert_not_null(tree);
+
+    if(is_null(tree->lexeme) && is_not_null(tree->text)) {
+        tree->lexeme = PT_alloc_lexeme(
+            tree->heap,
+            tree->text,
+            tree->text_length
+        );
+    }
+
+    return tree->lexeme;
+}
+
 /**
  * Allocate a new non-terminal tree.
  */
-PT_NonTerminal *PT_alloc_non_terminal(G_NonTerminal production,
-                                      unsigned short num_branches) {
+PT_NonTerminal *PT_alloc_non_terminal(PT_Heap *heap,
+                                      G_NonTerminal production,
+                                      uint32_t num_branches) {
     PT_NonTerminal *tree;
-    tree = tree_alloc(sizeof(PT_NonTerminal), num_branches);
-    ((PParseTree *) tree)->type = PT_NON_TERMINAL;
+    tree = PT_alloc(heap, sizeof(PT_NonTerminal), PT_NON_TERMINAL, num_branches);
     tree->phrase = 0;
     tree->production = production;
     return tree;
 }
 
 /**
- * Allocate an epsilon tree on the heap.
+ * Allocate an epsilon tree.
  */
-PT_Epsilon *PT_alloc_epsilon(void) {
-    PT_Epsilon *tree = tree_alloc(sizeof(PT_Epsilon), 0);
-    ((PParseTree *) tree)->type = PT_EPSILON;
-    return tree;
+PT_Epsilon *PT_alloc_epsilon(PT_Heap *heap) {
+    return PT_alloc(heap, sizeof(PT_Epsilon), PT_EPSILON, 0);
 }
 
 /**
- * Clear the branches or the lexeme of a parse tree.
+ * Add a branch to a parse tree, growing its branches if necessary. A branch
+ * added to a retained tree is retained.
  */
-static void PT_clear(PParseTree *parse_tree) {
-    PT_Terminal *pt_as_terminal;
-    if(parse_tree->type == PT_TERMINAL) {
+void PT_add_branch(PT_Heap *heap, PParseTree *parent, PParseTree *branch) {
+    PTree *tree = (PTree *) parent,
+          **branches;
+
+    assert_not_null(parent);
+    assert_not_null(branch);
 
-        pt_as_terminal = (PT_Terminal *) parse_tree;
+    if(tree->_fill >= tree->_degree) {
+        branches = arena_malloc(
+            heap->arena,
+            (0 == tree->_degree ? 1 : tree->_degree * 2) * sizeof(PTree *)
+        );
 
-        if(is_not_null(pt_as_terminal->lexeme)) {
-            string_free(pt_as_terminal->lexeme);
-            pt_as_terminal->lexeme = NULL;
+        if(tree->_fill > 0) {
+            memcpy(branches, tree->_branches, tree->_fill * sizeof(PTree *));
         }
 
-    } else if(parse_tree->type == PT_NON_TERMINAL) {
-        tree_clear((PTree *) parse_tree);
+        arena_release(
+            heap->arena,
+            tree->_branches,
+            tree->_degree * sizeof(PTree *)
+        );
+
+        tree->_degree = (0 == tree->_degree) ? 1 : tree->_degree * 2;
+        tree->_branches = branches;
+    }
+
+    tree->_branches[(tree->_fill)++] = (PTree *) branch;
+
+    if(parent->is_retained && !branch->is_retained) {
+        PTH_retain(heap, branch);
     }
 }
 
 /**
- * Free a parse tree (excluding its branches).
+ * Add the branches of one parse tree as branches of another.
  */
-static void PT_free(PParseTree *parse_tree) {
-    PT_clear(parse_tree);
-    tree_free((PTree *) parse_tree, &delegate_do_nothing);
+void PT_add_branch_children(PT_Heap *heap,
+                            PParseTree *parent,
+                            PParseTree *tree) {
+    uint32_t i;
+
+    for(i = 0; i < ((PTree *) tree)->_fill; ++i) {
+        PT_add_branch(
+            heap,
+            parent,
+            (PParseTree *) tree_get_branch(tree, i)
+        );
+    }
 }
 
 /* -------------------------------------------------------------------------- */
 
-/**
- * Free a parse tree, in its entirety.
- */
-void parse_tree_free(PParseTree *parse_tree) {
-    tree_free(
-        (PTree *) parse_tree,
-        (PDelegate *) &PT_clear
-    );
-}
-
 /**
  * Print the parse tree out in the DOT language.
  */
@@ -110,6 +232,7 @@ void parse_tree_print_dot(PParseTree *parse_tree,
     PParseTree *curr;
     PTree *tree;
     PT_Terminal *term;
+    PString *lexeme;
     unsigned int i;
 
     if(is_null(parse_tree)) {
@@ -143,11 +266,12 @@ void parse_tree_print_dot(PParseTree *parse_tree,
 
             case PT_TERMINAL:
                 term = (PT_Terminal *) curr;
+                lexeme = PT_get_lexeme(term);
                 printf(
                     "%p [label=\"%s<%s> @ %d\" color=gray shape=square] \n",
                     (void *) tree,
                     terminal_names[term->terminal],
-                    is_not_null(term->lexeme) ? term->lexeme->str : "",
+                    is_not_null(lexeme) ? lexeme->str : "",
                     term->id
                 );
 
@@ -168,49 +292,143 @@ void parse_tree_print_dot(PParseTree *parse_tree,
 /* -------------------------------------------------------------------------- */
 
 /**
- * Allocate a set of trees.
+ * Initialize a heap of parse trees that allocates trees from 'arena'. The trees
+ * are freed along with the arena.
  */
-PT_Set *PTS_alloc(void) {
-    return dict_alloc(
-        53,
-        (PDictionaryHashFunc *) &dict_pointer_hash_fnc,
-        (PDictionaryCollisionFunc *) &dict_pointer_collision_fnc
-    );
+void PTH_init(PT_Heap *heap, PArena *arena) {
+    heap->arena = arena;
+    heap->unretained = NULL;
+    heap->tenured = NULL;
+    heap->num_tenured = 0;
 }
 
 /**
- * Free a set of trees.
+ * Mark a tree and all of its descendants as being part of the final parse
+ * tree. Retained subtrees are not revisited: any branch added to a retained
+ * tree is itself retained.
  */
-void PTS_free(PT_Set *set) {
-    dict_free(
-        set,
-        &delegate_do_nothing, /* free key */
-        (PDelegate *) &PT_free /* free val */
-    );
+void PTH_retain(PT_Heap *heap, PParseTree *tree) {
+    PStack *stack = stack_alloc(sizeof(PStack));
+    PParseTree *curr;
+    uint32_t i;
+
+    stack_push(stack, tree);
+
+    while(!stack_is_empty(stack)) {
+        curr = stack_pop(stack);
+
+        if(curr->is_retained) {
+            continue;
+        }
+
+        curr->is_retained = 1;
+
+        for(i = 0; i < ((PTree *) curr)->_fill; ++i) {
+            stack_push(stack, tree_get_branch(curr, i));
+        }
+    }
+
+    stack_free(stack, &delegate_do_nothing);
 }
 
 /**
- * Add a parse tree to the tree set.
+ * Mark a tree and all of its descendants as reachable until the next sweep.
+ * Tenured trees are left alone: they, and so their descendants, are only
+ * looked at again once they are untenured.
  */
-void PTS_add(PT_Set *set, PParseTree *tree) {
-    dict_set(set, tree, tree, &delegate_do_nothing);
+void PTH_mark(PT_Heap *heap, PParseTree *tree) {
+    PStack *stack;
+    PParseTree *curr;
+    uint32_t i;
+
+    if(tree->is_marked || tree->is_retained || tree->is_tenured) {
+        return;
+    }
+
+    stack = stack_alloc(sizeof(PStack));
+    stack_push(stack, tree);
+
+    while(!stack_is_empty(stack)) {
+        curr = stack_pop(stack);
+
+        if(curr->is_marked || curr->is_retained || curr->is_tenured) {
+            continue;
+        }
+
+        curr->is_marked = 1;
+
+        for(i = 0; i < ((PTree *) curr)->_fill; ++i) {
+            stack_push(stack, tree_get_branch(curr, i));
+        }
+    }
+
+    stack_free(stack, &delegate_do_nothing);
 }
 
 /**
- * Remove a tree from the tree set.
+ * Release every unretained tree that has not been marked since the last sweep
+ * and clear the marks of the others. Retained trees are taken off of the
+ * unretained list.
  */
-void PTS_remove(PT_Set *set, PParseTree *tree) {
-    dict_unset(
-        set,
-        tree,
-        &delegate_do_nothing,
-        &delegate_do_nothing
-    );
+void PTH_sweep(PT_Heap *heap) {
+    PParseTree *curr,
+               *next,
+               **prev = &(heap->unretained);
+
+    for(curr = heap->unretained; is_not_null(curr); curr = next) {
+        next = curr->next_unretained;
+
+        if(curr->is_marked) {
+            curr->is_marked = 0;
+            prev = &(curr->next_unretained);
+            continue;
+        }
+
+        *prev = next;
+
+        if(!curr->is_retained) {
+            PT_release(heap, curr);
+        }
+    }
+}
+
+/**
+ * Tenure every unretained tree. This is done once a sweep has released the
+ * garbage among them, so that later sweeps only look at newer trees.
+ */
+void PTH_tenure(PT_Heap *heap) {
+    PParseTree *curr,
+               *next;
+
+    for(curr = heap->unretained; is_not_null(curr); curr = next) {
+        next = curr->next_unretained;
+
+        curr->is_tenured = 1;
+        curr->next_unretained = heap->tenured;
+        heap->tenured = curr;
+        ++(heap->num_tenured);
+    }
+
+    heap->unretained = NULL;
 }
 
 /**
- * Return the number of elements in the tree set.
+ * Put every tenured tree back on the unretained list, with its mark cleared,
+ * so that the next mark and sweep collects all of the heap's garbage.
  */
-uint32_t PTS_size(PT_Set *set) {
-    return dict_size(set);
+void PTH_untenure(PT_Heap *heap) {
+    PParseTree *curr,
+               *next;
+
+    for(curr = heap->tenured; is_not_null(curr); curr = next) {
+        next = curr->next_unretained;
+
+        curr->is_tenured = 0;
+        curr->is_marked = 0;
+        curr->next_unretained = heap->unretained;
+        heap->unretained = curr;
+    }
+
+    heap->tenured = NULL;
+    heap->num_tenured = 0;
 }
@@ -6,44 +6,120 @@
  *     Version: $Id$
  */
 
+#include <pthread.h>
+
 #include <p-parser.h>
+#include <p-grammar.h>
 
 #define D(x)
 
 #define PT_ENABLE_TREE_REDUCTIONS 1
 
+/* whether or not the counters of a profiling parser are compiled in at all */
+#define P_ENABLE_PROFILING 1
+
+#if P_ENABLE_PROFILING
+#   define P_COUNT(parser, production, counter) \
+        do { \
+            if((parser)->profile.is_enabled) { \
+                ++((parser)->profile.productions[(production)][(counter)]); \
+            } \
+        } while(0)
+#   define P_COUNT_PHRASE(parser, counters, rule, phrase) \
+        do { \
+            if((parser)->profile.is_enabled \
+            && (phrase) < (rule)->num_phrases) { \
+                ++((parser)->profile.counters[ \
+                    ((rule)->phrases - (parser)->grammar->phrases) + (phrase) \
+                ]); \
+            } \
+        } while(0)
+#   define P_COUNT_DEPTH(parser, depth) \
+        do { \
+            if((parser)->profile.is_enabled \
+            && (depth) > (parser)->profile.max_depth) { \
+                (parser)->profile.max_depth = (depth); \
+            } \
+        } while(0)
+#else
+#   define P_COUNT(parser, production, counter) do { } while(0)
+#   define P_COUNT_PHRASE(parser, counters, rule, phrase) do { } while(0)
+#   define P_COUNT_DEPTH(parser, depth) do { } while(0)
+#endif
+
+/* whether or not the results of 'production' are cached by 'parser' */
+#define P_IS_MEMOIZED(parser, production) ( \
+    (parser)->memo.is_memoized[(production) >> 5] \
+    & (((uint32_t) 1) << ((production) & 31)) \
+)
+
 #define IR_FAILED ((void *) 10)
 #define IR_INITIAL ((void *) 11)
 
+/* the terminal of the token with id 'id' in a token store */
+#define TS_TERMINAL(store, id) ((store)->terminals[(id) - (store)->first_id])
+
+/* the input offset of the token at index 'i' of a token store. the offsets of
+ * the tokens after the gap are kept from the end of the input. */
+#define TS_INPUT_OFFSET(store, i) ( \
+    (i) >= (store)->gap_start \
+        ? (store)->input_length - (store)->input_offsets[i] \
+        : (store)->input_offsets[i] \
+)
+
+/* the slot of the 'n'th token of a token store with a gap, and the reverse */
+#define TS_SLOT(store, n) \
+    ((n) < (store)->gap_start ? (n) : (n) + (store)->gap_length)
+#define TS_INDEX(store, i) \
+    ((i) < (store)->gap_start ? (i) : (i) - (store)->gap_length)
+
+/* record that a frame has looked at the token with id 'id' */
+#define F_EXAMINE(frame, id) \
+    if((id) > (frame)->farthest_token) { (frame)->farthest_token = (id); }
+
 /* -------------------------------------------------------------------------- */
 
 /**
- * Free all of the parser's stack frames.
+ * Allocate the parser's (initially empty) stack of frames.
  */
-static void F_free_all(PParser *parser) {
-
-    unsigned int i;
+static void F_alloc_all(PParser *parser) {
 
-    register P_Frame **stack = (P_Frame **) parser->call.stack;
+    parser->call.capacity = P_INITIAL_STACK_SIZE;
+    parser->call.frames = mem_alloc(P_INITIAL_STACK_SIZE * sizeof(P_Frame));
 
-    for(i = 0; i < P_MAX_RECURSION_DEPTH && is_not_null(stack[i]); ++i) {
-        mem_free(stack[i]);
-        stack[i] = NULL;
+    if(is_null(parser->call.frames)) {
+        mem_error("Unable to allocate parser stack.");
     }
 
     parser->call.frame = -1;
+    parser->call.is_too_deep = 0;
 }
 
 /**
- * Add a branch to a frame's parse tree.
+ * Free all of the parser's stack frames.
+ */
+static void F_free_all(PParser *parser) {
+
+    mem_free(parser->call.frames);
+
+    parser->call.frames = NULL;
+    parser->call.capacity = 0;
+    parser->call.frame = -1;
+}
+
+/**
+ * Add a branch to a parse tree being built by the parser. The tree of a
+ * production with at most one branch is left out unless it is non-excludable.
  */
-static void F_add_branch(P_Frame *frame,
+static void P_add_branch(PParser *parser,
+                         PParseTree *parse_tree,
                          PParseTree *branch_tree,
-                         G_Symbol *symbol) {
+                         unsigned int is_non_excludable,
+                         unsigned int children_must_be_raised) {
 #if PT_ENABLE_TREE_REDUCTIONS
-    unsigned short num_branches = tree_get_num_branches((PTree *) branch_tree);
+    uint32_t num_branches = tree_get_num_branches((PTree *) branch_tree);
 
-    if(!(symbol->is_non_excludable)
+    if(!is_non_excludable
     && num_branches <= 1
     && branch_tree->type == PT_NON_TERMINAL) {
 
@@ -51,41 +127,64 @@ static void F_add_branch(P_Frame *frame,
          * promote that single child node to the place of this
          * production in the tree and ignore that production. */
         if(num_branches == 1) {
-            tree_force_add_branch(
-                (PTree *) frame->parse_tree,
-                tree_get_branch((PTree *) branch_tree, 0)
+            PT_add_branch(
+                &(parser->trees),
+                parse_tree,
+                (PParseTree *) tree_get_branch((PTree *) branch_tree, 0)
             );
         }
 
     /* this node must be added to the tree, has more than one child, or must
      * have its children included in the parse tree. */
     } else {
-        if(symbol->children_must_be_raised) {
-            tree_force_add_branch_children(
-                (PTree *) frame->parse_tree,
-                (PTree *) branch_tree
+        if(children_must_be_raised) {
+            PT_add_branch_children(
+                &(parser->trees),
+                parse_tree,
+                branch_tree
             );
         } else {
-            tree_force_add_branch(
-                (PTree *) frame->parse_tree,
-                (PTree *) branch_tree
+            PT_add_branch(
+                &(parser->trees),
+                parse_tree,
+                branch_tree
             );
         }
     }
 #else
-    tree_force_add_branch(
-        (PTree *) frame->parse_tree,
-        (PTree *) branch_tree
+    PT_add_branch(
+        &(parser->trees),
+        parse_tree,
+        branch_tree
     );
 #endif
     return;
 }
 
+/**
+ * Add a branch to a frame's parse tree.
+ */
+static void F_add_branch(PParser *parser,
+                         P_Frame *frame,
+                         PParseTree *branch_tree,
+                         G_Symbol *symbol) {
+    P_add_branch(
+        parser,
+        frame->parse_tree,
+        branch_tree,
+        symbol->is_non_excludable,
+        symbol->children_must_be_raised
+    );
+}
+
 /**
  * Update the tree of one of the stack frames.
  */
-static void F_record_tree(P_Frame *frame, PParseTree *parse_tree) {
+static void F_record_tree(PParser *parser,
+                          P_Frame *frame,
+                          PParseTree *parse_tree) {
     F_add_branch(
+        parser,
         frame,
         parse_tree,
         G_production_rule_get_symbol(
@@ -96,34 +195,202 @@ static void F_record_tree(P_Frame *frame, PParseTree *parse_tree) {
     );
 }
 
+/**
+ * Get the chunk of the cache table holding the intermediate results for the
+ * token with id 'id'. If that chunk has not yet been allocated and 'allocate'
+ * is not set then NULL is returned, otherwise the chunk is allocated.
+ */
+static P_MemoChunk IR_get_chunk(PParser *parser, uint32_t id, int allocate) {
+
+    uint32_t which_chunk = id >> P_MEMO_CHUNK_BITS,
+             num_chunks = parser->memo.num_chunks;
+
+    if(which_chunk >= num_chunks) {
+
+        if(!allocate) {
+            return NULL;
+        }
+
+        /* grow the chunk directory geometrically */
+        for(num_chunks += !num_chunks; num_chunks <= which_chunk; num_chunks *= 2)
+            ;
+
+        parser->memo.chunks = mem_realloc(
+            parser->memo.chunks,
+            num_chunks * sizeof(P_MemoChunk)
+        );
+
+        if(is_null(parser->memo.chunks)) {
+            mem_error("Unable to grow the intermediate results table.");
+        }
+
+        memset(
+            parser->memo.chunks + parser->memo.num_chunks,
+            0,
+            (num_chunks - parser->memo.num_chunks) * sizeof(P_MemoChunk)
+        );
+
+        parser->memo.num_chunks = num_chunks;
+    }
+
+    if(is_null(parser->memo.chunks[which_chunk]) && allocate) {
+        parser->memo.chunks[which_chunk] = mem_calloc(
+            P_MEMO_CHUNK_SIZE * parser->memo.num_productions,
+            sizeof(P_IntermediateResult *)
+        );
+
+        if(is_null(parser->memo.chunks[which_chunk])) {
+            mem_error("Unable to allocate intermediate results chunk.");
+        }
+    }
+
+    return parser->memo.chunks[which_chunk];
+}
+
+/**
+ * Allocate an initial intermediate result.
+ */
+static P_IntermediateResult *IR_alloc(PParser *parser) {
+
+    P_IntermediateResult *result = arena_malloc(
+        parser->arena,
+        sizeof(P_IntermediateResult)
+    );
+
+    result->end_token = 0;
+    result->farthest_token = 0;
+    result->intermediate_tree = IR_INITIAL;
+    result->uses_indirect_left_recursion = 0;
+    result->is_being_retested = 0;
+    result->is_orphaned = 0;
+    result->is_recorded = 0;
+
+    return result;
+}
+
+/**
+ * Record that a reparse cached or used the intermediate result of 'production'
+ * for the token with id 'id', unless that has already been recorded.
+ */
+static void IR_record(PParser *parser,
+                      P_IntermediateResult *result,
+                      G_NonTerminal production,
+                      uint32_t id) {
+
+    P_ResultKey *key;
+
+    if(result->is_recorded) {
+        return;
+    }
+
+    if(is_null(parser->incremental.recorded)) {
+        parser->incremental.recorded_capacity = P_TOKEN_STORE_SIZE;
+        parser->incremental.recorded = mem_alloc(
+            parser->incremental.recorded_capacity * sizeof(P_ResultKey)
+        );
+
+        if(is_null(parser->incremental.recorded)) {
+            mem_error("Unable to grow the recorded intermediate results.");
+        }
+
+    } else if(parser->incremental.num_recorded
+           >= parser->incremental.recorded_capacity) {
+        parser->incremental.recorded_capacity *= 2;
+        parser->incremental.recorded = mem_realloc(
+            parser->incremental.recorded,
+            parser->incremental.recorded_capacity * sizeof(P_ResultKey)
+        );
+
+        if(is_null(parser->incremental.recorded)) {
+            mem_error("Unable to grow the recorded intermediate results.");
+        }
+    }
+
+    key = parser->incremental.recorded + (parser->incremental.num_recorded)++;
+    key->id = id;
+    key->production = production;
+    result->is_recorded = 1;
+}
+
 /**
  * Create the initial intermediate result.
  */
 static P_IntermediateResult *IR_create(PParser *parser, G_NonTerminal production, uint32_t id) {
 
+    P_MemoChunk chunk = IR_get_chunk(parser, id, 1);
+    uint32_t i = ((id & P_MEMO_CHUNK_MASK) * parser->memo.num_productions)
+               + (uint32_t) production;
+
+    assert(id < parser->tokens.end_id);
+
+    if(is_null(chunk[i])) {
+        chunk[i] = IR_alloc(parser);
+        ++(parser->memo.num_writes[production]);
+    }
+
+    if(parser->incremental.is_reparsing) {
+        IR_record(parser, chunk[i], production, id);
+    }
+
+    return chunk[i];
+}
+
+/**
+ * Create the intermediate result for a frame. The results of productions that
+ * aren't memoized are never put into the cache table and so are released as
+ * soon as the frame is done with them.
+ */
+static P_IntermediateResult *IR_create_for(PParser *parser,
+                                           G_ProductionRule *rule,
+                                           uint32_t id) {
     P_IntermediateResult *result;
-    uint32_t i = ((uint32_t) production * (parser->num_tokens + 1)) + (uint32_t) id;
 
-    assert(id <= parser->num_tokens);
+    if(P_IS_MEMOIZED(parser, rule->production)) {
+        return IR_create(parser, rule->production, id);
+    }
 
-    if(is_null(parser->intermediate_results[i])) {
+    result = IR_alloc(parser);
+    result->is_orphaned = 1;
 
-        result = mem_alloc(sizeof(P_IntermediateResult));
-        if(is_null(result)) {
-            mem_error("Unable to allocate new intermediate result.");
-        }
+    return result;
+}
+
+/**
+ * Skip over the phrases of a frame's production rule, starting with its current
+ * phrase, whose FIRST sets show that they can't match the tokens starting at the
+ * token with id 'id'. The last phrase is never skipped so that failure happens
+ * the usual way.
+ */
+static void F_skip_phrases(PParser *parser, P_Frame *frame, uint32_t id) {
 
-        result->end_token = NULL;
-        result->intermediate_tree = IR_INITIAL;
-        result->uses_indirect_left_recursion = 0;
-        result->is_being_retested = 0;
+    G_ProductionRule *rule = frame->production.rule;
+    G_Terminal terminal = TS_TERMINAL(&(parser->tokens), id);
+    unsigned int phrase = frame->production.phrase;
 
-        parser->intermediate_results[i] = result;
+    while((phrase + 1) < rule->num_phrases
+       && !G_phrase_can_start(parser->grammar, rule->phrases + phrase, terminal)) {
+        ++phrase;
+    }
 
-        return result;
+    frame->production.phrase = (unsigned char) phrase;
+    ((PT_NonTerminal *) frame->parse_tree)->phrase = (unsigned char) phrase;
+}
 
-    } else {
-        return parser->intermediate_results[i];
+/**
+ * Double the number of frames that the parser's stack has room for. The stack
+ * outlives the parse so that later parses can re-use it. Growing the stack
+ * moves the frames, so any pointer to a frame is only good until the next
+ * push.
+ */
+static void F_grow(PParser *parser) {
+    parser->call.capacity *= 2;
+    parser->call.frames = mem_realloc(
+        parser->call.frames,
+        parser->call.capacity * sizeof(P_Frame)
+    );
+
+    if(is_null(parser->call.frames)) {
+        mem_error("Unable to grow parser stack.");
     }
 }
 
@@ -133,29 +400,21 @@ static P_IntermediateResult *IR_create(PParser *parser, G_NonTerminal production
  */
 static P_Frame *F_push(PParser *parser,
                        G_ProductionRule *rule,
-                       PT_Terminal *backtrack_point) {
+                       uint32_t backtrack_point) {
 
     P_Frame *frame;
-    unsigned int i = ++(parser->call.frame);
-
-    /* TODO better error here */
-    if(i >= P_MAX_RECURSION_DEPTH) {
-        std_error("Internal Parse Error: maximum recursion depth exceeded.\n");
-    }
+    unsigned int i = (unsigned int) ++(parser->call.frame);
 
-    /* only allocate a new frame if we need to, otherwise re-use an existing
-     * one. */
-    if(is_null(parser->call.stack[i])) {
-        parser->call.stack[i] = mem_alloc(sizeof(P_Frame));
-        if(is_null(parser->call.stack[i])) {
-            mem_error("Unable to allocate new parser frame.");
-        }
+    /* grow the stack geometrically */
+    if(i >= parser->call.capacity) {
+        F_grow(parser);
     }
 
     /* initialize the frame */
-    frame = parser->call.stack[i];
+    frame = parser->call.frames + i;
 
     frame->backtrack_point = backtrack_point;
+    frame->farthest_token = backtrack_point;
 
     frame->left_recursion.is_direct = 0;
     frame->left_recursion.is_used = 0;
@@ -166,66 +425,210 @@ static P_Frame *F_push(PParser *parser,
     frame->production.rule = rule;
     frame->production.is_committed = 0;
 
+    frame->repetition.symbol = NULL;
+    frame->repetition.has_matched = 0;
+
     frame->parse_tree = (PParseTree *) PT_alloc_non_terminal(
+        &(parser->trees),
         rule->production,
         2 /* TODO: start bigger? */
     );
 
-    PTS_add(parser->tree_set, frame->parse_tree);
+    F_skip_phrases(parser, frame, backtrack_point);
 
-    IR_create(
-        parser,
-        rule->production,
-        backtrack_point->id
-    )->end_token = backtrack_point;
+    P_COUNT(parser, rule->production, P_PROFILE_PUSHES);
+    P_COUNT_PHRASE(parser, phrase_attempts, rule, frame->production.phrase);
+    P_COUNT_DEPTH(parser, i + 1);
+
+    frame->result = IR_create_for(parser, rule, backtrack_point);
+
+    frame->result->end_token = backtrack_point;
 
     return frame;
 }
 
+/**
+ * Move a frame on to the next symbol of its phrase once its current symbol has
+ * been matched, leaving the frame's position in the token stream at 'token'.
+ * A repeated non-terminal is instead tried again, unless it matched without
+ * consuming any tokens, as it would then match the same way forever.
+ */
+static void F_advance(P_Frame *frame, uint32_t token) {
+
+    if(is_not_null(frame->repetition.symbol)
+    && frame->repetition.symbol->is_repeated
+    && token > frame->repetition.token) {
+        frame->repetition.has_matched = 1;
+        return;
+    }
+
+    ++(frame->production.symbol);
+    frame->repetition.symbol = NULL;
+    frame->repetition.has_matched = 0;
+}
+
+/**
+ * Pass on how far into the token stream a frame that is being popped has looked
+ * to its result and to the frame that called it.
+ */
+static void F_pop_farthest(P_Frame *frame, P_Frame *caller) {
+    F_EXAMINE(frame->result, frame->farthest_token);
+    F_EXAMINE(caller, frame->farthest_token);
+}
+
 /* -------------------------------------------------------------------------- */
 
 /**
- * Free the intermediate results table.
+ * Allocate an empty intermediate results table. No chunks are allocated until
+ * they are needed.
+ */
+static void IR_alloc_all(PParser *parser) {
+
+    parser->memo.num_productions = 0;
+    parser->memo.num_writes = NULL;
+    parser->memo.num_hits = NULL;
+    parser->memo.is_memoized = NULL;
+    parser->memo.num_chunks = 1;
+    parser->memo.chunks = mem_calloc(
+        parser->memo.num_chunks,
+        sizeof(P_MemoChunk)
+    );
+
+    if(is_null(parser->memo.chunks)) {
+        mem_error("Unable to allocate the intermediate results table.");
+    }
+}
+
+/**
+ * Empty the intermediate results table so that it can be used to parse with
+ * 'grammar'. Chunks left over from a previous parse are cleared and kept unless
+ * the grammar has a different number of productions, in which case they are
+ * the wrong size and are freed. The intermediate results themselves are freed
+ * along with the parser's arena. The memoization profile and policy are kept as
+ * long as the grammar doesn't change; a new grammar starts with its own policy.
  */
-static void IR_free_all(PParser *parser, PGrammar *grammar) {
+static void IR_reset(PParser *parser, PGrammar *grammar) {
+
+    register uint32_t i;
+
+    uint32_t i_max = parser->memo.num_chunks,
+             num_words = (grammar->num_productions >> 5) + 1;
+
+    size_t chunk_size = (
+        P_MEMO_CHUNK_SIZE * parser->memo.num_productions
+      * sizeof(P_IntermediateResult *)
+    );
+
+    int keep_chunks = (parser->memo.num_productions == grammar->num_productions);
+
+    if(grammar != parser->grammar || !keep_chunks) {
+        if(is_not_null(parser->memo.num_writes)) {
+            mem_free(parser->memo.num_writes);
+            mem_free(parser->memo.num_hits);
+            mem_free(parser->memo.is_memoized);
+        }
 
-    register uint32_t i,
-                      j;
+        parser->memo.num_writes = mem_calloc(
+            grammar->num_productions + 1,
+            sizeof(uint32_t)
+        );
+        parser->memo.num_hits = mem_calloc(
+            grammar->num_productions + 1,
+            sizeof(uint32_t)
+        );
 
-    uint32_t i_max = grammar->num_productions,
-             j_max = parser->num_tokens+1,
-             k;
+        parser->memo.is_memoized = mem_calloc(num_words, sizeof(uint32_t));
+
+        if(is_null(parser->memo.num_writes)
+        || is_null(parser->memo.num_hits)
+        || is_null(parser->memo.is_memoized)) {
+            mem_error("Unable to allocate the memoization profile.");
+        }
 
-    register P_IntermediateResult **results = parser->intermediate_results;
+        for(i = 0; i < grammar->num_productions; ++i) {
+            if(grammar->production_rules[i].is_memoized) {
+                parser->memo.is_memoized[i >> 5] |= ((uint32_t) 1) << (i & 31);
+            }
+        }
+    }
 
     for(i = 0; i < i_max; ++i) {
-        k = i * j_max;
-        for(j = 0; j < j_max; ++j) {
-            if(is_not_null(results[k + j])) {
-                mem_free(results[k + j]);
+        if(is_not_null(parser->memo.chunks[i])) {
+            if(keep_chunks) {
+                memset(parser->memo.chunks[i], 0, chunk_size);
+            } else {
+                mem_free(parser->memo.chunks[i]);
+                parser->memo.chunks[i] = NULL;
             }
         }
     }
 
-    mem_free(results);
+    parser->memo.num_productions = grammar->num_productions;
+}
+
+/**
+ * Free the intermediate results table. The intermediate results themselves are
+ * freed along with the parser's arena.
+ */
+static void IR_free_all(PParser *parser) {
+
+    register uint32_t i;
+
+    uint32_t i_max = parser->memo.num_chunks;
+
+    for(i = 0; i < i_max; ++i) {
+        if(is_not_null(parser->memo.chunks[i])) {
+            mem_free(parser->memo.chunks[i]);
+        }
+    }
+
+    mem_free(parser->memo.chunks);
+
+    if(is_not_null(parser->memo.num_writes)) {
+        mem_free(parser->memo.num_writes);
+        mem_free(parser->memo.num_hits);
+        mem_free(parser->memo.is_memoized);
+    }
 
-    parser->intermediate_results = NULL;
-    parser->num_tokens = 0;
+    parser->memo.chunks = NULL;
+    parser->memo.num_chunks = 0;
+    parser->memo.num_writes = NULL;
+    parser->memo.num_hits = NULL;
+    parser->memo.is_memoized = NULL;
 }
 
 /**
- * Get an intermediate result.
+ * Get an intermediate result. If the production has not yet been applied at
+ * the token then NULL is returned.
  */
 static P_IntermediateResult *IR_get(PParser *parser,
                                     G_NonTerminal production,
                                     uint32_t id) {
-    assert(id <= parser->num_tokens);
+    P_MemoChunk chunk;
+    P_IntermediateResult *result;
+
+    assert(id < parser->tokens.end_id);
 
     D( printf("intermediate result for production %d, token %d \n", (int) production, (int) id); )
 
-    return ((parser->intermediate_results)
-        [((uint32_t) production * (parser->num_tokens + 1)) + (uint32_t) id]
-    );
+    chunk = IR_get_chunk(parser, id, 0);
+    if(is_null(chunk)) {
+        return NULL;
+    }
+
+    result = chunk[
+        ((id & P_MEMO_CHUNK_MASK) * parser->memo.num_productions)
+      + (uint32_t) production
+    ];
+
+    /* a placeholder for a production that is still being applied isn't a
+     * result that was re-used, it only means that the production is left
+     * recursive. */
+    if(is_not_null(result) && IR_INITIAL != result->intermediate_tree) {
+        ++(parser->memo.num_hits[production]);
+    }
+
+    return result;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -238,12 +641,12 @@ static void LR_mark_origin(PParser *parser, P_IntermediateResult *result) {
 
     int i = parser->call.frame;
 
-    P_Frame *top = parser->call.stack[i],
+    P_Frame *top = parser->call.frames + i,
             *origin = NULL;
 
     for(; i > 0; ) {
 
-        origin = parser->call.stack[--i];
+        origin = parser->call.frames + (--i);
 
         if(origin->production.rule->production
         == top->production.rule->production) {
@@ -268,732 +671,3390 @@ static void LR_mark_origin(PParser *parser, P_IntermediateResult *result) {
 /* -------------------------------------------------------------------------- */
 
 /**
- * Return a linked list of all tokens in the current file being parsed.
+ * Resize one of the arrays of the token store.
  */
-static PT_Terminal *P_alloc_terminals(PScanner *scanner,
-                                      PScannerFunc *scanner_fnc,
-                                      PT_Set *tree_set) {
+static void *TS_resize(void *array, uint32_t num_elements, size_t size) {
+    array = mem_realloc(array, num_elements * size);
+    if(is_null(array)) {
+        mem_error("Unable to grow the token store.");
+    }
+    return array;
+}
 
-    PT_Terminal *curr = NULL,
-                *prev = NULL,
-                *first = NULL;
+/**
+ * Allocate the arrays of an empty token store.
+ */
+static void TS_alloc(P_TokenStore *store) {
+
+    store->first_id = 0;
+    store->end_id = 0;
+    store->capacity = P_TOKEN_STORE_SIZE;
+    store->lexemes_size = 0;
+    store->lexemes_capacity = P_TOKEN_STORE_SIZE * 8;
+    store->input = NULL;
+    store->gap_start = P_TOKEN_NONE;
+    store->gap_length = 0;
+    store->input_length = 0;
+    store->handles = NULL;
+    store->slots = NULL;
+    store->num_handles = 0;
+    store->free_handle = P_TOKEN_NONE;
+
+    store->terminals = mem_alloc(P_TOKEN_STORE_SIZE * sizeof(G_Terminal));
+    store->lexeme_lengths = mem_alloc(P_TOKEN_STORE_SIZE * sizeof(uint32_t));
+    store->lexeme_offsets = mem_alloc(P_TOKEN_STORE_SIZE * sizeof(uint32_t));
+    store->input_offsets = mem_alloc(P_TOKEN_STORE_SIZE * sizeof(uint32_t));
+    store->lexemes = mem_alloc(store->lexemes_capacity * sizeof(char));
+
+    if(is_null(store->terminals)
+    || is_null(store->lexeme_lengths)
+    || is_null(store->lexeme_offsets)
+    || is_null(store->input_offsets)
+    || is_null(store->lexemes)) {
+        mem_error("Unable to allocate the token store.");
+    }
+}
 
-    G_Terminal term;
+/**
+ * Empty a token store, keeping its arrays.
+ */
+static void TS_reset(P_TokenStore *store) {
+    store->first_id = 0;
+    store->end_id = 0;
+    store->lexemes_size = 0;
+    store->input = NULL;
+    store->gap_start = P_TOKEN_NONE;
+    store->gap_length = 0;
+    store->input_length = 0;
+    store->num_handles = 0;
+    store->free_handle = P_TOKEN_NONE;
+}
 
-    unsigned int id = 0;
+/**
+ * Free the arrays of a token store.
+ */
+static void TS_free(P_TokenStore *store) {
+    mem_free(store->terminals);
+    mem_free(store->lexeme_lengths);
+    mem_free(store->lexeme_offsets);
+    mem_free(store->input_offsets);
+    mem_free(store->lexemes);
+
+    if(is_not_null(store->handles)) {
+        mem_free(store->handles);
+        mem_free(store->slots);
+    }
+}
 
-    assert_not_null(scanner);
+/**
+ * Grow the arrays of a token store so that it has room for 'capacity' tokens.
+ */
+static void TS_grow(P_TokenStore *store, uint32_t capacity) {
 
-    /* bring the entire token stream into memory */
-    while((term = scanner_fnc(scanner)) >= 0) {
+    store->capacity = capacity;
+    store->terminals = TS_resize(
+        store->terminals, capacity, sizeof(G_Terminal)
+    );
+    store->lexeme_lengths = TS_resize(
+        store->lexeme_lengths, capacity, sizeof(uint32_t)
+    );
+    store->lexeme_offsets = TS_resize(
+        store->lexeme_offsets, capacity, sizeof(uint32_t)
+    );
+    store->input_offsets = TS_resize(
+        store->input_offsets, capacity, sizeof(uint32_t)
+    );
 
-        curr = PT_alloc_terminal(
-            term,
-            scanner_get_lexeme(scanner),
-            scanner->lexeme.line,
-            scanner->lexeme.column,
-            id
+    if(is_not_null(store->handles)) {
+        store->handles = TS_resize(store->handles, capacity, sizeof(uint32_t));
+        store->slots = TS_resize(store->slots, capacity, sizeof(uint32_t));
+    }
+}
+
+/**
+ * Put a token into the slot at index 'i' of a token store. If the lexeme is
+ * already at the token's offset into the store's input then it is referred to
+ * there instead of being copied.
+ */
+static void TS_put(P_TokenStore *store,
+                   uint32_t i,
+                   G_Terminal terminal,
+                   const unsigned char *lexeme,
+                   uint32_t lexeme_length,
+                   uint32_t input_offset) {
+
+    store->terminals[i] = terminal;
+    store->lexeme_lengths[i] = lexeme_length;
+    store->lexeme_offsets[i] = store->lexemes_size;
+    store->input_offsets[i] = input_offset;
+
+    if(is_not_null(store->input) && lexeme == store->input + input_offset) {
+        store->lexeme_offsets[i] |= P_LEXEME_IN_INPUT;
+        return;
+    }
+
+    /* make room for the lexeme and its null character */
+    while(store->lexemes_size + lexeme_length + 1 > store->lexemes_capacity) {
+        store->lexemes_capacity *= 2;
+        store->lexemes = TS_resize(
+            store->lexemes, store->lexemes_capacity, sizeof(char)
         );
+    }
+
+    memcpy(store->lexemes + store->lexemes_size, lexeme, lexeme_length);
+    store->lexemes_size += lexeme_length;
+    store->lexemes[(store->lexemes_size)++] = 0;
+}
 
-        PTS_add(tree_set, (PParseTree *) curr);
+/**
+ * Add a token to the end of the token store and return its id.
+ */
+static uint32_t TS_push(P_TokenStore *store,
+                        G_Terminal terminal,
+                        const unsigned char *lexeme,
+                        uint32_t lexeme_length,
+                        uint32_t input_offset) {
 
-        if(is_not_null(prev)) {
-            prev->next = curr;
-        } else {
-            first = curr;
-        }
+    uint32_t i = store->end_id - store->first_id;
 
-        ++id;
-        prev = curr;
+    if(i >= store->capacity) {
+        TS_grow(store, store->capacity * 2);
     }
 
-    /* add in the end-of-stream token */
-    curr = PT_alloc_terminal(-1, string_alloc_char("EOF", 3), 0, 0, id);
-    curr->next = NULL;
-    PTS_add(tree_set, (PParseTree *) curr);
+    TS_put(store, i, terminal, lexeme, lexeme_length, input_offset);
+
+    return (store->end_id)++;
+}
 
-    if(is_not_null(prev)) {
-        prev->next = curr;
+/**
+ * Remove all tokens with ids before 'id' from the token store, shifting the
+ * remaining tokens and their lexemes to the front of the store.
+ */
+static void TS_evict(P_TokenStore *store, uint32_t id) {
+
+    uint32_t i,
+             num_evicted = id - store->first_id,
+             num_remaining = store->end_id - id,
+             lexeme_shift;
+
+    if(0 == num_evicted) {
+        return;
     }
 
-    if(is_null(first)) {
-        return curr;
+    lexeme_shift = num_remaining ? store->lexeme_offsets[num_evicted]
+                                 : store->lexemes_size;
+    lexeme_shift &= ~P_LEXEME_IN_INPUT;
+
+    memmove(
+        store->terminals,
+        store->terminals + num_evicted,
+        num_remaining * sizeof(G_Terminal)
+    );
+    memmove(
+        store->lexeme_lengths,
+        store->lexeme_lengths + num_evicted,
+        num_remaining * sizeof(uint32_t)
+    );
+    memmove(
+        store->input_offsets,
+        store->input_offsets + num_evicted,
+        num_remaining * sizeof(uint32_t)
+    );
+
+    for(i = 0; i < num_remaining; ++i) {
+        store->lexeme_offsets[i] = (
+            store->lexeme_offsets[i + num_evicted] - lexeme_shift
+        );
     }
 
-    return first;
+    memmove(
+        store->lexemes,
+        store->lexemes + lexeme_shift,
+        store->lexemes_size - lexeme_shift
+    );
+
+    store->lexemes_size -= lexeme_shift;
+    store->first_id = id;
 }
 
-/* -------------------------------------------------------------------------- */
+/**
+ * Return the lexeme of the token at index 'i' of a token store.
+ */
+static const unsigned char *TS_lexeme(P_TokenStore *store, uint32_t i) {
+    if(store->lexeme_offsets[i] & P_LEXEME_IN_INPUT) {
+        return store->input + TS_INPUT_OFFSET(store, i);
+    }
+    return (const unsigned char *) (store->lexemes + store->lexeme_offsets[i]);
+}
 
-static void P_perform_grammar_actions(PGrammar *grammar,
-                                      PParseTree *tree,
-                                      void *state) {
-    PTreeGenerator *gen = NULL;
-    PT_NonTerminal *non_terminal;
-    G_ActionRules *action = grammar->actions;
-    PTreeTraversalType traversal_type,
-                       prev_traversal_type = -1;
-    PParseTree *curr;
+/**
+ * Add a copy of the token at index 'i' of the token store 'source' to the end
+ * of a token store, giving it a new input offset, and return its id.
+ */
+static uint32_t TS_push_copy(P_TokenStore *store,
+                             P_TokenStore *source,
+                             uint32_t i,
+                             uint32_t input_offset) {
+    return TS_push(
+        store,
+        source->terminals[i],
+        TS_lexeme(source, i),
+        source->lexeme_lengths[i],
+        input_offset
+    );
+}
 
-    /* execute the action passes in sequence */
-    for(; is_not_null(action); action = action->next) {
+/**
+ * Give each token of a token store its own handle, and give the store a gap of
+ * no slots after its last token.
+ */
+static void TS_alloc_handles(P_TokenStore *store) {
 
-        /* if this is a simple state action then run it, otherwise fall through
-         * to perform a tree traversal. */
-        if(action->type == G_STATE_ACTION) {
-            action->action.func(state);
-            continue;
+    uint32_t i;
+
+    if(is_null(store->handles)) {
+        store->handles = mem_alloc(store->capacity * sizeof(uint32_t));
+        store->slots = mem_alloc(store->capacity * sizeof(uint32_t));
+
+        if(is_null(store->handles) || is_null(store->slots)) {
+            mem_error("Unable to allocate the token store.");
         }
+    }
 
-        traversal_type = action->action.rule.traversal_type;
+    for(i = 0; i < store->end_id; ++i) {
+        store->handles[i] = i;
+        store->slots[i] = i;
+    }
 
-        /* re-use or allocate a new tree generator */
-        if(traversal_type == prev_traversal_type && is_not_null(gen)) {
-            tree_generator_reuse(gen, (PTree *) tree);
-        } else {
+    store->num_handles = store->end_id;
+    store->free_handle = P_TOKEN_NONE;
+    store->gap_start = store->end_id;
+    store->gap_length = 0;
+}
+
+/**
+ * Give the token in slot 'i' of a token store a handle that isn't in use.
+ */
+static void TS_new_handle(P_TokenStore *store, uint32_t i) {
+
+    uint32_t handle = store->free_handle;
+
+    if(P_TOKEN_NONE != handle) {
+        store->free_handle = store->slots[handle];
+    } else {
+        handle = (store->num_handles)++;
+    }
+
+    store->handles[i] = handle;
+    store->slots[handle] = i;
+}
+
+/**
+ * Let the handle of the token in slot 'i' of a token store be used again.
+ */
+static void TS_free_handle(P_TokenStore *store, uint32_t i) {
+    store->slots[store->handles[i]] = store->free_handle;
+    store->free_handle = store->handles[i];
+}
+
+/**
+ * Add the scanner's current lexeme as a token with the terminal 'term' to the
+ * end of a token store and return its id. 'base_offset' is the offset of the
+ * scanner's input into the whole input.
+ */
+static uint32_t TS_push_lexeme(P_TokenStore *store,
+                               G_Terminal term,
+                               PScanner *scanner,
+                               uint32_t base_offset) {
+
+    const unsigned char *lexeme = scanner_get_lexeme_text(scanner);
+
+    if(is_null(lexeme)) {
+        lexeme = scanner->lexeme.start;
+    }
+
+    return TS_push(
+        store,
+        term,
+        lexeme,
+        scanner->lexeme.end > scanner->lexeme.start
+            ? (uint32_t) (scanner->lexeme.end - scanner->lexeme.start)
+            : 0,
+        base_offset + scanner_get_lexeme_offset(scanner)
+    );
+}
+
+/**
+ * Pull the next token from the scanner into the token store. Once the scanner
+ * runs out of tokens an end-of-stream token is added. If the tokens were
+ * scanned ahead of time then the next one is copied out of their store instead.
+ */
+static uint32_t P_pull_terminal(PParser *parser) {
+
+    G_Terminal term;
+
+    PScanner *scanner = parser->scanner;
+    P_TokenStore *source = parser->prescanned.tokens;
+    uint32_t i;
+
+    if(is_not_null(source)) {
+        if(parser->prescanned.next_id < parser->prescanned.end_id) {
+            i = (parser->prescanned.next_id)++ - source->first_id;
+            return TS_push_copy(
+                &(parser->tokens),
+                source,
+                i,
+                source->input_offsets[i]
+            );
+        }
+
+    } else {
+
+        assert_not_null(scanner);
+
+        if((term = parser->scanner_fnc(scanner)) >= 0) {
+            return TS_push_lexeme(&(parser->tokens), term, scanner, 0);
+        }
+    }
+
+    /* add in the end-of-stream token */
+    return TS_push(
+        &(parser->tokens),
+        -1,
+        (const unsigned char *) "EOF",
+        3,
+        is_null(scanner) ? 0 : scanner->input.num_read
+    );
+}
+
+/**
+ * Get the id of the token following the token with id 'id', pulling it from
+ * the scanner if it hasn't been seen yet. The end-of-stream token is never
+ * advanced past. The ids of the tokens of an incremental parse skip over the
+ * gap in their store.
+ */
+static uint32_t P_next_terminal(PParser *parser, uint32_t id) {
+    if(++id == parser->tokens.gap_start) {
+        id += parser->tokens.gap_length;
+    }
+    if(id == parser->tokens.end_id) {
+        P_pull_terminal(parser);
+    }
+    return id;
+}
+
+/**
+ * Make a parse tree for the token with id 'id' so that it can be added to a
+ * frame's parse tree. The token store only keeps the offset of each token into
+ * the scanner's input; a token's line and column are found from it here, as
+ * they are only needed by the tokens that end up in parse trees.
+ *
+ * The tree of a token of an incremental parse instead keeps the token's handle,
+ * as the token can be moved by later edits, and its id and position are filled
+ * in by P_update_terminals. Its lexeme is always copied, as the text that the
+ * lexeme is in is changed by those edits.
+ */
+static PParseTree *P_alloc_terminal_tree(PParser *parser, uint32_t id) {
+
+    P_TokenStore *store = &(parser->tokens);
+    PT_Terminal *tree;
+    uint32_t i = id - store->first_id,
+             line = 0,
+             column = 0;
+
+    assert(id >= store->first_id && id < store->end_id);
+
+    if(is_not_null(parser->scanner) && !parser->incremental.is_enabled) {
+        scanner_get_position(
+            parser->scanner,
+            store->input_offsets[i],
+            &line,
+            &column
+        );
+    }
+
+    tree = PT_alloc_terminal(
+        &(parser->trees),
+        store->terminals[i],
+        store->lexeme_lengths[i] > 0
+            ? (const char *) TS_lexeme(store, i)
+            : NULL,
+        store->lexeme_lengths[i],
+        0 != (store->lexeme_offsets[i] & P_LEXEME_IN_INPUT)
+            && !parser->incremental.is_enabled,
+        line,
+        column,
+        id + parser->prescanned.id_offset
+    );
+
+    if(parser->incremental.is_enabled) {
+        tree->token = store->handles[i];
+    }
+
+    return (PParseTree *) tree;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Release an intermediate result that has been evicted from the cache table
+ * once the frame that owns it is done with it.
+ */
+static void IR_release(PParser *parser, P_IntermediateResult *result) {
+    if(result->is_orphaned) {
+        arena_release(parser->arena, result, sizeof(P_IntermediateResult));
+    }
+}
+
+/**
+ * Remove the intermediate results for all tokens with ids in the range
+ * [first_id, id) from the cache table. Results that have been orphaned by
+ * their stack frames are left for those frames to release.
+ */
+static void IR_evict(PParser *parser, uint32_t first_id, uint32_t id) {
+
+    register uint32_t j;
+
+    uint32_t i,
+             j_min,
+             j_max,
+             num_productions = parser->memo.num_productions;
+
+    register P_IntermediateResult **results;
+
+    for(i = first_id >> P_MEMO_CHUNK_BITS;
+        i <= (id >> P_MEMO_CHUNK_BITS) && i < parser->memo.num_chunks;
+        ++i) {
+
+        results = parser->memo.chunks[i];
+        if(is_null(results)) {
+            continue;
+        }
+
+        j_min = 0;
+        j_max = P_MEMO_CHUNK_SIZE * num_productions;
+
+        if(i == (first_id >> P_MEMO_CHUNK_BITS)) {
+            j_min = (first_id & P_MEMO_CHUNK_MASK) * num_productions;
+        }
+
+        if(i == (id >> P_MEMO_CHUNK_BITS)) {
+            j_max = (id & P_MEMO_CHUNK_MASK) * num_productions;
+        }
+
+        for(j = j_min; j < j_max; ++j) {
+            if(is_not_null(results[j])) {
+                if(!results[j]->is_orphaned) {
+                    arena_release(
+                        parser->arena,
+                        results[j],
+                        sizeof(P_IntermediateResult)
+                    );
+                }
+                results[j] = NULL;
+            }
+        }
+
+        /* the chunk is entirely before the token with id 'id' */
+        if(i < (id >> P_MEMO_CHUNK_BITS)) {
+            mem_free(results);
+            parser->memo.chunks[i] = NULL;
+        }
+    }
+}
+
+/**
+ * Mark all trees held by the intermediate results for tokens with ids starting
+ * at 'id'.
+ */
+static void IR_mark(PParser *parser, uint32_t id) {
+
+    register uint32_t j;
+
+    uint32_t i,
+             j_max = P_MEMO_CHUNK_SIZE * parser->memo.num_productions;
+
+    register P_IntermediateResult **results;
+
+    PParseTree *tree;
+
+    for(i = id >> P_MEMO_CHUNK_BITS; i < parser->memo.num_chunks; ++i) {
+
+        results = parser->memo.chunks[i];
+        if(is_null(results)) {
+            continue;
+        }
+
+        j = 0;
+        if(i == (id >> P_MEMO_CHUNK_BITS)) {
+            j = (id & P_MEMO_CHUNK_MASK) * parser->memo.num_productions;
+        }
+
+        for(; j < j_max; ++j) {
+            if(is_null(results[j])) {
+                continue;
+            }
+
+            tree = results[j]->intermediate_tree;
+            if(tree != IR_FAILED && tree != IR_INITIAL) {
+                PTH_mark(&(parser->trees), tree);
+            }
+        }
+    }
+}
+
+/**
+ * Once every frame on the stack has either committed to its current phrase or
+ * has no phrases left to try, no backtrack can return to a token before the
+ * current one, 'cut'. When that happens, free the cached results, tokens and
+ * abandoned trees before the cut so that memory is bounded by the distance
+ * between cuts rather than by the size of the input.
+ *
+ * The trees of the frames on the stack will end up in the final parse tree
+ * and so they are moved into the retained set. Frames below
+ * parser->call.num_retained have already been dealt with by a previous
+ * eviction and have not changed since.
+ */
+static void P_evict(PParser *parser, uint32_t cut) {
+
+    P_Frame *frame;
+
+    int i;
+
+    /* a failed attempt at matching a repeated or optional symbol returns to
+     * where the attempt started, even if a cut was passed during it. those
+     * frames can have been retained by an earlier eviction. */
+    for(i = parser->call.frame; i >= 0; --i) {
+        frame = parser->call.frames + i;
+        if(is_not_null(frame->repetition.symbol)
+        && frame->repetition.token < cut) {
+            cut = frame->repetition.token;
+        }
+    }
+
+    /* don't bother evicting less than a chunk's worth of tokens. the cached
+     * results of an incremental parse are kept for the next reparse. */
+    if((cut - parser->tokens.first_id) < P_MEMO_CHUNK_SIZE
+    || parser->incremental.is_enabled) {
+        return;
+    }
+
+    /* make sure that nothing can backtrack to before the cut. left recursion
+     * can re-start frames at their backtrack points. */
+    for(i = parser->call.frame; i >= parser->call.num_retained; --i) {
+        frame = parser->call.frames + i;
+
+        if(frame->left_recursion.is_used
+        || frame->result->uses_indirect_left_recursion
+        || frame->result->is_being_retested) {
+            return;
+        }
+
+        if(!frame->production.is_committed
+        && G_production_rule_has_phrase(
+            frame->production.rule,
+            frame->production.phrase + 1
+        )) {
+            return;
+        }
+    }
+
+    D( printf("evicting tokens [%d, %d). \n", parser->tokens.first_id, cut); )
+
+    for(i = parser->call.num_retained; i <= parser->call.frame; ++i) {
+        frame = parser->call.frames + i;
+
+        PTH_retain(&(parser->trees), frame->parse_tree);
+
+        /* the frame's result is about to be evicted, so the frame takes
+         * ownership of it. */
+        if(frame->backtrack_point < cut) {
+            frame->result->is_orphaned = 1;
+            parser->call.num_retained = i + 1;
+        }
+    }
+
+    IR_evict(parser, parser->tokens.first_id, cut);
+    TS_evict(&(parser->tokens), cut);
+
+    /* release every tree that can't be reached from the stack or from the
+     * remaining cached results. */
+    IR_mark(parser, cut);
+    PTH_sweep(&(parser->trees));
+}
+
+/* -------------------------------------------------------------------------- */
+
+static void P_perform_grammar_actions(PGrammar *grammar,
+                                      PParseTree *tree,
+                                      void *state) {
+    PTreeGenerator *gen = NULL;
+    PT_NonTerminal *non_terminal;
+    G_ActionRules *action = grammar->actions;
+    PTreeTraversalType traversal_type,
+                       prev_traversal_type = -1;
+    PParseTree *curr;
+
+    /* execute the action passes in sequence */
+    for(; is_not_null(action); action = action->next) {
+
+        /* if this is a simple state action then run it, otherwise fall through
+         * to perform a tree traversal. */
+        if(action->type == G_STATE_ACTION) {
+            action->action.func(state);
+            continue;
+        }
+
+        traversal_type = action->action.rule.traversal_type;
+
+        /* re-use or allocate a new tree generator */
+        if(traversal_type == prev_traversal_type && is_not_null(gen)) {
+            tree_generator_reuse(gen, (PTree *) tree);
+        } else {
             if(is_not_null(gen)) {
                 generator_free(gen);
             }
             gen = tree_generator_alloc((PTree *) tree, traversal_type);
         }
 
-        /* go and apply the specific action function to this non-terminal
-         * node. */
-        while(generator_next(gen)) {
-            curr = generator_current(gen);
-            if(curr->type == PT_NON_TERMINAL) {
-                non_terminal = (PT_NonTerminal *) curr;
-                action->action.rule.funcs[non_terminal->production](
-                    state,
-                    non_terminal->phrase,
-                    tree_get_num_branches((PTree *) non_terminal),
-                    (PParseTree **) (((PTree *) non_terminal)->_branches)
-                );
-            }
+        /* go and apply the specific action function to this non-terminal
+         * node. */
+        while(generator_next(gen)) {
+            curr = generator_current(gen);
+            if(curr->type == PT_NON_TERMINAL) {
+                non_terminal = (PT_NonTerminal *) curr;
+                action->action.rule.funcs[non_terminal->production](
+                    state,
+                    non_terminal->phrase,
+                    tree_get_num_branches((PTree *) non_terminal),
+                    (PParseTree **) (((PTree *) non_terminal)->_branches)
+                );
+            }
+        }
+    }
+
+    if(is_not_null(gen)) {
+        generator_free(gen);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Allocate a new parser context. A context can be used for any number of
+ * parses, one at a time, and holds onto its memory between them.
+ */
+PParser *parser_alloc(void) {
+
+    PParser *parser = mem_alloc(sizeof(PParser));
+    if(is_null(parser)) {
+        mem_error("Unable to allocate parser.");
+    }
+
+    parser->arena = arena_alloc();
+    PTH_init(&(parser->trees), parser->arena);
+
+    TS_alloc(&(parser->tokens));
+
+    /* allocate the (initially empty) cache table */
+    IR_alloc_all(parser);
+
+    /* allocate the (initially empty) frame stack */
+    F_alloc_all(parser);
+
+    parser->scanner = NULL;
+    parser->scanner_fnc = NULL;
+    parser->prescanned.tokens = NULL;
+    parser->prescanned.id_offset = 0;
+    parser->grammar = NULL;
+    parser->farthest_id_reached = 0;
+    parser->call.frame = -1;
+    parser->call.num_retained = 0;
+    parser->must_backtrack = 0;
+
+    parser->incremental.text = NULL;
+    parser->incremental.length = 0;
+    parser->incremental.scanner = NULL;
+    parser->incremental.parse_tree = NULL;
+    parser->incremental.recorded = NULL;
+    parser->incremental.num_recorded = 0;
+    parser->incremental.recorded_capacity = 0;
+    parser->incremental.reach = NULL;
+    parser->incremental.num_reach = 0;
+    parser->incremental.num_live_trees = 0;
+    parser->incremental.is_enabled = 0;
+    parser->incremental.is_reparsing = 0;
+
+    parser->profile.productions = NULL;
+    parser->profile.phrase_attempts = NULL;
+    parser->profile.phrase_backtracks = NULL;
+    parser->profile.num_productions = 0;
+    parser->profile.num_phrases = 0;
+    parser->profile.max_depth = 0;
+    parser->profile.is_enabled = 0;
+
+    return parser;
+}
+
+/**
+ * Free a parser context along with everything it holds onto.
+ */
+void parser_free(PParser *parser) {
+
+    assert_not_null(parser);
+
+    D( printf("freeing resources... \n"); )
+
+    IR_free_all(parser);
+    TS_free(&(parser->tokens));
+    arena_free(parser->arena);
+    F_free_all(parser);
+
+    if(is_not_null(parser->incremental.text)) {
+        mem_free(parser->incremental.text);
+    }
+
+    if(is_not_null(parser->incremental.scanner)) {
+        scanner_free(parser->incremental.scanner);
+    }
+
+    if(is_not_null(parser->incremental.recorded)) {
+        mem_free(parser->incremental.recorded);
+    }
+
+    if(is_not_null(parser->incremental.reach)) {
+        mem_free(parser->incremental.reach);
+    }
+
+    if(is_not_null(parser->profile.productions)) {
+        mem_free(parser->profile.productions);
+        mem_free(parser->profile.phrase_attempts);
+        mem_free(parser->profile.phrase_backtracks);
+    }
+
+    mem_free(parser);
+}
+
+/**
+ * Stop memoizing the productions of 'grammar' whose cached results were never
+ * used by any of the parses done with this parser context since it started
+ * parsing with the grammar. Left-recursive productions are always memoized.
+ * The policy is kept by the parser context, so the grammar itself, and other
+ * parser contexts sharing it, are left alone.
+ */
+void parser_tune_memoization(PParser *parser, PGrammar *grammar) {
+
+    unsigned short i;
+    G_ProductionRule *rule;
+
+    assert_not_null(parser);
+    assert_not_null(grammar);
+
+    if(grammar != parser->grammar
+    || is_null(parser->memo.num_writes)) {
+        return;
+    }
+
+    for(i = 0; i < grammar->num_productions; ++i) {
+        rule = grammar->production_rules + i;
+
+        if(!rule->is_left_recursive
+        && parser->memo.num_writes[i] > 0
+        && 0 == parser->memo.num_hits[i]) {
+            D( printf("no longer memoizing production %d. \n", i); )
+            parser->memo.is_memoized[i >> 5] &= ~(((uint32_t) 1) << (i & 31));
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Clear the counters of a profiling parser so that they count the next parse
+ * with 'grammar'. The counters are re-allocated if the grammar is not the same
+ * size as the last one.
+ */
+static void P_reset_profile(PParser *parser, PGrammar *grammar) {
+
+    if(!parser->profile.is_enabled) {
+        return;
+    }
+
+    if(parser->profile.num_productions != grammar->num_productions
+    || parser->profile.num_phrases != grammar->num_phrases
+    || is_null(parser->profile.productions)) {
+
+        if(is_not_null(parser->profile.productions)) {
+            mem_free(parser->profile.productions);
+            mem_free(parser->profile.phrase_attempts);
+            mem_free(parser->profile.phrase_backtracks);
+        }
+
+        parser->profile.num_productions = grammar->num_productions;
+        parser->profile.num_phrases = grammar->num_phrases;
+
+        parser->profile.productions = mem_alloc(
+            (grammar->num_productions + 1)
+          * sizeof(*(parser->profile.productions))
+        );
+        parser->profile.phrase_attempts = mem_alloc(
+            (grammar->num_phrases + 1) * sizeof(uint32_t)
+        );
+        parser->profile.phrase_backtracks = mem_alloc(
+            (grammar->num_phrases + 1) * sizeof(uint32_t)
+        );
+
+        if(is_null(parser->profile.productions)
+        || is_null(parser->profile.phrase_attempts)
+        || is_null(parser->profile.phrase_backtracks)) {
+            mem_error("Unable to allocate the parser profile.");
+        }
+    }
+
+    memset(
+        parser->profile.productions,
+        0,
+        (grammar->num_productions + 1) * sizeof(*(parser->profile.productions))
+    );
+    memset(
+        parser->profile.phrase_attempts,
+        0,
+        (grammar->num_phrases + 1) * sizeof(uint32_t)
+    );
+    memset(
+        parser->profile.phrase_backtracks,
+        0,
+        (grammar->num_phrases + 1) * sizeof(uint32_t)
+    );
+
+    parser->profile.max_depth = 0;
+}
+
+/**
+ * Have a parser context count what it does during each parse: frame pushes,
+ * cache hits, misses and cached failures, local and cascading backtracks and
+ * left recursion growths for each production, how many times each phrase is
+ * tried and fails, and the deepest that the stack gets. The counters are
+ * cleared when the next parse starts and can be printed with
+ * parser_print_profile. Direct-coded parsers count everything but how many
+ * times their phrases fail on a cached result.
+ *
+ * The pieces of a parallel parse are parsed with their own contexts and so are
+ * not counted.
+ */
+void parser_enable_profiling(PParser *parser) {
+    assert_not_null(parser);
+    parser->profile.is_enabled = 1;
+}
+
+/**
+ * Print the counters of the last parse with a profiling parser context, either
+ * as a table or as JSON. If 'production_names' is NULL then productions are
+ * identified by number.
+ */
+void parser_print_profile(PParser *parser,
+                          char production_names[][40],
+                          int as_json) {
+
+    static const char *counter_names[P_PROFILE_NUM_COUNTERS] = {
+        "pushes",
+        "memo_hits",
+        "memo_misses",
+        "memo_failures",
+        "local_backtracks",
+        "cascading_backtracks",
+        "left_recursion_growths"
+    };
+
+    static const char *column_names[P_PROFILE_NUM_COUNTERS] = {
+        "pushes",
+        "hits",
+        "misses",
+        "failures",
+        "local",
+        "cascading",
+        "growths"
+    };
+
+    G_ProductionRule *rule;
+    PGrammar *grammar;
+    char name[40];
+    unsigned int i,
+                 j,
+                 k;
+
+    assert_not_null(parser);
+
+    grammar = parser->grammar;
+
+    if(!parser->profile.is_enabled
+    || is_null(parser->profile.productions)
+    || is_null(grammar)) {
+        return;
+    }
+
+    if(as_json) {
+        printf("{\"max_depth\": %u, \"productions\": [", parser->profile.max_depth);
+    } else {
+        printf("max depth: %u \n%-24s", parser->profile.max_depth, "production");
+        for(i = 0; i < P_PROFILE_NUM_COUNTERS; ++i) {
+            printf(" %10s", column_names[i]);
+        }
+        printf("\n");
+    }
+
+    for(i = 0; i < grammar->num_productions; ++i) {
+        rule = grammar->production_rules + i;
+
+        if(is_null(production_names)) {
+            sprintf(name, "%u", i);
+        } else {
+            strncpy(name, production_names[i], 39);
+            name[39] = 0;
+        }
+
+        if(as_json) {
+            printf("%s\n  {\"production\": \"%s\"", i ? "," : "", name);
+            for(j = 0; j < P_PROFILE_NUM_COUNTERS; ++j) {
+                printf(
+                    ", \"%s\": %u",
+                    counter_names[j],
+                    parser->profile.productions[i][j]
+                );
+            }
+            printf(", \"phrases\": [");
+        } else {
+            printf("%-24s", name);
+            for(j = 0; j < P_PROFILE_NUM_COUNTERS; ++j) {
+                printf(" %10u", parser->profile.productions[i][j]);
+            }
+            printf("\n");
+        }
+
+        for(j = 0; j < rule->num_phrases; ++j) {
+            k = (unsigned int) (rule->phrases - grammar->phrases) + j;
+
+            if(as_json) {
+                printf(
+                    "%s{\"attempts\": %u, \"backtracks\": %u}",
+                    j ? ", " : "",
+                    parser->profile.phrase_attempts[k],
+                    parser->profile.phrase_backtracks[k]
+                );
+            } else {
+                printf(
+                    "    phrase %-3u attempts %-10u backtracks %u \n",
+                    j,
+                    parser->profile.phrase_attempts[k],
+                    parser->profile.phrase_backtracks[k]
+                );
+            }
+        }
+
+        if(as_json) {
+            printf("]}");
+        }
+    }
+
+    if(as_json) {
+        printf("\n]}\n");
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Get a parser context ready to parse the tokens from 'scanner' with 'grammar'.
+ * Everything left over from the previous parse is forgotten, but the memory
+ * that held it is kept.
+ */
+static void P_reset(PParser *parser,
+                    PGrammar *grammar,
+                    PScanner *scanner,
+                    PScannerFunc *scanner_fnc) {
+
+    arena_reset(parser->arena);
+    PTH_init(&(parser->trees), parser->arena);
+
+    TS_reset(&(parser->tokens));
+    IR_reset(parser, grammar);
+
+    if(is_not_null(scanner)) {
+        parser->tokens.input = scanner->input.text;
+    }
+
+    parser->scanner = scanner;
+    parser->scanner_fnc = scanner_fnc;
+    parser->prescanned.tokens = NULL;
+    parser->prescanned.id_offset = 0;
+    parser->grammar = grammar;
+    parser->farthest_id_reached = 0;
+    parser->call.frame = -1;
+    parser->call.num_retained = 0;
+    parser->must_backtrack = 0;
+    parser->incremental.is_enabled = 0;
+    parser->incremental.is_reparsing = 0;
+    parser->incremental.parse_tree = NULL;
+    parser->incremental.num_recorded = 0;
+
+    P_reset_profile(parser, grammar);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Parse the tokens from a token generator and return their parse tree, or NULL
+ * if they can't be parsed. The parser context must have been reset beforehand.
+ * This parser operates on a simplified
+ * TDPL (Top-Down Parsing Language). It supports *local* backtracking. As such,
+ * this parser cannot be used to parse ambiguous grammar because expression rules
+ * in productions are ordered and once one succeeds for a particular input the
+ * other possibilities will never be attempted for that input.
+ *
+ * Tokens are pulled from the scanner as they are first needed and are kept in
+ * the parser's token store, where each token is found by its id: its terminal,
+ * lexeme and offset into the input are kept in arrays indexed by that id. A
+ * token's line and column are only found once a parse tree is made for it.
+ *
+ * The parser then gets things started by pushing on a new stack frame
+ * representing the application of the parser's starting production to the
+ * the entire stream of tokens, starting from the first token.
+ *
+ * At all times we maintain the id of where we are in the stream of tokens.
+ * This position can shift dramatically in the event that we don't match a
+ * non/terminal and hence have to backtrack, or if we've previously matched
+ * a production and hence have to jump ahead because we don't need to repeat
+ * work that we've already done.
+ *
+ * The results of the productions that the parser memoizes are cached. That is,
+ * if such a production fails then we cache that failure in the thunk table as a
+ * special pointer. If it succeeds then we cache its parse tree and the id of the
+ * token it ended at. Which productions are memoized is decided per production
+ * rule: left-recursive rules always are, as the cache is how left recursion is
+ * detected, while rules that don't apply any other production are not, as they
+ * are cheaper to re-apply. parser_tune_memoization can stop a parser context
+ * from memoizing the rules whose cached results were never re-used. The
+ * results of the other productions are re-computed each time they're applied.
+ *
+ * When the parser passes a cut and no frame on the stack can backtrack any
+ * more, the cached results, tokens and garbage trees before the cut are freed.
+ *
+ * This parser produces a reduced concrete syntax tree (parse tree). It is
+ * similar to an abstract syntax tree in that it is much smaller than a typical
+ * parse tree and, for the most part, only contains information that is relevant
+ * to semantic analysis. The reduced parse tree is created from the parse tree
+ * by shaving off unnecessary nodes and by excluding non-useful tokens from the
+ * tree itself.
+ *
+ * TODO: i) implement useful parse error reporting and recovery
+ *       ii) allow for left-recursion, as described in the following article:
+ *           http://portal.acm.org/citation.cfm?id=1328408.1328424
+ */
+static PParseTree *P_parse(PParser *parser, PGrammar *grammar) {
+
+    P_Frame *frame = NULL,
+            *caller = NULL;
+
+    P_IntermediateResult *intermediate_result = NULL,
+                         *temp_result = NULL;
+
+    G_Symbol *symbol = NULL,
+             *next_symbol = NULL;
+
+    PParseTree *temp_parse_tree = NULL;
+
+    uint32_t token = 0;
+
+    /* useful counter, be it for hinting to GCC that a block shouldn't be
+     * optimized out, or for actually counting something. */
+    unsigned int j = 0;
+
+    /* get the first token, unless the tokens were scanned ahead of time */
+    if(parser->tokens.end_id > parser->tokens.first_id) {
+        token = parser->tokens.first_id;
+        if(token == parser->tokens.gap_start) {
+            token += parser->tokens.gap_length;
+        }
+    } else {
+        token = P_pull_terminal(parser);
+    }
+
+    /* get the starting production and push our first stack frame on. This
+     * involves registering the start of the token list as the farthest back
+     * we can backtrack.
+     */
+    D( printf("pushing production onto stack...\n"); )
+
+    /* push on our first stack frame */
+    frame = F_push(
+        parser,
+        grammar->production_rules + grammar->start_production_rule,
+        token
+    );
+
+    D( printf("beginning main parse...\n"); )
+
+    while(0 <= parser->call.frame) {
+
+parser_begin_loop:
+
+        frame = parser->call.frames + (j = parser->call.frame);
+
+        D( printf("\nframe is %d=%p, phrase is %d, symbol is %d, at %d \n", j, (void *) frame, frame->production.phrase, frame->production.symbol, (int) parser->call.frame); )
+
+        /* get the cached result for the frame on the top of the stack */
+        intermediate_result = frame->result;
+
+        D( printf("intermediate result is %p. \n", (void *) intermediate_result); )
+
+        /* get the current symbol that we are looking at */
+        symbol = G_production_rule_get_symbol(
+            frame->production.rule,
+            frame->production.phrase,
+            frame->production.symbol
+        );
+
+        D( printf("symbol is %p. \n", (void *) symbol); )
+
+        /* the latest attempt at matching a repeated or optional non-terminal
+         * failed. this ends the repetition instead of failing the phrase, so
+         * long as the symbol has been matched as many times as it must be. */
+        if(parser->must_backtrack
+        && is_not_null(frame->repetition.symbol)
+        && (frame->repetition.symbol->is_optional
+            || frame->repetition.has_matched)) {
+
+            D( printf("ending repetition.\n"); )
+
+            parser->must_backtrack = 0;
+            token = frame->repetition.token;
+
+            ++(frame->production.symbol);
+            frame->repetition.symbol = NULL;
+            frame->repetition.has_matched = 0;
+
+        /* an error occurred in the current frame. we need to pop it off, dump
+         * its parse tree, backtrack, and possibly cascade the failure upward.
+         */
+        } else if(parser->must_backtrack) {
+
+backtrack_raised:
+
+            /* make (mostly) sure that a phrase isn't found */
+            if(frame->production.is_committed) {
+                frame->production.phrase = (unsigned char) -1;
+                D( printf("Forcing production to commit. \n"); )
+            }
+
+            /* there are no rules to backtrack to, we need to cascade the
+             * failure upward, dump the tree, and cache the failure.
+             */
+            j = G_production_rule_has_phrase(
+                frame->production.rule,
+                frame->production.phrase + 1
+            );
+
+            if(!j) {
+
+                /* trying to cascade off of the stack */
+                if(parser->call.frame == 0) {
+                    D( printf("parse error.\n"); )
+                    goto parse_error;
+                }
+
+                caller = parser->call.frames + (j = parser->call.frame - 1);
+                temp_result = caller->result;
+
+                /* the next frame is left recursive */
+                if(caller->left_recursion.is_used
+                && intermediate_result->intermediate_tree != IR_FAILED
+                && temp_result->intermediate_tree != IR_FAILED) {
+
+stop_left_recursion:
+
+                    parser->must_backtrack = 0;
+                    token = temp_result->end_token;
+
+                    if(caller->left_recursion.is_direct) {
+
+                        /* we now have a problem: there could be another left-
+                         * recursive rule in the caller in its next phrase, or
+                         * the next phrase could be the caller's phrase is its
+                         * seed phrase. We make a fairly strong assumption here
+                         * that there are no left-recursive phrases defined
+                         * after the seed phrase. */
+                        if(caller->production.phrase + 1
+                        >= caller->left_recursion.seed_phrase) {
+                            goto cascading_backtrack;
+                        }
+
+                        F_pop_farthest(frame, caller);
+                        --(parser->call.frame);
+                        caller->left_recursion.is_used = 0;
+                        caller->parse_tree = temp_result->intermediate_tree;
+                        ++(caller->production.symbol);
+
+                    } else {
+                        frame->parse_tree = (
+                            intermediate_result->intermediate_tree
+                        );
+
+                        goto phrase_completed;
+                    }
+
+                } else {
+
+cascading_backtrack:
+
+                    D( printf("cascading.\n"); )
+
+                    P_COUNT(
+                        parser,
+                        frame->production.rule->production,
+                        P_PROFILE_CASCADING_BACKTRACKS
+                    );
+                    P_COUNT_PHRASE(
+                        parser,
+                        phrase_backtracks,
+                        frame->production.rule,
+                        frame->production.phrase
+                    );
+
+                    F_pop_farthest(frame, caller);
+                    --(parser->call.frame);
+                    intermediate_result->intermediate_tree = IR_FAILED;
+                    IR_release(parser, intermediate_result);
+
+                    /* parser->must_backtrack remains set to 1 and so the cascade is
+                     * automatic. */
+
+                }
+
+            /* there is at least one rule to backtrack to. */
+            } else {
+
+local_backtrack:
+
+                D( printf("backtracking.\n"); )
+
+                P_COUNT(
+                    parser,
+                    frame->production.rule->production,
+                    P_PROFILE_LOCAL_BACKTRACKS
+                );
+                P_COUNT_PHRASE(
+                    parser,
+                    phrase_backtracks,
+                    frame->production.rule,
+                    frame->production.phrase
+                );
+
+                parser->must_backtrack = 0;
+
+                token = frame->backtrack_point;
+
+                ++(frame->production.phrase);
+                ++(((PT_NonTerminal *) frame->parse_tree)->phrase);
+                frame->production.symbol = 0;
+                frame->repetition.symbol = NULL;
+                frame->repetition.has_matched = 0;
+
+                F_skip_phrases(parser, frame, token);
+
+                P_COUNT_PHRASE(
+                    parser,
+                    phrase_attempts,
+                    frame->production.rule,
+                    frame->production.phrase
+                );
+
+                /* drop the branches of the parse tree */
+                tree_clear((PTree *) frame->parse_tree);
+
+                D( printf("new token is %d (backtrack). \n", token); )
+            }
+
+        /* a production successfully matched all of the non/terminals in its
+         * current rule list. we need to pop it off, merge its parse tree into
+         * the parent frame's (calling production) parse tree, and then tell
+         * the parent frame to advance itself to the next non/terminal in its
+         * current rule list. if there is no parent frame then we have
+         * successfully parsed the tokens.
+         */
+        } else if(is_null(symbol)) {
+
+phrase_completed:
+
+            /* there are tokens to parse but we have a single frame on
+             * on stack. this is a parse error, so we will backtrack. */
+            if(parser->call.frame == 0) {
+                F_EXAMINE(frame, token);
+            }
+
+            if(parser->call.frame == 0
+            && TS_TERMINAL(&(parser->tokens), token) >= 0) {
+                if(frame->left_recursion.is_used == 1) {
+                    goto grow_left_recursion;
+                }
+                D( printf("no rules left to parse remaining tokens. \n"); )
+                parser->must_backtrack = 1;
+
+            /* we have parsed all of the tokens. there is no need to do any
+             * work on the stack or the cache. */
+            } else if(parser->call.frame == 0) {
+
+                D( printf("done parsing.\n"); )
+                goto done_parsing;
+
+            /* we've fully matched a production rule  */
+            } else {
+
+                D( printf("production succeeded.\n"); )
+
+                D( printf(
+                    "token id %d, IR->fpr %d ***\n",
+                    token,
+                    intermediate_result->end_token
+                ); )
+
+                caller = parser->call.frames + (parser->call.frame - 1);
+                intermediate_result->is_being_retested = 0;
+
+                /* the production rule that we matched is the origin of left
+                 * recursion and its most recent application was successful. */
+                if(frame->left_recursion.is_used
+                && token > intermediate_result->end_token) {
+
+grow_left_recursion:
+
+                    D( printf("\t growing left-recursion.\n"); )
+
+                    P_COUNT(
+                        parser,
+                        frame->production.rule->production,
+                        P_PROFILE_LEFT_RECURSION_GROWTHS
+                    );
+                    P_COUNT_PHRASE(
+                        parser,
+                        phrase_attempts,
+                        frame->production.rule,
+                        0
+                    );
+
+                    intermediate_result->intermediate_tree = frame->parse_tree;
+                    intermediate_result->end_token = token;
+
+                    frame->parse_tree = (PParseTree *) PT_alloc_non_terminal(
+                        &(parser->trees),
+                        frame->production.rule->production,
+                        2 /* TODO: start bigger? */
+                    );
+
+                    /* re-start this frame */
+                    token = frame->backtrack_point;
+                    frame->production.phrase = 0;
+                    frame->production.symbol = 0;
+                    frame->repetition.symbol = NULL;
+                    frame->repetition.has_matched = 0;
+
+                    if(!frame->left_recursion.is_direct) {
+                        intermediate_result->is_being_retested = 1;
+                    }
+
+                /* pop the production and advance to the next rule of the
+                 * calling production. */
+                } else {
+
+pop_production_rule:
+
+                    D( printf("\t popping frame off of stack. \n"); )
+
+                    intermediate_result->end_token = token;
+                    intermediate_result->intermediate_tree = frame->parse_tree;
+                    intermediate_result->is_being_retested = 0;
+
+                    F_pop_farthest(frame, caller);
+
+                    frame = parser->call.frames + (j = --(parser->call.frame));
+                    F_record_tree(
+                        parser,
+                        frame,
+                        intermediate_result->intermediate_tree
+                    );
+                    IR_release(parser, intermediate_result);
+
+                    /* frames will be pushed over the popped frame */
+                    if(parser->call.num_retained > parser->call.frame + 1) {
+                        parser->call.num_retained = parser->call.frame + 1;
+                    }
+
+                    F_advance(frame, token);
+                }
+            }
+
+        /*} else if(TS_TERMINAL(&(parser->tokens), token) < 0 && symbol->is_terminal) {
+
+end_of_input:
+
+            D( printf("end of input with more tokens to parse, backtracking. \n"); )
+            parser->must_backtrack = 1;
+        */
+        } else {
+
+            /* accept any number of consecutive symbols */
+            while(symbol->is_cut) {
+
+match_cut_symbol:
+
+                D( printf("committing to phrase. \n"); )
+
+                frame->production.is_committed = 1;
+
+                P_evict(parser, token);
+
+                symbol = G_production_rule_get_symbol(
+                    frame->production.rule,
+                    frame->production.phrase,
+                    ++(frame->production.symbol)
+                );
+
+                if(is_null(symbol)) {
+                    goto parser_begin_loop;
+                }
+            }
+
+            if(symbol->is_fail) {
+
+match_fail_symbol:
+
+                parser->must_backtrack = 1;
+
+            /* the next non/terminal in the current rule list is a non-terminal,
+             * i.e. it is a production. we need to push the production onto the
+             * stack.
+             */
+            } else if(symbol->is_non_terminal) {
+
+                D( printf("non-terminal symbol found. \n"); )
+
+match_non_terminal_symbol:
+
+                /* remember where this attempt at matching a repeated or
+                 * optional non-terminal started so that its failure can
+                 * return there. */
+                if(symbol->is_repeated || symbol->is_optional) {
+                    frame->repetition.symbol = symbol;
+                    frame->repetition.token = token;
+                }
+
+                intermediate_result = IR_get(
+                    parser,
+                    symbol->value.non_terminal,
+                    token
+                );
+
+                /* we have already applied this production to this particular
+                 * place in the token stream. */
+                if(is_not_null(intermediate_result)) {
+
+                    /* the cached result is a failure. time to backtrack. */
+                    if(IR_FAILED == intermediate_result->intermediate_tree) {
+
+                        D( printf("cached production failed.\n"); )
+                        P_COUNT(
+                            parser,
+                            symbol->value.non_terminal,
+                            P_PROFILE_MEMO_FAILURES
+                        );
+                        F_EXAMINE(frame, intermediate_result->farthest_token);
+                        parser->must_backtrack = 1;
+
+                    /* the cached result is missing, i.e. the cache value was
+                     * initialized by a production already on the stack but that
+                     * has (in)directly called itself through left recursion. */
+                    } else if(IR_INITIAL == intermediate_result->intermediate_tree) {
+
+                        D( printf("detected left recursion. \n"); )
+
+                        intermediate_result->intermediate_tree = IR_FAILED;
+
+                        D( printf("pushing production onto stack. \n"); )
+
+                        frame = F_push(
+                            parser,
+                            grammar->production_rules + symbol->value.non_terminal,
+                            token
+                        );
+
+                        LR_mark_origin(parser, intermediate_result);
+
+                    /* indirect left recursion is special in that the production
+                     * rule used to get at the left-recursive call will have a
+                     * cached version that is not up-to-date with actual indirect
+                     * left-recursive call. To force the cache to update itself
+                     * we need to push the first
+                     */
+                    } else if(intermediate_result->uses_indirect_left_recursion
+                    && !intermediate_result->is_being_retested
+                    && parser->call.frame > 0) {
+
+                        caller = parser->call.frames + (parser->call.frame - 1);
+
+                        /* make sure that we are dealing with left recursion or
+                         * something equivalent to it. */
+                        if(caller->backtrack_point == token) {
+
+                            D( printf("\t pushing on out-of-date cached result \n"); )
+
+                            intermediate_result->is_being_retested = 1;
+
+                            frame = F_push(
+                                parser,
+                                grammar->production_rules + symbol->value.non_terminal,
+                                token
+                            );
+
+                        } else {
+                            goto cached_production_succeeded;
+                        }
+
+                    /* the cached result was a success, we need to merge the
+                     * cached tree with our current parse tree, advance to the
+                     * next rewrite rule in our current rule list, and advance
+                     * our current position in the token list to the token after
+                     * the last token that was matched in the cached result.
+                     */
+                    } else {
+
+cached_production_succeeded:
+
+                        D( printf("cached production succeeded.\n"); )
+
+                        P_COUNT(
+                            parser,
+                            symbol->value.non_terminal,
+                            P_PROFILE_MEMO_HITS
+                        );
+
+                        F_add_branch(
+                            parser,
+                            frame,
+                            intermediate_result->intermediate_tree,
+                            symbol
+                        );
+
+                        /* advance to a future token and to the next symbol */
+                        token = intermediate_result->end_token;
+
+                        F_advance(frame, token);
+
+                        F_EXAMINE(frame, intermediate_result->farthest_token);
+
+                        D( printf("new token is %d (cached production). \n", token); )
+                    }
+
+                /* we do not have a cached result but the production can't
+                 * match the current token, so don't bother pushing it. */
+                } else if(!G_production_rule_can_start(
+                    grammar,
+                    grammar->production_rules + symbol->value.non_terminal,
+                    TS_TERMINAL(&(parser->tokens), token)
+                )) {
+
+                    D( printf("production can't start with the current token.\n"); )
+                    P_COUNT(
+                        parser,
+                        symbol->value.non_terminal,
+                        P_PROFILE_MEMO_MISSES
+                    );
+                    F_EXAMINE(frame, token);
+                    parser->must_backtrack = 1;
+
+                /* we do not have a cached result and so we will need to push a
+                 * new frame onto the stack. */
+                } else {
+
+calling_production_symbol:
+
+                    D( printf("pushing production onto stack.\n"); )
+
+                    P_COUNT(
+                        parser,
+                        symbol->value.non_terminal,
+                        P_PROFILE_MEMO_MISSES
+                    );
+
+                    next_symbol = G_production_rule_get_symbol(
+                        frame->production.rule,
+                        frame->production.phrase,
+                        frame->production.symbol + 1
+                    );
+
+                    frame = F_push(
+                        parser,
+                        grammar->production_rules + symbol->value.non_terminal,
+                        token
+                    );
+                }
+
+            /* the next non/terminal in the current rule list is a terminal,
+             * i.e. it is a token. we need to try to match the current token
+             * against the symbol's token. if they match then we need to advance
+             * to the next rule and to the next token. if they do not match
+             * then we need to signal the frame to backtrack.
+             */
+            } else if(symbol->is_terminal) {
+
+match_terminal_symbol:
+
+                D( printf("terminal symbol found. \n"); )
+
+                /* record the farthest point we've gotten to. */
+                if(token > parser->farthest_id_reached) {
+                    parser->farthest_id_reached = token;
+                }
+
+                F_EXAMINE(frame, token);
+
+                /* we have matched a token, advance to the next token in the
+                 * list and the next rewrite rule in the current rule list.
+                 * also, store the matched token into the frame's partial parse
+                 * tree. a repeated terminal matches as many tokens in a row as
+                 * it can. */
+                if(TS_TERMINAL(&(parser->tokens), token) == symbol->value.terminal) {
+
+                    for(;;) {
+
+                        D( printf("\t matched token %d. \n", token); )
+
+                        /* store the match as a parse tree */
+                        if(symbol->is_non_excludable || !PT_ENABLE_TREE_REDUCTIONS) {
+                            F_add_branch(
+                                parser,
+                                frame,
+                                P_alloc_terminal_tree(parser, token),
+                                symbol
+                            );
+                        }
+
+                        /* advance the token */
+                        token = P_next_terminal(parser, token);
+
+                        D( printf("new token is %d (next). \n", token); )
+
+                        if(!symbol->is_repeated) {
+                            break;
+                        }
+
+                        if(token > parser->farthest_id_reached) {
+                            parser->farthest_id_reached = token;
+                        }
+
+                        F_EXAMINE(frame, token);
+
+                        if(TS_TERMINAL(&(parser->tokens), token)
+                        != symbol->value.terminal) {
+                            break;
+                        }
+                    }
+
+                    ++(frame->production.symbol);
+
+                /* an optional terminal that doesn't match is skipped */
+                } else if(symbol->is_optional) {
+
+                    D( printf("\t skipped optional token. \n"); )
+
+                    ++(frame->production.symbol);
+
+                /* the tokens do not match, backtrack. */
+                } else {
+
+                    D(
+                        printf(
+                            "\t didn't match, expected:%d got:%d, token is %d\n",
+                            (unsigned int) symbol->value.terminal,
+                            (unsigned int) TS_TERMINAL(&(parser->tokens), token),
+                            token
+                        );
+                    )
+
+                    parser->must_backtrack = 1;
+                }
+
+            /* accept any number of consecutive epsilon transitions (match the
+             * empty string). */
+            } else if(symbol->is_epsilon_transition) {
+
+match_epsilon_symbol:
+
+                D( printf("\t epsilon symbol found. \n"); )
+
+                do {
+                    if(symbol->is_non_excludable || !PT_ENABLE_TREE_REDUCTIONS) {
+                        temp_parse_tree = (PParseTree *) PT_alloc_epsilon(
+                            &(parser->trees)
+                        );
+                        F_add_branch(parser, frame, temp_parse_tree, symbol);
+                    }
+
+                    /* get the next symbol */
+                    symbol = G_production_rule_get_symbol(
+                        frame->production.rule,
+                        frame->production.phrase,
+                        ++(frame->production.symbol)
+                    );
+
+                } while(is_not_null(symbol) && symbol->is_epsilon_transition);
+            } else {
+                std_error("Internal Parser Error: Strange conditions met.");
+            }
+        }
+    }
+
+parse_error:
+
+    /* the start production failed, and every other frame has already been
+     * popped, so the cached results are left as they would be after any other
+     * failed production. */
+    D( printf("A parse error occurred. \n"); )
+
+    temp_parse_tree = NULL;
+    parser->call.frame = -1;
+    IR_release(parser, frame->result);
+
+    goto return_from_parser;
+
+done_parsing:
+
+    D( printf("\n\nSuccessfully parsed. \n"); )
+
+    temp_parse_tree = frame->parse_tree;
+    IR_release(parser, frame->result);
+
+return_from_parser:
+
+    return temp_parse_tree;
+}
+
+/**
+ * Parse the tokens from a token generator and perform the grammar's actions on
+ * the resulting parse tree. Returns 1 if the tokens were parsed, and 0, without
+ * performing any actions, if they have a syntax error.
+ *
+ * The parser context keeps its cache table, stack frames, token store and
+ * arena between calls, so parsing many small inputs with the same context
+ * doesn't rebuild them each time. The parse tree given to the grammar actions
+ * is only valid until the next parse with the context.
+ */
+int parser_parse_tokens(PParser *parser,
+                        PGrammar *grammar,
+                        PScanner *scanner,
+                        PScannerFunc *scanner_fnc,
+                        void *state) {
+
+    PParseTree *parse_tree;
+
+    assert_not_null(parser);
+
+    D( printf("initializing parser...\n"); )
+
+    G_lock(grammar);
+
+    P_reset(parser, grammar, scanner, scanner_fnc);
+
+    parse_tree = P_parse(parser, grammar);
+
+    if(is_not_null(parse_tree)) {
+        P_perform_grammar_actions(grammar, parse_tree, state);
+    }
+
+    G_unlock(grammar);
+
+    return is_not_null(parse_tree);
+}
+
+/**
+ * Parse the tokens from a token generator using a temporary parser context.
+ * Returns 1 if the tokens were parsed, and 0 if they have a syntax error.
+ */
+int parse_tokens(PGrammar *grammar,
+                 PScanner *scanner,
+                 PScannerFunc *scanner_fnc,
+                 void *state) {
+
+    PParser *parser = parser_alloc();
+    int is_parsed = parser_parse_tokens(
+        parser,
+        grammar,
+        scanner,
+        scanner_fnc,
+        state
+    );
+    parser_free(parser);
+    return is_parsed;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Run 'work' on 'num_workers' threads, one of which is the calling thread, and
+ * wait for all of them to finish.
+ */
+static void P_run_workers(void *(*work)(void *),
+                          void *job,
+                          unsigned int num_workers) {
+
+    pthread_t *threads = NULL;
+    unsigned int i;
+
+    if(num_workers > 1) {
+        threads = mem_alloc((num_workers - 1) * sizeof(pthread_t));
+        if(is_null(threads)) {
+            mem_error("Unable to allocate worker threads.");
+        }
+
+        for(i = 0; i < num_workers - 1; ++i) {
+            if(0 != pthread_create(threads + i, NULL, work, job)) {
+                std_error("Internal Parser Error: Unable to create a thread.");
+            }
+        }
+    }
+
+    work(job);
+
+    if(is_not_null(threads)) {
+        for(i = 0; i < num_workers - 1; ++i) {
+            pthread_join(threads[i], NULL);
+        }
+        mem_free(threads);
+    }
+}
+
+/**
+ * The work shared between the threads of a parallel parse. Each piece of the
+ * token stream is parsed with its own parser context; the piece after the last
+ * one claimed is 'next_chunk'.
+ */
+typedef struct P_ParallelParse {
+
+    PParser *parser;
+    PGrammar *grammar;
+
+    PParser **chunk_parsers;
+    PParseTree **chunk_trees;
+
+    /* the id of the first token of each piece, followed by the id of the
+     * end-of-stream token. */
+    uint32_t *chunk_starts;
+
+    uint32_t num_chunks,
+             next_chunk;
+
+    pthread_mutex_t lock;
+
+} P_ParallelParse;
+
+/**
+ * Split the tokens in the parser's token store into at most 'max_chunks' pieces
+ * of roughly the same size. Pieces only start at synchronization terminals.
+ * Returns the number of pieces.
+ */
+static uint32_t P_split_tokens(PParser *parser,
+                               PGrammar *grammar,
+                               uint32_t *chunk_starts,
+                               uint32_t max_chunks) {
+
+    P_TokenStore *store = &(parser->tokens);
+    uint32_t id,
+             end_id = store->end_id - 1,
+             chunk_size = (end_id - store->first_id) / max_chunks,
+             num_chunks = 1;
+
+    chunk_starts[0] = store->first_id;
+
+    for(id = store->first_id + 1; id < end_id && num_chunks < max_chunks; ++id) {
+        if((id - chunk_starts[num_chunks - 1]) >= chunk_size
+        && G_is_sync_terminal(grammar, TS_TERMINAL(store, id))) {
+            chunk_starts[num_chunks++] = id;
+        }
+    }
+
+    chunk_starts[num_chunks] = end_id;
+
+    return num_chunks;
+}
+
+/**
+ * Parse pieces of the token stream until there are none left. This is run by
+ * every thread of a parallel parse.
+ */
+static void *P_parse_chunks(void *job_ptr) {
+
+    P_ParallelParse *job = job_ptr;
+    PParser *parser;
+    uint32_t i;
+
+    for(;;) {
+        pthread_mutex_lock(&(job->lock));
+        i = (job->next_chunk)++;
+        pthread_mutex_unlock(&(job->lock));
+
+        if(i >= job->num_chunks) {
+            break;
+        }
+
+        D( printf("parsing tokens [%d, %d). \n", job->chunk_starts[i], job->chunk_starts[i + 1]); )
+
+        parser = parser_alloc();
+        P_reset(parser, job->grammar, NULL, NULL);
+
+        /* parse with the same memoization policy as the main parser */
+        memcpy(
+            parser->memo.is_memoized,
+            job->parser->memo.is_memoized,
+            ((job->grammar->num_productions >> 5) + 1) * sizeof(uint32_t)
+        );
+
+        parser->prescanned.tokens = &(job->parser->tokens);
+        parser->tokens.input = job->parser->tokens.input;
+        parser->scanner = job->parser->scanner;
+        parser->prescanned.next_id = job->chunk_starts[i];
+        parser->prescanned.end_id = job->chunk_starts[i + 1];
+        parser->prescanned.id_offset = job->chunk_starts[i];
+
+        job->chunk_parsers[i] = parser;
+        job->chunk_trees[i] = P_parse(parser, job->grammar);
+    }
+
+    return NULL;
+}
+
+/**
+ * Parse the tokens from a token generator using up to 'num_workers' threads and
+ * perform the grammar's actions on the resulting parse tree.
+ *
+ * All of the tokens are scanned up front. They are then split into pieces at
+ * the grammar's synchronization terminals and each piece is parsed with the
+ * start production on its own. The pieces' parse trees are stitched together by
+ * making their branches the branches of a single tree for the start
+ * production. This gives the same parse tree as parser_parse_tokens for a start
+ * production that is a list of independent units whose trees are raised into
+ * it, e.g.
+ *
+ *     Program : ^(-FuncDef | -TypeDef)* ;
+ *
+ * with "def" and "type" as the synchronization terminals. If the grammar has no
+ * synchronization terminals then all of the tokens are parsed as one piece.
+ *
+ * Returns 1 if the tokens were parsed, and 0, without performing any actions,
+ * if any piece has a syntax error. The parse tree given to the grammar actions
+ * is only valid until this function returns.
+ */
+int parser_parse_tokens_parallel(PParser *parser,
+                                 PGrammar *grammar,
+                                 PScanner *scanner,
+                                 PScannerFunc *scanner_fnc,
+                                 void *state,
+                                 unsigned int num_workers) {
+
+    P_ParallelParse job;
+    PParseTree *parse_tree;
+    uint32_t i,
+             max_chunks,
+             line,
+             column;
+    int is_parsed = 1;
+
+    assert_not_null(parser);
+    assert_not_null(grammar);
+    assert_not_null(scanner);
+
+    if(0 == num_workers) {
+        num_workers = 1;
+    }
+
+    /* the grammar is only read from by the worker threads. */
+    G_lock(grammar);
+
+    P_reset(parser, grammar, scanner, scanner_fnc);
+
+    /* scan all of the tokens */
+    do {
+        i = P_pull_terminal(parser);
+    } while(TS_TERMINAL(&(parser->tokens), i) >= 0);
+
+    /* the workers find the positions of their tokens with the scanner, so
+     * all of the input's newlines are indexed before they start in order for
+     * them to only ever read the index. */
+    scanner_get_position(scanner, scanner->input.num_read, &line, &column);
+
+    max_chunks = num_workers * P_PARALLEL_CHUNKS_PER_WORKER;
+
+    job.parser = parser;
+    job.grammar = grammar;
+    job.chunk_starts = mem_alloc((max_chunks + 1) * sizeof(uint32_t));
+    job.chunk_parsers = mem_alloc(max_chunks * sizeof(PParser *));
+    job.chunk_trees = mem_alloc(max_chunks * sizeof(PParseTree *));
+    job.next_chunk = 0;
+
+    if(is_null(job.chunk_starts)
+    || is_null(job.chunk_parsers)
+    || is_null(job.chunk_trees)) {
+        mem_error("Unable to allocate a parallel parse.");
+    }
+
+    job.num_chunks = P_split_tokens(parser, grammar, job.chunk_starts, max_chunks);
+
+    D( printf("parsing %d pieces. \n", job.num_chunks); )
+
+    pthread_mutex_init(&(job.lock), NULL);
+    P_run_workers(
+        &P_parse_chunks,
+        &job,
+        num_workers < job.num_chunks ? num_workers : job.num_chunks
+    );
+    pthread_mutex_destroy(&(job.lock));
+
+    for(i = 0; i < job.num_chunks; ++i) {
+        if(is_null(job.chunk_trees[i])) {
+            is_parsed = 0;
+        }
+    }
+
+    if(is_parsed) {
+
+        /* stitch the pieces back together */
+        parse_tree = (PParseTree *) PT_alloc_non_terminal(
+            &(parser->trees),
+            grammar->start_production_rule,
+            0
+        );
+
+        ((PT_NonTerminal *) parse_tree)->phrase = (
+            ((PT_NonTerminal *) job.chunk_trees[0])->phrase
+        );
+
+        for(i = 0; i < job.num_chunks; ++i) {
+            PT_add_branch_children(
+                &(parser->trees),
+                parse_tree,
+                job.chunk_trees[i]
+            );
+        }
+
+        P_perform_grammar_actions(grammar, parse_tree, state);
+    }
+
+    G_unlock(grammar);
+
+    for(i = 0; i < job.num_chunks; ++i) {
+        parser_free(job.chunk_parsers[i]);
+    }
+
+    mem_free(job.chunk_starts);
+    mem_free(job.chunk_parsers);
+    mem_free(job.chunk_trees);
+
+    return is_parsed;
+}
+
+/**
+ * The work shared between the threads of a batch parse. The file after the last
+ * one claimed is 'next_file'.
+ */
+typedef struct P_BatchParse {
+
+    PGrammar *grammar;
+    PScannerFunc *scanner_fnc;
+
+    const char **file_names;
+    void **states;
+    P_FileResult *results;
+
+    unsigned int num_files,
+                 next_file,
+                 num_parsed;
+
+    pthread_mutex_t lock;
+
+} P_BatchParse;
+
+/**
+ * Parse files until there are none left. This is run by every thread of a
+ * batch parse; each thread has its own scanner and parser context.
+ */
+static void *P_parse_files(void *job_ptr) {
+
+    P_BatchParse *job = job_ptr;
+    PParser *parser = parser_alloc();
+    PScanner *scanner = scanner_alloc();
+    unsigned int i;
+    P_FileResult result;
+
+    for(;;) {
+        pthread_mutex_lock(&(job->lock));
+        i = (job->next_file)++;
+        pthread_mutex_unlock(&(job->lock));
+
+        if(i >= job->num_files) {
+            break;
+        }
+
+        if(!scanner_use_mmap(scanner, job->file_names[i])
+        && !scanner_use_file(scanner, job->file_names[i])) {
+            D( printf("unable to open %s. \n", job->file_names[i]); )
+            result = P_FILE_NOT_OPENED;
+
+        } else {
+            scanner_flush(scanner, 1);
+
+            result = parser_parse_tokens(
+                parser,
+                job->grammar,
+                scanner,
+                job->scanner_fnc,
+                is_null(job->states) ? NULL : job->states[i]
+            ) ? P_FILE_PARSED : P_FILE_NOT_PARSED;
+        }
+
+        /* each file's result is only written by the thread that claimed it */
+        if(is_not_null(job->results)) {
+            job->results[i] = result;
+        }
+
+        if(P_FILE_PARSED == result) {
+            pthread_mutex_lock(&(job->lock));
+            ++(job->num_parsed);
+            pthread_mutex_unlock(&(job->lock));
+        }
+    }
+
+    scanner_free(scanner);
+    parser_free(parser);
+
+    return NULL;
+}
+
+/**
+ * Parse many files with the same grammar using up to 'num_workers' threads.
+ * The grammar's actions are performed on the parse tree of the file
+ * 'file_names[i]' with the state 'states[i]', or with no state if 'states' is
+ * NULL. The actions of different files can be performed at the same time by
+ * different threads, so they must only touch their own state.
+ *
+ * The grammar is frozen so that the threads can share it. Files are mapped into
+ * memory where possible, and read through the scanner's buffer otherwise.
+ *
+ * Returns the number of files that could be opened and parsed. If 'results' is
+ * not NULL then 'results[i]' is set to P_FILE_PARSED if 'file_names[i]' was
+ * parsed, P_FILE_NOT_PARSED if it has a syntax error, or P_FILE_NOT_OPENED if
+ * it couldn't be opened. One file failing doesn't stop the others from being
+ * parsed.
+ */
+unsigned int parse_files(PGrammar *grammar,
+                         PScannerFunc *scanner_fnc,
+                         const char *file_names[],
+                         void *states[],
+                         P_FileResult results[],
+                         unsigned int num_files,
+                         unsigned int num_workers) {
+
+    P_BatchParse job;
+
+    assert_not_null(grammar);
+    assert_not_null(scanner_fnc);
+    assert_not_null(file_names);
+
+    if(0 == num_workers) {
+        num_workers = 1;
+    }
+
+    grammar_freeze(grammar);
+
+    job.grammar = grammar;
+    job.scanner_fnc = scanner_fnc;
+    job.file_names = file_names;
+    job.states = states;
+    job.results = results;
+    job.num_files = num_files;
+    job.next_file = 0;
+    job.num_parsed = 0;
+
+    pthread_mutex_init(&(job.lock), NULL);
+    P_run_workers(
+        &P_parse_files,
+        &job,
+        num_workers < num_files ? num_workers : num_files
+    );
+    pthread_mutex_destroy(&(job.lock));
+
+    return job.num_parsed;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Get the index of the first token in a token store, other than the
+ * end-of-stream token, whose lexeme starts at or after 'input_offset' in the
+ * input. If there is no such token then the index of the end-of-stream token is
+ * returned. Indices count the tokens of the store in order, skipping its gap.
+ */
+static uint32_t TS_find_offset(P_TokenStore *store, uint32_t input_offset) {
+
+    uint32_t low = 0,
+             high = store->end_id - store->gap_length - 1,
+             middle;
+
+    while(low < high) {
+        middle = low + ((high - low) / 2);
+        if(TS_INPUT_OFFSET(store, TS_SLOT(store, middle)) < input_offset) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+/* the id of the farthest token that an intermediate result ends at or looked
+ * at. */
+#define IR_REACH(result) ( \
+    (result)->end_token > (result)->farthest_token \
+        ? (result)->end_token \
+        : (result)->farthest_token \
+)
+
+/**
+ * Move the end and farthest token ids of an intermediate result that are in
+ * [low, high) by 'delta' ids.
+ */
+static void IR_shift(P_IntermediateResult *result,
+                     uint32_t low,
+                     uint32_t high,
+                     uint32_t delta) {
+    if(result->end_token >= low && result->end_token < high) {
+        result->end_token += delta;
+    }
+    if(result->farthest_token >= low && result->farthest_token < high) {
+        result->farthest_token += delta;
+    }
+}
+
+/**
+ * Release the intermediate result at index 'j' of a chunk of the cache table.
+ */
+static void IR_remove(PParser *parser, P_MemoChunk results, uint32_t j) {
+    if(!results[j]->is_orphaned) {
+        arena_release(parser->arena, results[j], sizeof(P_IntermediateResult));
+    }
+    results[j] = NULL;
+}
+
+/**
+ * Release the intermediate results for the token with id 'id'.
+ */
+static void IR_release_token(PParser *parser, uint32_t id) {
+
+    uint32_t j,
+             num_productions = parser->memo.num_productions;
+
+    P_MemoChunk results = IR_get_chunk(parser, id, 0);
+
+    if(is_null(results)) {
+        return;
+    }
+
+    results += (id & P_MEMO_CHUNK_MASK) * num_productions;
+
+    for(j = 0; j < num_productions; ++j) {
+        if(is_not_null(results[j])) {
+            IR_remove(parser, results, j);
+        }
+    }
+}
+
+/**
+ * Get the intermediate result with the key 'key', or NULL if there isn't one.
+ */
+static P_IntermediateResult *IR_find(PParser *parser, P_ResultKey *key) {
+
+    P_MemoChunk results = IR_get_chunk(parser, key->id, 0);
+
+    if(is_null(results)) {
+        return NULL;
+    }
+
+    return results[
+        ((key->id & P_MEMO_CHUNK_MASK) * parser->memo.num_productions)
+      + (uint32_t) key->production
+    ];
+}
+
+/**
+ * Fill in the entries of the reach tree for runs of chunks from its leaves.
+ */
+static void IR_join_reach(PParser *parser) {
+
+    uint32_t i,
+             *reach = parser->incremental.reach;
+
+    for(i = parser->incremental.num_reach; --i > 0; ) {
+        reach[i] = reach[2 * i] > reach[(2 * i) + 1]
+                 ? reach[2 * i]
+                 : reach[(2 * i) + 1];
+    }
+}
+
+/**
+ * Make sure that the reach tree has a leaf for every chunk of the cache table.
+ * The number of chunks is always a power of two, and the tree is rebuilt when
+ * it grows.
+ */
+static void IR_grow_reach(PParser *parser) {
+
+    uint32_t num_reach = parser->memo.num_chunks,
+             *reach;
+
+    if(num_reach <= parser->incremental.num_reach) {
+        return;
+    }
+
+    reach = mem_calloc(2 * num_reach, sizeof(uint32_t));
+    if(is_null(reach)) {
+        mem_error("Unable to grow the reach of the intermediate results.");
+    }
+
+    if(is_not_null(parser->incremental.reach)) {
+        memcpy(
+            reach + num_reach,
+            parser->incremental.reach + parser->incremental.num_reach,
+            parser->incremental.num_reach * sizeof(uint32_t)
+        );
+        mem_free(parser->incremental.reach);
+    }
+
+    parser->incremental.reach = reach;
+    parser->incremental.num_reach = num_reach;
+
+    IR_join_reach(parser);
+}
+
+/**
+ * Note that an intermediate result for the token with id 'id' ends at or looked
+ * at the token with id 'reach'.
+ */
+static void IR_raise(PParser *parser, uint32_t id, uint32_t reach) {
+
+    uint32_t i;
+
+    IR_grow_reach(parser);
+
+    for(i = parser->incremental.num_reach + (id >> P_MEMO_CHUNK_BITS);
+        i > 0 && parser->incremental.reach[i] < reach;
+        i >>= 1) {
+        parser->incremental.reach[i] = reach;
+    }
+}
+
+/**
+ * Build the reach tree from every intermediate result in the cache table.
+ * Results that were never finished are released along the way.
+ */
+static void IR_build_reach(PParser *parser) {
+
+    register uint32_t j;
+
+    uint32_t i,
+             reach,
+             j_max = P_MEMO_CHUNK_SIZE * parser->memo.num_productions;
+
+    P_MemoChunk results;
+
+    if(is_not_null(parser->incremental.reach)) {
+        mem_free(parser->incremental.reach);
+        parser->incremental.reach = NULL;
+    }
+
+    parser->incremental.num_reach = 0;
+    IR_grow_reach(parser);
+
+    for(i = 0; i < parser->memo.num_chunks; ++i) {
+
+        results = parser->memo.chunks[i];
+        if(is_null(results)) {
+            continue;
+        }
+
+        for(reach = 0, j = 0; j < j_max; ++j) {
+            if(is_null(results[j])) {
+                continue;
+            }
+
+            if(IR_INITIAL == results[j]->intermediate_tree) {
+                IR_remove(parser, results, j);
+            } else if(IR_REACH(results[j]) > reach) {
+                reach = IR_REACH(results[j]);
+            }
+        }
+
+        parser->incremental.reach[parser->incremental.num_reach + i] = reach;
+    }
+
+    IR_join_reach(parser);
+}
+
+/**
+ * Release the intermediate results for tokens with ids before 'id' that looked
+ * at the token with id 'id' or at a token after it. Only the chunks covered by
+ * entry 'node' of the reach tree, 'num_chunks' chunks starting with the chunk
+ * 'chunk', are looked at, and only where the tree shows that such results can
+ * be. Results that end at the token without having looked at it are kept, and
+ * are recorded so that they can be made to end wherever the token ends up. The
+ * entries of the tree for the chunks looked at are made exact again.
+ */
+static void IR_release_spanning(PParser *parser,
+                                uint32_t node,
+                                uint32_t chunk,
+                                uint32_t num_chunks,
+                                uint32_t id) {
+    register uint32_t j;
+
+    uint32_t key,
+             reach = 0,
+             *tree = parser->incremental.reach,
+             num_productions = parser->memo.num_productions,
+             j_max = P_MEMO_CHUNK_SIZE * num_productions;
+
+    P_MemoChunk results;
+    P_IntermediateResult *result;
+
+    if(tree[node] < id || (chunk << P_MEMO_CHUNK_BITS) >= id) {
+        return;
+    }
+
+    if(num_chunks > 1) {
+        num_chunks /= 2;
+        IR_release_spanning(parser, 2 * node, chunk, num_chunks, id);
+        IR_release_spanning(
+            parser,
+            (2 * node) + 1,
+            chunk + num_chunks,
+            num_chunks,
+            id
+        );
+
+        tree[node] = tree[2 * node] > tree[(2 * node) + 1]
+                   ? tree[2 * node]
+                   : tree[(2 * node) + 1];
+        return;
+    }
+
+    results = parser->memo.chunks[chunk];
+
+    for(j = 0; is_not_null(results) && j < j_max; ++j) {
+
+        result = results[j];
+        if(is_null(result)) {
+            continue;
+        }
+
+        key = (chunk << P_MEMO_CHUNK_BITS) + (j / num_productions);
+
+        if(key < id && IR_REACH(result) >= id) {
+            if(result->farthest_token >= id
+            || IR_INITIAL == result->intermediate_tree) {
+                IR_remove(parser, results, j);
+                continue;
+            }
+
+            IR_record(
+                parser,
+                result,
+                (G_NonTerminal) (j % num_productions),
+                key
+            );
+        }
+
+        if(IR_REACH(result) > reach) {
+            reach = IR_REACH(result);
         }
     }
 
-    if(is_not_null(gen)) {
-        generator_free(gen);
-    }
+    tree[node] = reach;
 }
 
-/* -------------------------------------------------------------------------- */
-
 /**
- * Parse the tokens from a token generator. This parser operates on a simplified
- * TDPL (Top-Down Parsing Language). It supports *local* backtracking. As such,
- * this parser cannot be used to parse ambiguous grammar because expression rules
- * in productions are ordered and once one succeeds for a particular input the
- * other possibilities will never be attempted for that input.
- *
- * The parser starts by accumulating all of the tokens from the source text
- * into a large linked list.
- *
- * The parser then gets things started by pushing on a new stack frame
- * representing the application of the parser's starting production to the
- * the entire list of tokens, starting from the first token.
- *
- * At all times we maintain a pointer to where we are in the list of tokens.
- * This position can shift dramatically in the event that we don't match a
- * non/terminal and hence have to backtrack, or if we've previously matched
- * a production and hence have to jump ahead because we don't need to repeat
- * work that we've already done.
- *
- * All results from productions are cached. That is, if a production fails then
- * we cache that failure in the thunk table as a special pointer. If a production
- * succeeds then we cache its parse tree and where in the token list it ended.
- *
- * This parser produces a reduced concrete syntax tree (parse tree). It is
- * similar to an abstract syntax tree in that it is much smaller than a typical
- * parse tree and, for the most part, only contains information that is relevant
- * to semantic analysis. The reduced parse tree is created from the parse tree
- * by shaving off unnecessary nodes and by excluding non-useful tokens from the
- * tree itself.
- *
- * TODO: i) implement useful parse error reporting and recovery
- *       ii) allow for left-recursion, as described in the following article:
- *           http://portal.acm.org/citation.cfm?id=1328408.1328424
+ * Move 'n' tokens of an incremental parse, along with their intermediate
+ * results, from the slots starting at 'from' to the slots starting at 'to'. The
+ * ids of moved tokens that the moved results end at or looked at are moved too.
+ * Tokens that are moved across the gap have their input offsets changed to be
+ * from the other end of the input.
  */
-void parse_tokens(PGrammar *grammar,
-                  PScanner *scanner,
-                  PScannerFunc *scanner_fnc,
-                  void *state) {
+static void P_move_tokens(PParser *parser,
+                          uint32_t from,
+                          uint32_t to,
+                          uint32_t n,
+                          int is_crossing) {
+
+    P_TokenStore *store = &(parser->tokens);
+    P_MemoChunk results;
+    P_IntermediateResult *result;
 
-    PParser parser;
+    uint32_t i,
+             j,
+             src,
+             dest,
+             delta = to - from,
+             num_productions = parser->memo.num_productions;
+
+    for(i = 0; i < n; ++i) {
+
+        /* move the last tokens first if they're moved later on */
+        src = (to > from) ? (from + n - 1 - i) : (from + i);
+        dest = src + delta;
+
+        store->terminals[dest] = store->terminals[src];
+        store->lexeme_lengths[dest] = store->lexeme_lengths[src];
+        store->lexeme_offsets[dest] = store->lexeme_offsets[src];
+        store->input_offsets[dest] = is_crossing
+            ? store->input_length - store->input_offsets[src]
+            : store->input_offsets[src];
+        store->handles[dest] = store->handles[src];
+        store->slots[store->handles[dest]] = dest;
+
+        results = IR_get_chunk(parser, src, 0);
+        if(0 == delta || is_null(results)) {
+            continue;
+        }
 
-    P_Frame *frame = NULL,
-            *caller = NULL;
+        results += (src & P_MEMO_CHUNK_MASK) * num_productions;
 
-    P_IntermediateResult *intermediate_result = NULL,
-                         *temp_result = NULL;
+        for(j = 0; j < num_productions; ++j) {
+            if(is_null(result = results[j])) {
+                continue;
+            }
 
-    G_Symbol *symbol = NULL,
-             *next_symbol = NULL;
+            results[j] = NULL;
+            IR_shift(result, from, from + n, delta);
 
-    PParseTree *temp_parse_tree = NULL;
+            IR_get_chunk(parser, dest, 1)[
+                ((dest & P_MEMO_CHUNK_MASK) * num_productions) + j
+            ] = result;
 
-    PT_Terminal *token = NULL;
+            IR_raise(parser, dest, IR_REACH(result));
+        }
+    }
+}
 
-    /* useful counter, be it for hinting to GCC that a block shouldn't be
-     * optimized out, or for actually counting something. */
-    unsigned int j = 0;
+/**
+ * Bring the ids, lines and columns of the terminals in an incremental parse's
+ * tree up to date with where their tokens now are. Only the grammar actions
+ * that traverse the tree can see its terminals, and they visit all of them
+ * anyway, so nothing is done if the grammar has none.
+ */
+static void P_update_terminals(PParser *parser, PParseTree *tree) {
 
-    D( printf("initializing parser...\n"); )
+    P_TokenStore *store = &(parser->tokens);
+    G_ActionRules *action = parser->grammar->actions;
+    PTreeGenerator *gen;
+    PT_Terminal *terminal;
+    uint32_t i;
 
-    parser.tree_set = PTS_alloc();
+    while(is_not_null(action) && action->type == G_STATE_ACTION) {
+        action = action->next;
+    }
 
+    if(is_null(tree) || is_null(action)) {
+        return;
+    }
 
-    D( printf("accumulating tokens... \n"); )
+    gen = tree_generator_alloc((PTree *) tree, TREE_TRAVERSE_PREORDER);
 
-    /* get all of the tokens as terminal trees */
-    token = P_alloc_terminals(
-        scanner,
-        scanner_fnc,
-        parser.tree_set
-    );
+    while(generator_next(gen)) {
+        terminal = generator_current(gen);
+        if(((PParseTree *) terminal)->type != PT_TERMINAL) {
+            continue;
+        }
 
-    D( printf("%d tokens in memory, configuring... \n", PTS_size(parser.tree_set)); )
+        i = store->slots[terminal->token];
+        terminal->id = TS_INDEX(store, i);
 
-    /* minus one because we add in a token for EOF */
-    parser.num_tokens = PTS_size(parser.tree_set) - 1;
-    parser.farthest_id_reached = 0;
-    parser.call.frame = -1;
-    parser.must_backtrack = 0;
+        scanner_get_position(
+            parser->scanner,
+            TS_INPUT_OFFSET(store, i),
+            &(terminal->line),
+            &(terminal->column)
+        );
+    }
 
-    G_lock(grammar);
+    generator_free(gen);
+}
 
-    /* allocate the cache table */
-    parser.intermediate_results = mem_calloc(
-        (parser.num_tokens + 1) * grammar->num_productions,
-        sizeof(P_IntermediateResult *)
-    );
+/**
+ * Release every tree of an incremental parse that can't be reached from its
+ * last parse tree or from the cached results, then tenure the rest.
+ */
+static void P_collect_trees(PParser *parser) {
 
-    /* clear out the frame stack */
-    memset(parser.call.stack, 0, sizeof(P_Frame *) * P_MAX_RECURSION_DEPTH);
+    PTH_untenure(&(parser->trees));
 
-    /* get the starting production and push our first stack frame on. This
-     * involves registering the start of the token list as the farthest back
-     * we can backtrack.
-     */
-    D( printf("pushing production onto stack...\n"); )
+    if(is_not_null(parser->incremental.parse_tree)) {
+        PTH_mark(&(parser->trees), parser->incremental.parse_tree);
+    }
 
-    /* push on our first stack frame */
-    frame = F_push(
-        &parser,
-        grammar->production_rules + grammar->start_production_rule,
-        token
-    );
+    IR_mark(parser, 0);
+    PTH_sweep(&(parser->trees));
+    PTH_tenure(&(parser->trees));
 
-    D( printf("beginning main parse...\n"); )
+    parser->incremental.num_live_trees = parser->trees.num_tenured;
+}
 
-    while(0 <= parser.call.frame) {
+/**
+ * Parse some text in a way that lets it be quickly reparsed after it is edited
+ * with parser_reparse_text. The text is copied, so it can be freed or changed
+ * once this returns. The tokens and cached results are kept by the parser
+ * context until it is next used for a different kind of parse, and so is the
+ * parse tree given to the grammar actions.
+ *
+ * Returns 1 if the text was parsed, or 0 if it couldn't be, in which case the
+ * grammar actions are not performed. Either way the text can then be edited and
+ * reparsed.
+ */
+int parser_parse_text(PParser *parser,
+                      PGrammar *grammar,
+                      PScannerFunc *scanner_fnc,
+                      const unsigned char *text,
+                      uint32_t length,
+                      void *state) {
 
-parser_begin_loop:
+    PParseTree *parse_tree;
+    uint32_t i;
 
-        frame = parser.call.stack[j = parser.call.frame];
+    assert_not_null(parser);
+    assert_not_null(grammar);
+    assert_not_null(scanner_fnc);
+    assert_not_null(text);
 
-        D( printf("\nframe is %d=%p, phrase is %d, symbol is %d, at %d \n", j, (void *) frame, frame->production.phrase, frame->production.symbol, (int) parser.call.frame); )
+    G_lock(grammar);
 
-        /* get the cached result for the frame on the top of the stack */
-        intermediate_result = IR_get(
-            &parser,
-            frame->production.rule->production,
-            frame->backtrack_point->id
-        );
+    if(is_null(parser->incremental.scanner)) {
+        parser->incremental.scanner = scanner_alloc();
+    }
 
-        D( printf("intermediate result is %p. \n", (void *) intermediate_result); )
+    P_reset(parser, grammar, parser->incremental.scanner, scanner_fnc);
 
-        /* get the current symbol that we are looking at */
-        symbol = G_production_rule_get_symbol(
-            frame->production.rule,
-            frame->production.phrase,
-            frame->production.symbol
-        );
+    if(is_not_null(parser->incremental.text)) {
+        mem_free(parser->incremental.text);
+    }
 
-        D( printf("symbol is %p. \n", (void *) symbol); )
+    parser->incremental.text = mem_alloc(length + 1);
+    if(is_null(parser->incremental.text)) {
+        mem_error("Unable to copy the text to parse.");
+    }
 
-        /* an error occurred in the current frame. we need to pop it off, dump
-         * its parse tree, backtrack, and possibly cascade the failure upward.
-         */
-        if(parser.must_backtrack) {
+    memcpy(parser->incremental.text, text, length);
+    parser->incremental.length = length;
+    parser->incremental.is_enabled = 1;
 
-backtrack_raised:
+    /* scan all of the tokens, leaving their lexemes in the text. the scanner
+     * is left with the whole text so that it can find the positions of the
+     * tokens that end up in trees. */
+    scanner_use_text(parser->scanner, parser->incremental.text, length);
+    parser->tokens.input = parser->incremental.text;
 
-            /* make (mostly) sure that a phrase isn't found */
-            if(frame->production.is_committed) {
-                frame->production.phrase = (unsigned char) -1;
-                D( printf("Forcing production to commit. \n"); )
-            }
+    if(length > 0) {
+        scanner_flush(parser->scanner, 1);
 
-            /* there are no rules to backtrack to, we need to cascade the
-             * failure upward, dump the tree, and cache the failure.
-             */
-            j = G_production_rule_has_phrase(
-                frame->production.rule,
-                frame->production.phrase + 1
-            );
+        do {
+            i = P_pull_terminal(parser);
+        } while(TS_TERMINAL(&(parser->tokens), i) >= 0);
 
-            if(!j) {
+    } else {
+        TS_push(
+            &(parser->tokens),
+            -1,
+            (const unsigned char *) "EOF",
+            3,
+            0
+        );
+    }
 
-                /* trying to cascade off of the stack */
-                if(parser.call.frame == 0) {
-                    D( printf("parse error.\n"); )
-                    goto parse_error;
-                }
+    TS_alloc_handles(&(parser->tokens));
+    parser->tokens.input_length = length;
 
-                caller = parser.call.stack[j = parser.call.frame - 1];
-                temp_result = IR_get(
-                    &parser,
-                    caller->production.rule->production,
-                    caller->backtrack_point->id
-                );
+    parse_tree = P_parse(parser, grammar);
+    parser->incremental.parse_tree = parse_tree;
 
-                /* the next frame is left recursive */
-                if(caller->left_recursion.is_used
-                && intermediate_result->intermediate_tree != IR_FAILED
-                && temp_result->intermediate_tree != IR_FAILED) {
+    /* the trees are tenured as they are. the garbage among them is collected
+     * along with that of the reparses, once enough trees have been tenured. */
+    IR_build_reach(parser);
+    PTH_tenure(&(parser->trees));
+    parser->incremental.num_live_trees = parser->trees.num_tenured;
 
-stop_left_recursion:
+    if(is_not_null(parse_tree)) {
+        P_update_terminals(parser, parse_tree);
+        P_perform_grammar_actions(grammar, parse_tree, state);
+    }
 
-                    parser.must_backtrack = 0;
-                    token = temp_result->end_token;
+    G_unlock(grammar);
 
-                    if(caller->left_recursion.is_direct) {
+    return is_not_null(parse_tree);
+}
 
-                        /* we now have a problem: there could be another left-
-                         * recursive rule in the caller in its next phrase, or
-                         * the next phrase could be the caller's phrase is its
-                         * seed phrase. We make a fairly strong assumption here
-                         * that there are no left-recursive phrases defined
-                         * after the seed phrase. */
-                        if(caller->production.phrase + 1
-                        >= caller->left_recursion.seed_phrase) {
-                            goto cascading_backtrack;
-                        }
+/**
+ * Replace the characters in [start, end) of the text last given to
+ * parser_parse_text, or as last edited, with 'length' characters of 'text',
+ * then reparse the edited text and perform the grammar's actions on its parse
+ * tree. The previous parse tree is no longer valid.
+ *
+ * Returns 1 if the edited text was parsed, or 0 if it couldn't be, as happens
+ * while an edit is half done. The grammar actions are then not performed, and
+ * the parser context keeps the last parse tree that it made along with the
+ * edited tokens and whatever cached results are still good for them, so that
+ * the edits that follow are reparsed as usual.
+ *
+ * Only the tokens around the edit are scanned again: scanning starts two tokens
+ * before the edit, in case the edit changes how they end, and stops at the
+ * first token after the edit that matches a token of the old text. Cached
+ * results that didn't look at any of the re-scanned tokens are reused, and so
+ * the parser only redoes the productions that span the edit. Scanner functions
+ * that keep state between tokens in scanner->lexer_state must not be in the
+ * middle of such a state two tokens before an edit.
+ *
+ * The tokens are kept in a gap buffer, which is moved to the edit so that the
+ * re-scanned tokens are spliced in where they are. Only the tokens between the
+ * edit and where the gap was are moved, along with their cached results, and
+ * the ids of the tokens after the gap don't change. The cached results that
+ * looked at the re-scanned tokens are found with the reach tree, and only the
+ * trees made by this parse are swept, so the time taken grows with the size of
+ * the edit and of the productions that span it rather than with the size of the
+ * text.
+ */
+int parser_reparse_text(PParser *parser,
+                        uint32_t start,
+                        uint32_t end,
+                        const unsigned char *text,
+                        uint32_t length,
+                        void *state) {
+
+    P_TokenStore *store = &(parser->tokens),
+                 new_tokens;
+
+    PScanner *scanner = parser->incremental.scanner;
+    PGrammar *grammar = parser->grammar;
+    PParseTree *parse_tree;
+    P_IntermediateResult *result;
+    P_ResultKey *key;
+    G_Terminal term;
 
-                        --(parser.call.frame);
-                        caller->left_recursion.is_used = 0;
-                        caller->parse_tree = temp_result->intermediate_tree;
-                        ++(caller->production.symbol);
+    unsigned char *new_text;
 
-                    } else {
-                        frame->parse_tree = (
-                            intermediate_result->intermediate_tree
-                        );
+    uint32_t old_length = parser->incremental.length,
+             new_length,
+             first,
+             k,
+             i,
+             eof,
+             offset = 0,
+             input_offset,
+             gap_start = store->gap_start,
+             gap_length = store->gap_length;
 
-                        goto phrase_completed;
-                    }
+    assert_not_null(parser);
+    assert(parser->incremental.is_enabled);
+    assert(start <= end && end <= old_length);
+    assert(0 == store->first_id);
 
-                } else {
+    G_lock(grammar);
 
-cascading_backtrack:
+    /* find the first token that needs to be scanned again */
+    eof = store->end_id - gap_length - 1;
+    first = TS_find_offset(store, start);
+    first = (first > 2) ? first - 2 : 0;
 
-                    D( printf("cascading.\n"); )
+    /* splice the edit into the text */
+    new_length = old_length - (end - start) + length;
+    new_text = parser->incremental.text;
 
-                    --(parser.call.frame);
-                    intermediate_result->intermediate_tree = IR_FAILED;
+    if(new_length > old_length) {
+        new_text = mem_realloc(new_text, new_length + 1);
+        if(is_null(new_text)) {
+            mem_error("Unable to copy the text to parse.");
+        }
+    }
 
-                    /* parser.must_backtrack remains set to 1 and so the cascade is
-                     * automatic. */
+    memmove(new_text + start + length, new_text + end, old_length - end);
+    memcpy(new_text + start, text, length);
 
-                }
+    parser->incremental.text = new_text;
+    parser->incremental.length = new_length;
+    store->input = new_text;
 
-            /* there is at least one rule to backtrack to. */
-            } else {
+    /* scan the new tokens until the old ones are caught up with. the offsets
+     * of the old tokens are still those into the old text. */
+    TS_alloc(&new_tokens);
+    new_tokens.input = new_text;
 
-local_backtrack:
+    k = eof;
 
-                D( printf("backtracking.\n"); )
+    if(first > 0) {
+        offset = TS_INPUT_OFFSET(store, TS_SLOT(store, first));
+    }
 
-                parser.must_backtrack = 0;
+    if(offset < new_length) {
+        scanner_use_text(scanner, new_text + offset, new_length - offset);
+        scanner_flush(scanner, 1);
 
-                token = frame->backtrack_point;
+        for(k = first; (term = parser->scanner_fnc(scanner)) >= 0; ) {
 
-                ++(frame->production.phrase);
-                ++(((PT_NonTerminal *) frame->parse_tree)->phrase);
-                frame->production.symbol = 0;
+            input_offset = offset + scanner_get_lexeme_offset(scanner);
 
-                /* drop the branches of the parse tree */
-                tree_clear((PTree *) frame->parse_tree);
+            if(input_offset >= start + length) {
 
-                D( printf("new token is %p=%d %d (backtrack). \n", (void *) token, token->id, frame->backtrack_point->id); )
-            }
+                /* the offset of the same characters in the old text */
+                input_offset = input_offset - length + (end - start);
 
-        /* a production successfully matched all of the non/terminals in its
-         * current rule list. we need to pop it off, merge its parse tree into
-         * the parent frame's (calling production) parse tree, and then tell
-         * the parent frame to advance itself to the next non/terminal in its
-         * current rule list. if there is no parent frame then we have
-         * successfully parsed the tokens.
-         */
-        } else if(is_null(symbol)) {
+                while(k < eof
+                && TS_INPUT_OFFSET(store, TS_SLOT(store, k)) < input_offset) {
+                    ++k;
+                }
 
-phrase_completed:
+                i = TS_SLOT(store, k);
 
-            /* there are tokens to parse but we have a single frame on
-             * on stack. this is a parse error, so we will backtrack. */
-            if(parser.call.frame == 0 && token->id < parser.num_tokens) {
-                if(frame->left_recursion.is_used == 1) {
-                    goto grow_left_recursion;
+                if(k < eof
+                && TS_INPUT_OFFSET(store, i) == input_offset
+                && store->terminals[i] == term
+                && store->lexeme_lengths[i] == (uint32_t) (
+                    scanner->lexeme.end - scanner->lexeme.start
+                )) {
+                    break;
                 }
-                D( printf("no rules left to parse remaining tokens. \n"); )
-                parser.must_backtrack = 1;
-
-            /* we have parsed all of the tokens. there is no need to do any
-             * work on the stack or the cache. */
-            } else if(parser.call.frame == 0) {
+            }
 
-                D( printf("done parsing.\n"); )
-                goto done_parsing;
+            TS_push_lexeme(&new_tokens, term, scanner, offset);
+        }
 
-            /* we've fully matched a production rule  */
-            } else {
+        if(term < 0) {
+            k = eof;
+        }
+    }
 
-                D( printf("production succeeded.\n"); )
+    D( printf("re-scanned tokens [%d, %d) as [%d, %d). \n", first, k, first, first + new_tokens.end_id); )
 
-                D( printf(
-                    "token id %d, IR->fpr %d ***\n",
-                    token->id,
-                    intermediate_result->end_token->id
-                ); )
+    /* the results that the last reparse recorded are the only ones before the
+     * gap that can refer to tokens after it. if the gap is about to move past
+     * those tokens then the results are made to refer to where they will be. */
+    for(i = 0; i < parser->incremental.num_recorded; ++i) {
+        key = parser->incremental.recorded + i;
+        result = IR_find(parser, key);
+        if(is_null(result) || !result->is_recorded) {
+            continue;
+        }
 
-                caller = parser.call.stack[parser.call.frame - 1];
-                intermediate_result->is_being_retested = 0;
+        result->is_recorded = 0;
 
-                /* the production rule that we matched is the origin of left
-                 * recursion and its most recent application was successful. */
-                if(frame->left_recursion.is_used
-                && token->id > intermediate_result->end_token->id) {
+        if(first > gap_start && key->id < gap_start) {
+            IR_shift(
+                result,
+                gap_start + gap_length,
+                first + gap_length,
+                (uint32_t) -gap_length
+            );
+        }
+    }
 
-grow_left_recursion:
+    parser->incremental.num_recorded = 0;
+
+    /* move the gap forward to the first re-scanned token. the results that
+     * span the edit are found with the gap in place, so that the ones that are
+     * kept aren't moved afterwards. */
+    if(first > gap_start) {
+        P_move_tokens(
+            parser,
+            gap_start + gap_length,
+            gap_start,
+            first - gap_start,
+            1
+        );
+        store->gap_start = first;
+    }
 
-                    D( printf("\t growing left-recursion.\n"); )
+    /* release the results that looked at the re-scanned tokens, recording the
+     * ones that only end at the first of them, and then the results for the
+     * re-scanned tokens themselves */
+    IR_grow_reach(parser);
+    IR_release_spanning(
+        parser,
+        1,
+        0,
+        parser->incremental.num_reach,
+        TS_SLOT(store, first)
+    );
 
-                    intermediate_result->intermediate_tree = frame->parse_tree;
-                    intermediate_result->end_token = token;
+    for(i = first; i < k; ++i) {
+        IR_release_token(parser, TS_SLOT(store, i));
+    }
 
-                    frame->parse_tree = (PParseTree *) PT_alloc_non_terminal(
-                        frame->production.rule->production,
-                        2 /* TODO: start bigger? */
-                    );
+    /* or move the gap back to it, now that the results before it no longer
+     * refer to the tokens that it moves past */
+    if(first < gap_start) {
+        P_move_tokens(parser, first, first + gap_length, gap_start - first, 1);
+        store->gap_start = first;
+    }
 
-                    PTS_add(parser.tree_set, frame->parse_tree);
+    /* widen the gap over the tokens being replaced */
+    for(i = first; i < k; ++i) {
+        TS_free_handle(store, i + gap_length);
+    }
 
-                    /* re-start this frame */
-                    token = frame->backtrack_point;
-                    frame->production.phrase = 0;
-                    frame->production.symbol = 0;
+    store->gap_length = gap_length = gap_length + (k - first);
 
-                    if(!frame->left_recursion.is_direct) {
-                        intermediate_result->is_being_retested = 1;
-                    }
+    /* make the gap big enough for the new tokens. it's grown by as many tokens
+     * as there are outside of it, so that it doesn't need to be grown again
+     * until that many more tokens have been added. */
+    if(gap_length < new_tokens.end_id) {
+        i = new_tokens.end_id + (store->end_id - gap_length) - gap_length;
 
-                /* pop the production and advance to the next rule of the
-                 * calling production. */
-                } else {
+        if(store->end_id + i > store->capacity) {
+            TS_grow(
+                store,
+                (store->end_id + i > 2 * store->capacity)
+                    ? store->end_id + i
+                    : 2 * store->capacity
+            );
+        }
 
-pop_production_rule:
+        P_move_tokens(
+            parser,
+            first + gap_length,
+            first + gap_length + i,
+            store->end_id - (first + gap_length),
+            0
+        );
 
-                    D( printf("\t popping frame off of stack. \n"); )
+        store->end_id += i;
+        store->gap_length = gap_length = gap_length + i;
+    }
 
-                    intermediate_result->end_token = token;
-                    intermediate_result->intermediate_tree = frame->parse_tree;
-                    intermediate_result->is_being_retested = 0;
+    /* put the new tokens at the start of the gap */
+    for(i = 0; i < new_tokens.end_id; ++i) {
+        TS_put(
+            store,
+            first + i,
+            new_tokens.terminals[i],
+            TS_lexeme(&new_tokens, i),
+            new_tokens.lexeme_lengths[i],
+            new_tokens.input_offsets[i]
+        );
+        TS_new_handle(store, first + i);
+    }
 
-                    frame = parser.call.stack[j = --(parser.call.frame)];
-                    F_record_tree(frame, intermediate_result->intermediate_tree);
+    store->gap_start += new_tokens.end_id;
+    store->gap_length -= new_tokens.end_id;
+    store->input_length = new_length;
 
-                    ++(frame->production.symbol);
-                }
-            }
+    TS_free(&new_tokens);
 
-        /*} else if(token->id >= parser.num_tokens && symbol->is_terminal) {
+    /* the results recorded so far end at the first re-scanned token, and so
+     * now end at whatever token comes first after the edit */
+    for(i = 0; i < parser->incremental.num_recorded; ++i) {
+        key = parser->incremental.recorded + i;
+        result = IR_find(parser, key);
+        result->end_token = TS_SLOT(store, first);
+        IR_raise(parser, key->id, IR_REACH(result));
+    }
 
-end_of_input:
+    /* the positions of the tokens that end up in new trees are found in the
+     * whole of the edited text */
+    scanner_use_text(scanner, new_text, new_length);
 
-            D( printf("end of input with more tokens to parse, backtracking. \n"); )
-            parser.must_backtrack = 1;
-        */
-        } else {
+    /* parse the edited tokens */
+    P_reset_profile(parser, grammar);
+    parser->farthest_id_reached = 0;
+    parser->call.frame = -1;
+    parser->call.num_retained = 0;
+    parser->must_backtrack = 0;
+    parser->incremental.is_reparsing = 1;
+
+    parse_tree = P_parse(parser, grammar);
+    parser->incremental.is_reparsing = 0;
+
+    /* the trees made by this parse can only be reached from the parse tree or
+     * from the results that it recorded. the trees that are kept are tenured,
+     * and all of the trees are collected once enough of them have been. */
+    if(is_not_null(parse_tree)) {
+        parser->incremental.parse_tree = parse_tree;
+        PTH_mark(&(parser->trees), parse_tree);
+    }
 
-            /* accept any number of consecutive symbols */
-            while(symbol->is_cut) {
+    for(i = 0; i < parser->incremental.num_recorded; ++i) {
+        key = parser->incremental.recorded + i;
+        result = IR_find(parser, key);
 
-match_cut_symbol:
+        if(is_null(result)) {
+            continue;
 
-                D( printf("committing to phrase. \n"); )
+        } else if(IR_INITIAL == result->intermediate_tree) {
+            IR_remove(
+                parser,
+                IR_get_chunk(parser, key->id, 0),
+                ((key->id & P_MEMO_CHUNK_MASK) * parser->memo.num_productions)
+                  + (uint32_t) key->production
+            );
+            continue;
+        }
 
-                frame->production.is_committed = 1;
+        IR_raise(parser, key->id, IR_REACH(result));
 
-                symbol = G_production_rule_get_symbol(
-                    frame->production.rule,
-                    frame->production.phrase,
-                    ++(frame->production.symbol)
-                );
+        if(IR_FAILED != result->intermediate_tree) {
+            PTH_mark(&(parser->trees), result->intermediate_tree);
+        }
+    }
 
-                if(is_null(symbol)) {
-                    goto parser_begin_loop;
-                }
-            }
+    PTH_sweep(&(parser->trees));
+    PTH_tenure(&(parser->trees));
 
-            if(symbol->is_fail) {
+    if(parser->trees.num_tenured > 2 * parser->incremental.num_live_trees) {
+        P_collect_trees(parser);
+    }
 
-match_fail_symbol:
+    if(is_not_null(parse_tree)) {
+        P_update_terminals(parser, parse_tree);
+        P_perform_grammar_actions(grammar, parse_tree, state);
+    }
 
-                parser.must_backtrack = 1;
+    G_unlock(grammar);
 
-            /* the next non/terminal in the current rule list is a non-terminal,
-             * i.e. it is a production. we need to push the production onto the
-             * stack.
-             */
-            } else if(symbol->is_non_terminal) {
+    return is_not_null(parse_tree);
+}
 
-                D( printf("non-terminal symbol found. \n"); )
+/* -------------------------------------------------------------------------- */
 
-match_non_terminal_symbol:
+/**
+ * A parse with a direct-coded parser, which might be run on its own thread.
+ */
+typedef struct P_DirectParse {
 
-                intermediate_result = IR_get(
-                    &parser,
-                    symbol->value.non_terminal,
-                    token->id
-                );
+    PParser *parser;
+    PDirectParserFunc *start_fnc;
+    PParseTree *parse_tree;
 
-                /* we have already applied this production to this particular
-                 * place in the token stream. */
-                if(is_not_null(intermediate_result)) {
+} P_DirectParse;
 
-                    /* the cached result is a failure. time to backtrack. */
-                    if(IR_FAILED == intermediate_result->intermediate_tree) {
+/**
+ * Parse the tokens with a direct-coded parser, starting from the first token.
+ */
+static void *P_parse_direct(void *job_ptr) {
 
-                        D( printf("cached production failed.\n"); )
-                        parser.must_backtrack = 1;
+    P_DirectParse *job = job_ptr;
+    PParser *parser = job->parser;
 
-                    /* the cached result is missing, i.e. the cache value was
-                     * initialized by a production already on the stack but that
-                     * has (in)directly called itself through left recursion. */
-                    } else if(IR_INITIAL == intermediate_result->intermediate_tree) {
+    parser->token = parser->tokens.first_id;
+    parser->call.is_too_deep = 0;
 
-                        D( printf("detected left recursion. \n"); )
+    job->parse_tree = job->start_fnc(parser);
 
-                        intermediate_result->intermediate_tree = IR_FAILED;
+    return NULL;
+}
 
-                        D( printf("pushing production onto stack. \n"); )
+/**
+ * Parse the tokens from a token generator with a direct-coded parser that was
+ * generated by pgen, starting with the function of its start production. The
+ * grammar is only used for its actions, which are performed on the parse tree
+ * in the same way as with parse_tokens. Returns 1 if the tokens were parsed,
+ * and 0, without performing any actions, if they have a syntax error.
+ *
+ * Direct-coded parsers do not support left recursion and do not free anything
+ * behind a cut; everything is freed when the parser context is next reset.
+ *
+ * Direct-coded parsers nest on the C stack, and only as deep as the parser's
+ * stack has room for frames. A parse that needs to nest any deeper is started
+ * over with the parser's stack grown in the same way as it is for any other
+ * parse, on a thread with enough C stack for the new depth. The tokens scanned
+ * so far are kept. The parser's stack is kept by the parser context, so later
+ * parses with it start out with room for that depth.
+ */
+int parser_parse_tokens_direct(PParser *parser,
+                               PGrammar *grammar,
+                               PDirectParserFunc *start_fnc,
+                               PScanner *scanner,
+                               PScannerFunc *scanner_fnc,
+                               void *state) {
 
-                        frame = F_push(
-                            &parser,
-                            grammar->production_rules + symbol->value.non_terminal,
-                            token
-                        );
+    P_DirectParse job;
+    PParseTree *parse_tree;
+    pthread_t thread;
+    pthread_attr_t attributes;
 
-                        LR_mark_origin(&parser, intermediate_result);
+    assert_not_null(parser);
+    assert_not_null(start_fnc);
 
-                    /* indirect left recursion is special in that the production
-                     * rule used to get at the left-recursive call will have a
-                     * cached version that is not up-to-date with actual indirect
-                     * left-recursive call. To force the cache to update itself
-                     * we need to push the first
-                     */
-                    } else if(intermediate_result->uses_indirect_left_recursion
-                    && !intermediate_result->is_being_retested
-                    && parser.call.frame > 0) {
+    G_lock(grammar);
 
-                        caller = parser.call.stack[parser.call.frame - 1];
+    P_reset(parser, grammar, scanner, scanner_fnc);
 
-                        /* make sure that we are dealing with left recursion or
-                         * something equivalent to it. */
-                        if(caller->backtrack_point == token) {
+    /* get the first token */
+    P_pull_terminal(parser);
 
-                            D( printf("\t pushing on out-of-date cached result \n"); )
+    job.parser = parser;
+    job.start_fnc = start_fnc;
 
-                            intermediate_result->is_being_retested = 1;
+    for(;;) {
+        if(parser->call.capacity <= P_INITIAL_STACK_SIZE) {
+            P_parse_direct(&job);
 
-                            frame = F_push(
-                                &parser,
-                                grammar->production_rules + symbol->value.non_terminal,
-                                token
-                            );
+        } else {
+            pthread_attr_init(&attributes);
+            pthread_attr_setstacksize(
+                &attributes,
+                P_DIRECT_STACK_SIZE
+              + (parser->call.capacity * P_DIRECT_FRAME_STACK_SIZE)
+            );
 
-                        } else {
-                            goto cached_production_succeeded;
-                        }
+            if(0 != pthread_create(&thread, &attributes, &P_parse_direct, &job)) {
+                std_error("Internal Parser Error: Unable to create a thread.");
+            }
 
-                    /* the cached result was a success, we need to merge the
-                     * cached tree with our current parse tree, advance to the
-                     * next rewrite rule in our current rule list, and advance
-                     * our current position in the token list to the token after
-                     * the last token that was matched in the cached result.
-                     */
-                    } else {
+            pthread_join(thread, NULL);
+            pthread_attr_destroy(&attributes);
+        }
 
-cached_production_succeeded:
+        if(!parser->call.is_too_deep) {
+            break;
+        }
 
-                        D( printf("cached production succeeded.\n"); )
+        D( printf("direct-coded parser nested too deep, growing stack.\n"); )
 
-                        F_add_branch(
-                            frame,
-                            intermediate_result->intermediate_tree,
-                            symbol
-                        );
+        F_grow(parser);
 
-                        /* advance to a future token and to the next symbol */
-                        ++(frame->production.symbol);
+        arena_reset(parser->arena);
+        PTH_init(&(parser->trees), parser->arena);
+        IR_reset(parser, grammar);
+        P_reset_profile(parser, grammar);
+        parser->farthest_id_reached = 0;
+        parser->call.frame = -1;
+    }
 
-                        token = intermediate_result->end_token;
+    parse_tree = job.parse_tree;
 
-                        D( printf("new token is %p=%d (cached production). \n", (void *) token, token->id); )
-                    }
+    if(is_not_null(parse_tree)) {
+        P_perform_grammar_actions(grammar, parse_tree, state);
+    }
 
-                /* we do not have a cached result and so we will need to push a
-                 * new frame onto the stack. */
-                } else {
+    G_unlock(grammar);
 
-calling_production_symbol:
+    return is_not_null(parse_tree);
+}
 
-                    D( printf("pushing production onto stack.\n"); )
+/**
+ * Enter a production of a direct-coded parser at the current token. If the
+ * production has already been applied at this token then 1 is returned and the
+ * frame's parse tree is the cached tree, or NULL if the production failed. The
+ * production also fails if it would nest too deep. Otherwise the frame is set
+ * up to try the production's first phrase.
+ */
+int PD_enter(PParser *parser, P_DirectFrame *frame, G_NonTerminal production) {
 
-                    next_symbol = G_production_rule_get_symbol(
-                        frame->production.rule,
-                        frame->production.phrase,
-                        frame->production.symbol + 1
-                    );
+    G_ProductionRule *rule = parser->grammar->production_rules + production;
+    P_IntermediateResult *result = NULL;
+    unsigned int i;
 
-                    frame = F_push(
-                        &parser,
-                        grammar->production_rules + symbol->value.non_terminal,
-                        token
-                    );
-                }
+    if(P_IS_MEMOIZED(parser, production)) {
+        result = IR_get(parser, production, parser->token);
+    }
 
-            /* the next non/terminal in the current rule list is a terminal,
-             * i.e. it is a token. we need to try to match the current token
-             * against the symbol's token. if they match then we need to advance
-             * to the next rule and to the next token. if they do not match
-             * then we need to signal the frame to backtrack.
-             */
-            } else if(symbol->is_terminal) {
+    if(is_not_null(result)) {
 
-match_terminal_symbol:
+        /* pgen doesn't generate direct-coded parsers for left recursive
+         * grammars */
+        assert(IR_INITIAL != result->intermediate_tree);
 
-                D( printf("terminal symbol found. \n"); )
+        frame->parse_tree = NULL;
 
-                /* record the farthest point we've gotten to. */
-                if(token->id > parser.farthest_id_reached) {
-                    parser.farthest_id_reached = token->id;
-                }
+        if(IR_FAILED != result->intermediate_tree) {
+            P_COUNT(parser, production, P_PROFILE_MEMO_HITS);
+            frame->parse_tree = result->intermediate_tree;
+            parser->token = result->end_token;
+        } else {
+            P_COUNT(parser, production, P_PROFILE_MEMO_FAILURES);
+        }
 
-                /* we have matched a token, advance to the next token in the
-                 * list and the next rewrite rule in the current rule list.
-                 * also, store the matched token into the frame's partial parse
-                 * tree. */
-                if(token->terminal == symbol->value.terminal) {
+        return 1;
+    }
 
-                    D(
-                        if(is_not_null(token->lexeme)) {
-                            printf("\t matched: '%s' on line %d, column %d. \n", token->lexeme->str, token->line, token->column);
-                        } else {
-                            printf("\t matched. \n");
-                        }
-                    )
+    /* the production would nest deeper than the C stack has room for, so it
+     * fails, as does every other production from now on, and the parse is
+     * started over with more room. */
+    if(parser->call.is_too_deep
+    || (unsigned int) (parser->call.frame + 1) >= parser->call.capacity) {
+        parser->call.is_too_deep = 1;
+        frame->parse_tree = NULL;
+        return 1;
+    }
 
-                    /* store the match as a parse tree */
-                    if(symbol->is_non_excludable || !PT_ENABLE_TREE_REDUCTIONS) {
-                        F_add_branch(frame, (PParseTree *) token, symbol);
-                    }
+    i = ++(parser->call.frame);
 
-                    /* advance the token and phrase symbol */
-                    token = token->next;
+    P_COUNT(parser, production, P_PROFILE_MEMO_MISSES);
+    P_COUNT(parser, production, P_PROFILE_PUSHES);
+    P_COUNT_DEPTH(parser, i + 1);
 
-                    D( printf("new token is %p=%d (next). \n", (void *) token, token->id); )
+    frame->backtrack_point = parser->token;
+    frame->parse_tree = (PParseTree *) PT_alloc_non_terminal(
+        &(parser->trees),
+        production,
+        2 /* TODO: start bigger? */
+    );
+    frame->result = IR_create_for(parser, rule, parser->token);
+    frame->result->end_token = parser->token;
 
-                    ++(frame->production.symbol);
+    return 0;
+}
 
-                /* the tokens do not match, backtrack. */
-                } else {
+/**
+ * Start matching a phrase of a frame's production, going back to where the
+ * production started.
+ */
+void PD_phrase(PParser *parser, P_DirectFrame *frame, unsigned char phrase) {
+#if P_ENABLE_PROFILING
+    G_ProductionRule *rule = parser->grammar->production_rules + (
+        ((PT_NonTerminal *) frame->parse_tree)->production
+    );
 
-                    D(
-                        printf(
-                            "\t didn't match, expected:%d got:%d\n",
-                            (unsigned int) symbol->value.terminal,
-                            (unsigned int) token->terminal
-                        );
+    if(phrase > 0) {
+        P_COUNT(parser, rule->production, P_PROFILE_LOCAL_BACKTRACKS);
+        P_COUNT_PHRASE(parser, phrase_backtracks, rule, phrase - 1);
+    }
 
-                        if(is_not_null(token->lexeme)) {
-                            printf("\t lexeme is '%s', token->id is %d. \n", token->lexeme->str, token->id);
-                        } else {
-                            printf("\t token->id is %d. \n", token->id);
-                        }
-                    )
+    P_COUNT_PHRASE(parser, phrase_attempts, rule, phrase);
+#endif
 
-                    parser.must_backtrack = 1;
-                }
+    parser->token = frame->backtrack_point;
+    tree_clear((PTree *) frame->parse_tree);
+    ((PT_NonTerminal *) frame->parse_tree)->phrase = phrase;
+}
 
-            /* accept any number of consecutive epsilon transitions (match the
-             * empty string). */
-            } else if(symbol->is_epsilon_transition) {
+/**
+ * Accept the current token, which has already been compared against the
+ * terminal being matched, and advance to the next token.
+ */
+void PD_match(PParser *parser, P_DirectFrame *frame, G_TreeOp tree_op) {
+
+    if(tree_op != G_AUTO) {
+        P_add_branch(
+            parser,
+            frame->parse_tree,
+            P_alloc_terminal_tree(parser, parser->token),
+            1,
+            0
+        );
+    }
 
-match_epsilon_symbol:
+    if(parser->token > parser->farthest_id_reached) {
+        parser->farthest_id_reached = parser->token;
+    }
 
-                D( printf("\t epsilon symbol found. \n"); )
+    parser->token = P_next_terminal(parser, parser->token);
+}
 
-                do {
-                    if(symbol->is_non_excludable || !PT_ENABLE_TREE_REDUCTIONS) {
-                        temp_parse_tree = (PParseTree *) PT_alloc_epsilon();
-                        PTS_add(parser.tree_set, temp_parse_tree);
-                        F_add_branch(frame, temp_parse_tree, symbol);
-                    }
+/**
+ * Match the empty string.
+ */
+void PD_epsilon(PParser *parser, P_DirectFrame *frame, G_TreeOp tree_op) {
+    if(tree_op != G_AUTO) {
+        P_add_branch(
+            parser,
+            frame->parse_tree,
+            (PParseTree *) PT_alloc_epsilon(&(parser->trees)),
+            1,
+            0
+        );
+    }
+}
 
-                    /* get the next symbol */
-                    symbol = G_production_rule_get_symbol(
-                        frame->production.rule,
-                        frame->production.phrase,
-                        ++(frame->production.symbol)
-                    );
+/**
+ * Add the parse tree that a production returned to the frame's parse tree.
+ * Returns 0 if the production failed.
+ */
+int PD_non_terminal(PParser *parser,
+                    P_DirectFrame *frame,
+                    PParseTree *parse_tree,
+                    G_TreeOp tree_op) {
 
-                } while(is_not_null(symbol) && symbol->is_epsilon_transition);
-            } else {
-                std_error("Internal Parser Error: Strange conditions met.");
-            }
-        }
+    if(is_null(parse_tree)) {
+        return 0;
     }
 
-parse_error:
+    P_add_branch(
+        parser,
+        frame->parse_tree,
+        parse_tree,
+        tree_op == G_NON_EXCLUDABLE,
+        tree_op == G_RAISE_CHILDREN
+    );
 
-    /* TODO: do something more useful here. */
-    temp_parse_tree = NULL;
-    printf("A parse error occurred. \n");
-    exit(1);
+    return 1;
+}
 
-    goto return_from_parser;
+/**
+ * Add the parse tree that one attempt at matching a repeated or optional
+ * production returned to the frame's parse tree. The attempt started at the
+ * frame's repeat point. Returns 1 if the production should be tried again,
+ * i.e. it matched and consumed at least one token. If the production failed
+ * then the parser goes back to the repeat point.
+ */
+int PD_repeat(PParser *parser,
+              P_DirectFrame *frame,
+              PParseTree *parse_tree,
+              G_TreeOp tree_op) {
+
+    if(!PD_non_terminal(parser, frame, parse_tree, tree_op)) {
+        parser->token = frame->repeat_point;
+        return 0;
+    }
 
-done_parsing:
+    return parser->token > frame->repeat_point;
+}
 
-    D( printf("\n\nSuccessfully parsed. \n"); )
+/**
+ * Finish a frame whose current phrase has been matched and cache its result.
+ * The start production must match all of the tokens, so if it hasn't then 0
+ * is returned and the next phrase should be tried.
+ */
+int PD_succeed(PParser *parser, P_DirectFrame *frame) {
 
-    P_perform_grammar_actions(
-        grammar,
-        (PParseTree *) frame->parse_tree,
-        state
-    );
+    if(0 == parser->call.frame && PD_TERMINAL(parser) >= 0) {
+        D( printf("no rules left to parse remaining tokens. \n"); )
+        return 0;
+    }
 
-    G_unlock(grammar);
+    frame->result->end_token = parser->token;
+    frame->result->intermediate_tree = frame->parse_tree;
+    IR_release(parser, frame->result);
 
-clean_intermediate_results:
+    --(parser->call.frame);
 
-    D( printf("freeing resources... \n"); )
-    IR_free_all(&parser, grammar);
+    return 1;
+}
 
-clean_the_rest:
+/**
+ * Finish a frame whose phrases have all failed and cache the failure.
+ */
+PParseTree *PD_fail(PParser *parser, P_DirectFrame *frame) {
+#if P_ENABLE_PROFILING
+    G_ProductionRule *rule = parser->grammar->production_rules + (
+        ((PT_NonTerminal *) frame->parse_tree)->production
+    );
 
-    D( printf("intermediate results freed, freeing parser stack... \n"); )
-    PTS_free(parser.tree_set);
-    D( printf("garbage trees freed, freeing intermediate results... \n"); )
-    F_free_all(&parser);
-    D( printf("parser stack freed. \n"); )
+    P_COUNT(parser, rule->production, P_PROFILE_CASCADING_BACKTRACKS);
+    P_COUNT_PHRASE(parser, phrase_backtracks, rule, rule->num_phrases - 1);
+#endif
 
-    D(printf("returning parse tree...\n");)
+    frame->result->intermediate_tree = IR_FAILED;
+    IR_release(parser, frame->result);
 
-return_from_parser:
+    --(parser->call.frame);
 
-    return;
+    return NULL;
 }
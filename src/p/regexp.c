@@ -10,8 +10,8 @@
 
 #define NFA_MAX 256
 
-static unsigned int in_char_class = 0,
-                    first_char_in_class = 0;
+/* bits of the regular expression scanner's state */
+#define R_IN_CHAR_CLASS 1
 
 /* grammar terminals */
 enum {
@@ -321,7 +321,7 @@ static void Char(PThompsonsConstruction *thompson,
     } else {
         switch(term->terminal) {
             case L_CHARACTER:
-                the_char = term->lexeme->str[0];
+                the_char = PT_get_lexeme(term)->str[0];
                 break;
             case L_NEW_LINE:
                 the_char = 10;
@@ -374,8 +374,8 @@ static void R_char_class(PThompsonsConstruction *thompson,
         if(branches[i]->type == PT_NON_TERMINAL) {
 
             range = (PT_NonTerminal *) branches[i];
-            range_start = ((PT_Terminal *) tree_get_branch(range, 0))->lexeme->str[0];
-            range_end = ((PT_Terminal *) tree_get_branch(range, 1))->lexeme->str[0];
+            range_start = PT_get_lexeme((PT_Terminal *) tree_get_branch(range, 0))->str[0];
+            range_end = PT_get_lexeme((PT_Terminal *) tree_get_branch(range, 1))->str[0];
 
             for(; range_start <= range_end; ++range_start) {
                 fnc(set, range_start);
@@ -384,7 +384,7 @@ static void R_char_class(PThompsonsConstruction *thompson,
             term = (PT_Terminal *) branches[i];
             switch(term->terminal) {
                 case L_CHARACTER:
-                    fnc(set, term->lexeme->str[0]);
+                    fnc(set, PT_get_lexeme(term)->str[0]);
                     break;
                 case L_NEW_LINE:
                     fnc(set, 10);
@@ -592,7 +592,7 @@ static G_Terminal R_get_token(PScanner *scanner) {
     char curr_char;
     G_Terminal term;
 
-    scanner_skip(scanner, &isspace);
+    scanner_skip_space(scanner);
     scanner_mark_lexeme_start(scanner);
     curr_char = scanner_advance(scanner);
 
@@ -600,7 +600,7 @@ static G_Terminal R_get_token(PScanner *scanner) {
         return -1;
     }
 
-    if(in_char_class) {
+    if(scanner->lexer_state & R_IN_CHAR_CLASS) {
         goto any_char;
     }
 
@@ -609,8 +609,7 @@ static G_Terminal R_get_token(PScanner *scanner) {
         case ')': term = L_END_GROUP; break;
         case '[':
             term = L_START_CLASS;
-            in_char_class = 1;
-            first_char_in_class = 1;
+            scanner->lexer_state |= R_IN_CHAR_CLASS;
 
             if(scanner_look(scanner, 1) == '^') {
                 scanner_advance(scanner);
@@ -631,7 +630,8 @@ static G_Terminal R_get_token(PScanner *scanner) {
 any_char:
             switch(curr_char) {
                 case ']':
-                    term = L_END_CLASS; in_char_class = 0;
+                    term = L_END_CLASS;
+                    scanner->lexer_state &= ~R_IN_CHAR_CLASS;
                     break;
 
                 case '\\':
@@ -664,14 +664,14 @@ any_char:
                     }
 
                 default:
-                if(in_char_class && curr_char == '-') {
+                if((scanner->lexer_state & R_IN_CHAR_CLASS)
+                && curr_char == '-') {
                     term = L_CHARACTER_RANGE;
                 } else {
 all_chars:
                     term = L_CHARACTER;
                 }
             }
-            first_char_in_class = 0;
             break;
     }
 
@@ -693,7 +693,7 @@ static G_Terminal R_simple_get_token(PScanner *scanner) {
     char curr_char;
     G_Terminal term;
 
-    scanner_skip(scanner, &isspace);
+    scanner_skip_space(scanner);
     scanner_mark_lexeme_start(scanner);
     curr_char = scanner_advance(scanner);
 
@@ -1002,7 +1002,8 @@ PGrammar *regexp_grammar(void) {
  * then turn that NFA into a DFA using subset construction, then minimize the
  * DFA.
  */
-static unsigned int R_parse(PGrammar *grammar,
+static unsigned int R_parse(PParser *parser,
+                    PGrammar *grammar,
                     PScanner *scanner,
                     PNFA *nfa,
                     unsigned char *regexp,
@@ -1013,6 +1014,7 @@ static unsigned int R_parse(PGrammar *grammar,
     PThompsonsConstruction thom, *thompson = &thom;
     PNFA *dfa;
 
+    assert_not_null(parser);
     assert_not_null(grammar);
     assert_not_null(scanner);
     assert_not_null(regexp);
@@ -1024,12 +1026,16 @@ static unsigned int R_parse(PGrammar *grammar,
 
     scanner_flush(scanner, 1);
 
-    parse_tokens(
+    if(!parser_parse_tokens(
+        parser,
         grammar,
         scanner,
         scanner_fnc,
         (void *) thompson
-    );
+    )) {
+        printf("Unable to parse the regular expression '%s'. \n", regexp);
+        std_error("Regexp Error: Malformed regular expression.");
+    }
 
     if(!thom.top_state) {
         return 0;
@@ -1042,19 +1048,19 @@ static unsigned int R_parse(PGrammar *grammar,
 }
 
 /**
- * Parse a regular expression according to the POSIX rules.
+ * Parse a regular expression according to the POSIX rules. The parser context
+ * can be re-used across many calls.
  */
-unsigned int regexp_parse(PGrammar *grammar,
+unsigned int regexp_parse(PParser *parser,
+                          PGrammar *grammar,
                           PScanner *scanner,
                           PNFA *nfa,
                           unsigned char *regexp,
                           unsigned int start_state,
                           G_Terminal terminal) {
 
-    in_char_class = 0;
-    first_char_in_class = 0;
-
     return R_parse(
+        parser,
         grammar,
         scanner,
         nfa,
@@ -1069,13 +1075,15 @@ unsigned int regexp_parse(PGrammar *grammar,
  * Parse a string as a regular expression, i.e. parse it as the concatenation
  * of all of the characters.
  */
-unsigned int regexp_parse_cat(PGrammar *grammar,
+unsigned int regexp_parse_cat(PParser *parser,
+                              PGrammar *grammar,
                               PScanner *scanner,
                               PNFA *nfa,
                               unsigned char *regexp,
                               unsigned int start_state,
                               G_Terminal terminal) {
     return R_parse(
+        parser,
         grammar,
         scanner,
         nfa,
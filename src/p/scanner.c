@@ -14,6 +14,19 @@
  */
 
 #include <p-scanner.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* whitespace is skipped and newlines are indexed a block at a time with vector
+ * instructions if they are available. the count-trailing-zeros builtin is
+ * needed to go through the bit masks that they make. */
+#if defined(__GNUC__) && defined(__AVX2__)
+#   include <immintrin.h>
+#   define S_USE_AVX2 1
+#elif defined(__GNUC__) && defined(__SSE2__)
+#   include <emmintrin.h>
+#   define S_USE_SSE2 1
+#endif
 
 #ifdef MSDOS
 #   define COPY(d,s,a) memmove(d,s,a)
@@ -25,26 +38,42 @@
 #   define O_BINARY 0
 #endif
 
+#ifndef MAP_ANONYMOUS
+#   define MAP_ANONYMOUS MAP_ANON
+#endif
+
 /* -------------------------------------------------------------------------- */
 
 #define MIN(a,b) (((a) < (b)) ? (a) : (b))
 
 #define NO_MORE_CHARS(s) \
-    ((s)->input.eof_read && (s)->buffer.next_char > (s)->buffer.end)
+    ((s)->input.eof_read && (s)->buffer.next_char >= (s)->buffer.end)
 
 #define PAST_FLUSH_POINT(s) \
     ((s)->buffer.next_char >= ((s)->buffer.end - S_MAX_LOOKAHEAD))
 
+/* the characters that isspace accepts in the "C" locale */
+#define IS_SPACE(c) (' ' == (c) || (unsigned char) ((c) - '\t') < 5)
+
+/* whether or not the character c is in the set of a run */
+#define IN_RUN(run, c) \
+    ((c) < 128 && 0 != (((run)->low_nibbles[(c) & 15] >> ((c) >> 4)) & 1))
+
 /* -------------------------------------------------------------------------- */
 
 /**
- * Close any open file descriptors.
+ * Close any open file descriptors and unmap any mapped file.
  */
 static void I_close(PScanner *scanner) {
     if(-1 != scanner->input.file_descriptor) {
         close(scanner->input.file_descriptor);
         scanner->input.file_descriptor = -1;
     }
+
+    if(is_not_null(scanner->input.map)) {
+        munmap(scanner->input.map, scanner->input.map_length);
+        scanner->input.map = NULL;
+    }
 }
 
 /**
@@ -57,6 +86,72 @@ static int I_read(PScanner *scanner, unsigned char *start, int how_much) {
 
 /* -------------------------------------------------------------------------- */
 
+/**
+ * Add the offset of a newline to the scanner's newline index.
+ */
+static void I_add_newline(PScanner *scanner, uint32_t offset) {
+    if(scanner->input.num_newlines >= scanner->input.newlines_capacity) {
+        scanner->input.newlines_capacity *= 2;
+        scanner->input.newlines = mem_realloc(
+            scanner->input.newlines,
+            scanner->input.newlines_capacity * sizeof(uint32_t)
+        );
+        if(is_null(scanner->input.newlines)) {
+            mem_error("Unable to grow the scanner's newline index.");
+        }
+    }
+
+    scanner->input.newlines[(scanner->input.num_newlines)++] = offset;
+}
+
+/**
+ * Add the newlines among 'length' characters of input, the first of which is
+ * at 'offset' into the input, to the scanner's newline index. Whole blocks of
+ * characters are looked at at once where vector instructions are available.
+ */
+static void I_index_newlines(PScanner *scanner,
+                             const unsigned char *chars,
+                             uint32_t length,
+                             uint32_t offset) {
+    uint32_t i = 0;
+
+#if defined(S_USE_AVX2)
+    const __m256i newline = _mm256_set1_epi8('\n');
+    unsigned int newlines;
+
+    for(; i + 32 <= length; i += 32) {
+        newlines = (unsigned int) _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+            _mm256_loadu_si256((const __m256i *) (chars + i)),
+            newline
+        ));
+        for(; newlines; newlines &= newlines - 1) {
+            I_add_newline(scanner, offset + i + __builtin_ctz(newlines));
+        }
+    }
+#elif defined(S_USE_SSE2)
+    const __m128i newline = _mm_set1_epi8('\n');
+    unsigned int newlines;
+
+    for(; i + 16 <= length; i += 16) {
+        newlines = (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(
+            _mm_loadu_si128((const __m128i *) (chars + i)),
+            newline
+        ));
+        for(; newlines; newlines &= newlines - 1) {
+            I_add_newline(scanner, offset + i + __builtin_ctz(newlines));
+        }
+    }
+#endif
+
+    for(; i < length; ++i) {
+        if('\n' == chars[i]) {
+            I_add_newline(scanner, offset + i);
+        }
+    }
+
+    scanner->input.num_indexed = offset + length;
+}
+
 /**
  * Fill up the buffer, starting from 'starting_from' until the end of the buffer.
  * If this is the first fill of the buffer then it starts at the second
@@ -71,7 +166,7 @@ static int B_fill(PScanner *scanner, unsigned char *starting_from) {
         got,
         total;
 
-    unsigned char *end = scanner->buffer.end;
+    unsigned char *end = scanner->buffer.data + S_INPUT_BUFFER_SIZE;
 
     /*
     if(!scanner->input.line) {
@@ -114,6 +209,17 @@ static int B_fill(PScanner *scanner, unsigned char *starting_from) {
 
     scanner->buffer.end = starting_from + got;
 
+    /* the characters will be flushed out of the buffer eventually, so their
+     * newlines need to be indexed now. */
+    I_index_newlines(
+        scanner,
+        scanner->buffer.end - total,
+        (uint32_t) total,
+        scanner->input.num_read
+    );
+
+    scanner->input.num_read += total;
+
     return total;
 }
 
@@ -127,6 +233,25 @@ PScanner *scanner_alloc(void) {
     if(is_null(scanner)) {
         mem_error("Unable to heap-allocate a new scanner.");
     }
+
+    /* nothing is open yet, so nothing should be closed when the scanner is
+     * first given input. */
+    scanner->input.file_descriptor = -1;
+    scanner->input.text = NULL;
+    scanner->input.map = NULL;
+    scanner->input.num_newlines = 0;
+    scanner->input.num_indexed = 0;
+    scanner->input.newlines_capacity = S_INPUT_BUFFER_SIZE / 16;
+    scanner->input.newlines = mem_alloc(
+        scanner->input.newlines_capacity * sizeof(uint32_t)
+    );
+    scanner->buffer.start = scanner->buffer.data;
+    scanner->lexer_state = 0;
+
+    if(is_null(scanner->input.newlines)) {
+        mem_error("Unable to heap-allocate a new scanner.");
+    }
+
     return scanner;
 }
 
@@ -136,30 +261,21 @@ PScanner *scanner_alloc(void) {
 void scanner_free(PScanner *scanner) {
     assert_not_null(scanner);
     I_close(scanner);
+    mem_free(scanner->input.newlines);
     mem_free(scanner);
 }
 
 /**
- * Open a new file for the scanner to use. If the file cannot be opened then
- * 0 is returned, else 1.
+ * Get the scanner's buffer ready for new input. This means putting the end of
+ * the buffer just *after* the actual end of the buffer, setting the starting
+ * flush point, and making sure any lexeme information that exists in the
+ * scanner already has been cleared out.
  */
-int scanner_use_file(PScanner *scanner, const char *file_name) {
+static void B_reset(PScanner *scanner) {
 
-    int file_descriptor;
-    unsigned char *end_of_buffer;
-
-    assert_not_null(scanner);
-    assert_not_null(file_name);
-
-    /* close any file that was previously open. */
-    I_close(scanner);
-
-    /* prepare the scanner's buffer for this file. this means putting the end of
-     * the buffer just *after* the actual end of the buffer, setting the
-     * starting flush point, and making sure any lexeme information that exists
-     * in the scanner already has been cleared out. */
-    end_of_buffer = scanner->buffer.start + S_INPUT_BUFFER_SIZE;
+    unsigned char *end_of_buffer = scanner->buffer.data + S_INPUT_BUFFER_SIZE;
 
+    scanner->buffer.start = scanner->buffer.data;
     scanner->buffer.end = end_of_buffer;
     scanner->buffer.flush_point = (end_of_buffer - S_MAX_LOOKAHEAD);
     scanner->buffer.next_char = end_of_buffer;
@@ -169,9 +285,57 @@ int scanner_use_file(PScanner *scanner, const char *file_name) {
     scanner->lexeme.start = end_of_buffer;
     scanner->lexeme.as_string = NULL;
 
-    scanner->input.column = 1;
+    scanner->input.column = 0;
     scanner->input.line = 0;
     scanner->input.eof_read = 0;
+    scanner->input.text = NULL;
+    scanner->input.num_newlines = 0;
+    scanner->input.num_indexed = 0;
+    scanner->input.num_read = 0;
+
+    scanner->lexer_state = 0;
+}
+
+/**
+ * Have the scanner scan 'length' characters in memory in place instead of
+ * through its buffer. The characters are all read at once and are never
+ * flushed, and they double as the scanner's text so that lexemes can refer to
+ * them. Because they stay in memory, their newlines are only indexed once a
+ * position among them is asked for.
+ */
+static void B_use_span(PScanner *scanner,
+                       unsigned char *start,
+                       uint32_t length) {
+
+    scanner->buffer.start = start;
+    scanner->buffer.end = start + length;
+    scanner->buffer.flush_point = scanner->buffer.end;
+    scanner->buffer.next_char = start;
+    scanner->buffer.allowed_to_flush = 0;
+
+    scanner->lexeme.start = scanner->buffer.end;
+    scanner->lexeme.end = scanner->buffer.end;
+
+    scanner->input.eof_read = 1;
+    scanner->input.num_read = length;
+    scanner->input.text = start;
+}
+
+/**
+ * Open a new file for the scanner to use. If the file cannot be opened then
+ * 0 is returned, else 1.
+ */
+int scanner_use_file(PScanner *scanner, const char *file_name) {
+
+    int file_descriptor;
+
+    assert_not_null(scanner);
+    assert_not_null(file_name);
+
+    /* close any file that was previously open. */
+    I_close(scanner);
+
+    B_reset(scanner);
 
     /* open the file, if the fail opens then */
     file_descriptor = open(file_name, O_RDONLY | O_BINARY);
@@ -185,46 +349,127 @@ int scanner_use_file(PScanner *scanner, const char *file_name) {
 }
 
 /**
- * Have the scanner take its contents from a string in memory. 1 is returned
- * automatically.
- *
- * This expects a null-terminated string.
+ * Have the scanner read its contents from 'length' characters of text in
+ * memory. The text is scanned in place, without being copied, and so it can be
+ * of any length and need not be null-terminated, but it must not change while
+ * it is being scanned. The lexemes of tokens scanned from the text refer to
+ * its characters as well, so it must also outlive any parse trees made from
+ * them. 1 is returned automatically.
  */
-int scanner_use_string(PScanner *scanner, unsigned char *string) {
-    unsigned char *s = string,
-                  *b = scanner->buffer.start;
-    const unsigned char *be = b + S_INPUT_BUFFER_SIZE;
+int scanner_use_text(PScanner *scanner,
+                     const unsigned char *text,
+                     uint32_t length) {
+
+    assert_not_null(scanner);
+    assert_not_null(text);
+
+    I_close(scanner);
+
+    B_reset(scanner);
+
+    /* the scanner never writes to its input when scanning it in place */
+    B_use_span(scanner, (unsigned char *) text, length);
+
+    return 1;
+}
+
+/**
+ * Map a file into memory for the scanner to use. The whole file is scanned in
+ * place as a single buffer that is followed by a null character and that is
+ * never flushed, and so there is no limit on the length of its lexemes. As with
+ * scanner_use_text, lexemes refer to the file's characters instead of copying
+ * them; the file stays mapped until the scanner is given other input or freed,
+ * and so the scanner must outlive any parse trees made from it. If the file
+ * cannot be opened or mapped then 0 is returned, else 1.
+ */
+int scanner_use_mmap(PScanner *scanner, const char *file_name) {
+
+    int file_descriptor;
+    struct stat info;
+    size_t page_size,
+           map_length;
+    unsigned char *map;
 
     assert_not_null(scanner);
+    assert_not_null(file_name);
 
-    /* copy as much of the string into the buffer as we can. */
-    for(; *s && b < be; ++s, ++b) {
-        *b = *s;
+    I_close(scanner);
+
+    B_reset(scanner);
+
+    file_descriptor = open(file_name, O_RDONLY | O_BINARY);
+    if(-1 == file_descriptor) {
+        return 0;
     }
 
-    if(*s && b >= be) {
-        std_error("Internal Scanner Error: String cannot fit into buffer.");
+    if(-1 == fstat(file_descriptor, &info)
+    || info.st_size < 0
+    || (uintmax_t) info.st_size >= UINT32_MAX) {
+        close(file_descriptor);
+        return 0;
     }
 
-    /* add in the null character */
-    if(b < be) {
-        *b = 0;
-        ++b;
+    /* reserve room for the file and at least one more character. the file is
+     * then mapped over the start of the reserved pages so that whatever follows
+     * it, whether the rest of its last page or the next page, reads as null
+     * characters. */
+    page_size = (size_t) sysconf(_SC_PAGESIZE);
+    map_length = (((size_t) info.st_size / page_size) + 1) * page_size;
+
+    map = mmap(
+        NULL,
+        map_length,
+        PROT_READ,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0
+    );
+
+    if(MAP_FAILED == map) {
+        close(file_descriptor);
+        return 0;
     }
 
-    scanner->buffer.end = b;
-    scanner->buffer.flush_point = b;
-    scanner->buffer.next_char = scanner->buffer.start;
-    scanner->buffer.allowed_to_flush = 0;
+    if(info.st_size > 0 && MAP_FAILED == mmap(
+        map,
+        (size_t) info.st_size,
+        PROT_READ,
+        MAP_PRIVATE | MAP_FIXED,
+        file_descriptor,
+        0
+    )) {
+        munmap(map, map_length);
+        close(file_descriptor);
+        return 0;
+    }
 
-    scanner->input.column = 1;
-    scanner->input.line = 0;
-    scanner->input.eof_read = 0;
-    scanner->input.file_descriptor = -1;
+    close(file_descriptor);
 
-    scanner->lexeme.end = b;
-    scanner->lexeme.start = b;
-    scanner->lexeme.as_string = NULL;
+    scanner->input.map = map;
+    scanner->input.map_length = map_length;
+
+    B_use_span(scanner, map, (uint32_t) info.st_size);
+
+    return 1;
+}
+
+/**
+ * Have the scanner take its contents from a string in memory. 1 is returned
+ * automatically.
+ *
+ * This expects a null-terminated string, which is scanned in place along with
+ * its null character, as with scanner_use_text.
+ */
+int scanner_use_string(PScanner *scanner, unsigned char *string) {
+
+    assert_not_null(scanner);
+    assert_not_null(string);
+
+    I_close(scanner);
+
+    B_reset(scanner);
+
+    B_use_span(scanner, string, (uint32_t) strlen((char *) string) + 1);
 
     return 1;
 }
@@ -299,10 +544,10 @@ int scanner_flush(PScanner *scanner, int force_flush) {
 /**
  * Return the next input character in the buffer and then advance the buffer
  * past it. Returns 0 if end-of-file is reached. Returns -1 if the buffer is
- * too full to be flushed.
+ * too full to be flushed. Lines and columns aren't kept track of here; see
+ * scanner_get_position.
  */
 char scanner_advance(PScanner *scanner) {
-    char next;
 
     if(NO_MORE_CHARS(scanner)) {
         return 0;
@@ -312,15 +557,7 @@ char scanner_advance(PScanner *scanner) {
         return -1;
     }
 
-    next = *(scanner->buffer.next_char);
-    if('\n' == next) {
-        ++(scanner->input.line);
-        scanner->input.column = 0;
-    }
-
-    ++(scanner->buffer.next_char);
-
-    return next;
+    return *((scanner->buffer.next_char)++);
 }
 
 /**
@@ -355,43 +592,16 @@ int scanner_pushback(PScanner *scanner, int n) {
     unsigned char *curr_lexeme_start = scanner->lexeme.start,
                   *next_char = scanner->buffer.next_char;
 
-    unsigned int new_line = scanner->input.line,
-                 new_column;
-
     /* backtrack in the buffer */
     while(--n >= 0 && next_char > curr_lexeme_start) {
         --next_char;
 
-        if('\n' == *next_char) {
-            --new_line;
-        } else if('\0' == *next_char) {
+        if('\0' == *next_char) {
             break;
         }
     }
 
-    /* figure out what column we're looking at on whatever line we have ended
-     * up on. */
-    if(new_line == scanner->lexeme.line) {
-        new_column = (next_char - curr_lexeme_start)
-                   + scanner->lexeme.column;
-
-    } else if(new_line == scanner->input.line) {
-        new_column = scanner->input.column
-                   - (scanner->buffer.next_char - next_char);
-    } else {
-        /* the annoying case: we are *somewhere*, and we don't know where. what
-         * we do know is that we are in-between where we have pushed back to and
-         * the start of the current lexeme. we are neither on the same line as
-         * where we were, nor are we on the same line as where the lexeme
-         * started and so we just need to find the next '\n'.
-         */
-        for(new_column = 0; '\n' != *(next_char - new_column); ++new_column)
-            ;
-    }
-
     scanner->buffer.next_char = next_char;
-    scanner->input.line = new_line;
-    scanner->input.column = new_column;
 
     if(next_char < scanner->lexeme.end) {
         scanner->lexeme.end = next_char;
@@ -400,6 +610,337 @@ int scanner_pushback(PScanner *scanner, int n) {
     return (-1 == n);
 }
 
+/**
+ * Skip the whitespace characters in [next, stop) of the buffer and return a
+ * pointer to the first character that isn't whitespace, or 'stop'. Whole blocks
+ * of characters are looked at at once where vector instructions are available.
+ */
+static unsigned char *B_skip_space(unsigned char *next, unsigned char *stop) {
+
+#if defined(S_USE_AVX2)
+    const __m256i space = _mm256_set1_epi8(' '),
+                  tab = _mm256_set1_epi8('\t'),
+                  four = _mm256_set1_epi8(4);
+    __m256i block,
+            controls;
+    unsigned int spaces;
+
+    for(; next + 32 <= stop; next += 32) {
+        block = _mm256_loadu_si256((const __m256i *) next);
+
+        /* \t, \n, \v, \f and \r are the characters within four of \t */
+        controls = _mm256_sub_epi8(block, tab);
+        controls = _mm256_cmpeq_epi8(_mm256_min_epu8(controls, four), controls);
+
+        spaces = (unsigned int) _mm256_movemask_epi8(_mm256_or_si256(
+            controls,
+            _mm256_cmpeq_epi8(block, space)
+        ));
+
+        if(0xFFFFFFFFU != spaces) {
+            return next + __builtin_ctz(~spaces);
+        }
+    }
+#elif defined(S_USE_SSE2)
+    const __m128i space = _mm_set1_epi8(' '),
+                  tab = _mm_set1_epi8('\t'),
+                  four = _mm_set1_epi8(4);
+    __m128i block,
+            controls;
+    unsigned int spaces;
+
+    for(; next + 16 <= stop; next += 16) {
+        block = _mm_loadu_si128((const __m128i *) next);
+
+        /* \t, \n, \v, \f and \r are the characters within four of \t */
+        controls = _mm_sub_epi8(block, tab);
+        controls = _mm_cmpeq_epi8(_mm_min_epu8(controls, four), controls);
+
+        spaces = (unsigned int) _mm_movemask_epi8(_mm_or_si128(
+            controls,
+            _mm_cmpeq_epi8(block, space)
+        ));
+
+        if(0xFFFFU != spaces) {
+            return next + __builtin_ctz(~spaces & 0xFFFFU);
+        }
+    }
+#endif
+
+    /* finish off what is left, if anything, one character at a time */
+    for(; next < stop && IS_SPACE(*next); ++next)
+        ;
+
+    return next;
+}
+
+/**
+ * Skip over whitespace in the input. This does the same as scanner_skip with
+ * isspace as its predicate, but it runs through the buffer directly instead of
+ * looking at and advancing past one character at a time; only the last few
+ * characters before the buffer needs to be flushed are advanced past one by
+ * one.
+ */
+void scanner_skip_space(PScanner *scanner) {
+
+    unsigned char *next,
+                  *stop;
+
+    assert_not_null(scanner);
+
+    for(;;) {
+        next = scanner->buffer.next_char;
+        stop = scanner->buffer.end;
+
+        if(!scanner->input.eof_read) {
+            stop -= S_MAX_LOOKAHEAD;
+        }
+
+        if(next < stop) {
+            next = B_skip_space(next, stop);
+            scanner->buffer.next_char = next;
+
+            if(next < stop) {
+                return;
+            }
+        }
+
+        if(!IS_SPACE(scanner_look(scanner, 1))
+        || scanner_advance(scanner) <= 0) {
+            return;
+        }
+    }
+}
+
+/**
+ * Skip the characters in [next, stop) of the buffer that are in the set of a
+ * run and return a pointer to the first character that isn't, or 'stop'. With
+ * AVX2, the set's bitmap is looked up for a whole block of characters at once
+ * by shuffling on the low and high halves of each character. With SSE2, blocks
+ * are compared against the set's ranges, if it has few enough of them.
+ */
+static unsigned char *B_skip_run(const PScannerRun *run,
+                                 unsigned char *next,
+                                 unsigned char *stop) {
+
+#if defined(S_USE_AVX2)
+    const __m256i low_nibbles = _mm256_broadcastsi128_si256(
+                      _mm_loadu_si128((const __m128i *) run->low_nibbles)
+                  ),
+                  high_bits = _mm256_setr_epi8(
+                      1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0,
+                      1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0
+                  ),
+                  fifteen = _mm256_set1_epi8(15),
+                  zero = _mm256_setzero_si256();
+    __m256i block,
+            found;
+    unsigned int outside;
+
+    for(; next + 32 <= stop; next += 32) {
+        block = _mm256_loadu_si256((const __m256i *) next);
+
+        /* characters of 128 and above have a high half of 8 or more, which
+         * selects no bit, and so they are never in the set. */
+        found = _mm256_and_si256(
+            _mm256_shuffle_epi8(low_nibbles, _mm256_and_si256(block, fifteen)),
+            _mm256_shuffle_epi8(high_bits, _mm256_and_si256(
+                _mm256_srli_epi16(block, 4),
+                fifteen
+            ))
+        );
+
+        outside = (unsigned int) _mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(found, zero)
+        );
+
+        if(0 != outside) {
+            return next + __builtin_ctz(outside);
+        }
+    }
+#elif defined(S_USE_SSE2)
+    __m128i block,
+            offset,
+            found;
+    unsigned int inside,
+                 i;
+
+    if(run->num_ranges > 0) {
+        for(; next + 16 <= stop; next += 16) {
+            block = _mm_loadu_si128((const __m128i *) next);
+            found = _mm_setzero_si128();
+
+            /* c is in [first, first + span] if c - first is at most span */
+            for(i = 0; i < run->num_ranges; ++i) {
+                offset = _mm_sub_epi8(block, _mm_set1_epi8(
+                    (char) run->ranges[i][0]
+                ));
+                found = _mm_or_si128(found, _mm_cmpeq_epi8(
+                    _mm_min_epu8(offset, _mm_set1_epi8(
+                        (char) run->ranges[i][1]
+                    )),
+                    offset
+                ));
+            }
+
+            inside = (unsigned int) _mm_movemask_epi8(found);
+
+            if(0xFFFFU != inside) {
+                return next + __builtin_ctz(~inside & 0xFFFFU);
+            }
+        }
+    }
+#endif
+
+    /* finish off what is left, if anything, one character at a time */
+    for(; next < stop && IN_RUN(run, *next); ++next)
+        ;
+
+    return next;
+}
+
+/**
+ * Skip over a run of characters that are in the set of 'run' and return the
+ * number of characters skipped. Scanner functions call this in states that
+ * loop on themselves, so that, e.g., the body of an identifier is matched
+ * without advancing one character at a time. Like scanner_skip_space, this
+ * stops short of where the buffer would need to be flushed; the scanner
+ * function advances past any characters of the run that are left.
+ */
+uint32_t scanner_skip_run(PScanner *scanner, const PScannerRun *run) {
+
+    unsigned char *next = scanner->buffer.next_char,
+                  *stop = scanner->buffer.end;
+
+    if(!scanner->input.eof_read) {
+        stop -= S_MAX_LOOKAHEAD;
+    }
+
+    if(next >= stop) {
+        return 0;
+    }
+
+    stop = B_skip_run(run, next, stop);
+    scanner->buffer.next_char = stop;
+
+    return (uint32_t) (stop - next);
+}
+
+/**
+ * Refill the buffer for a scanner function that reads characters through its
+ * own cursor into the buffer instead of through scanner_advance. The cursor is
+ * written back to the scanner before a flush, so that it is moved along with
+ * the lexeme, and the possibly moved cursor is returned. The limit is set to
+ * how far the cursor can go before it needs to be refilled again; if the
+ * limit is not past the returned cursor then there are no characters left.
+ */
+unsigned char *scanner_refill(PScanner *scanner,
+                              unsigned char *cursor,
+                              unsigned char **limit) {
+
+    unsigned char *stop;
+
+    assert_not_null(scanner);
+    assert_not_null(limit);
+
+    scanner->buffer.next_char = cursor;
+    *limit = cursor;
+
+    if(NO_MORE_CHARS(scanner)) {
+        return cursor;
+    }
+
+    if(!scanner->input.eof_read && scanner_flush(scanner, 0) < 0) {
+        return cursor;
+    }
+
+    cursor = scanner->buffer.next_char;
+    stop = scanner->buffer.end;
+
+    if(!scanner->input.eof_read) {
+        stop -= S_MAX_LOOKAHEAD;
+    }
+
+    /* the buffer isn't allowed to be flushed, so let the cursor go all the
+     * way to the end of what has been buffered. */
+    if(stop <= cursor) {
+        stop = scanner->buffer.end;
+    }
+
+    *limit = stop;
+
+    return cursor;
+}
+
+/**
+ * Return where a run of characters in the set of 'run' that starts at the
+ * cursor ends, without going past the limit. This is scanner_skip_run for
+ * scanner functions that read through their own cursor.
+ */
+unsigned char *scanner_run_end(const PScannerRun *run,
+                               unsigned char *cursor,
+                               unsigned char *limit) {
+    if(cursor >= limit) {
+        return cursor;
+    }
+    return B_skip_run(run, cursor, limit);
+}
+
+/**
+ * Hash some text for looking it up in a table of keywords.
+ */
+static uint32_t B_keyword_hash(uint32_t seed,
+                               const unsigned char *text,
+                               uint32_t length) {
+    uint32_t hash = S_KEYWORD_BASIS ^ seed,
+             i;
+
+    for(i = 0; i < length; ++i) {
+        hash = S_KEYWORD_HASH(hash, text[i]);
+    }
+
+    return hash;
+}
+
+/**
+ * Look up the current lexeme in a perfect hash table of keywords and return
+ * the keyword's terminal if it is one, or 'terminal' if it isn't. Scanner
+ * functions call this once they have committed to a lexeme of a terminal that
+ * covers some keywords, e.g. an identifier.
+ */
+G_Terminal scanner_keyword(PScanner *scanner,
+                           const PScannerKeywords *keywords,
+                           G_Terminal terminal) {
+
+    const unsigned char *text = scanner->lexeme.start;
+    const PScannerKeyword *slot;
+    uint32_t length = (uint32_t) (scanner->lexeme.end - text),
+             seed;
+
+    /* a lexeme at the end of a string can include the string's terminating
+     * NUL, which scanner_advance moves past before returning 0. */
+    if(length > 0 && '\0' == text[length - 1]) {
+        --length;
+    }
+
+    if(length > keywords->max_length) {
+        return terminal;
+    }
+
+    seed = keywords->seeds[
+        B_keyword_hash(0, text, length) % keywords->num_buckets
+    ];
+    slot = keywords->slots + (
+        B_keyword_hash(seed, text, length) % keywords->num_slots
+    );
+
+    if(slot->length == length && 0 == memcmp(slot->text, text, length)) {
+        return slot->terminal;
+    }
+
+    return terminal;
+}
+
 /**
  * Instruct the scanner to skip characters up until the predicate fails.
  */
@@ -417,8 +958,6 @@ unsigned char *scanner_mark_lexeme_start(PScanner *scanner) {
     unsigned char *start = scanner->buffer.next_char;
     scanner->lexeme.start = start;
     scanner->lexeme.end = start;
-    scanner->lexeme.line = scanner->input.line;
-    scanner->lexeme.column = scanner->input.column;
     scanner->lexeme.as_string = NULL;
     return start;
 }
@@ -437,27 +976,101 @@ void scanner_mark_lexeme_end(PScanner *scanner) {
  */
 PString *scanner_get_lexeme(PScanner *scanner) {
 
-    char term_char;
-    PString *str;
-
     assert_not_null(scanner);
 
+    /* the string is null-terminated by string_alloc_char, and so the buffer,
+     * which might be a read-only mapping, isn't changed. */
     if(is_not_null(scanner->lexeme.as_string)) {
         return scanner->lexeme.as_string;
     } else if(scanner->lexeme.end > scanner->lexeme.start) {
-
-        term_char = *scanner->lexeme.end;
-        *(scanner->lexeme.end) = 0;
-
-        str = scanner->lexeme.as_string = string_alloc_char(
+        return scanner->lexeme.as_string = string_alloc_char(
             (char *) scanner->lexeme.start,
             (uint32_t) (scanner->lexeme.end - scanner->lexeme.start)
         );
-
-        *scanner->lexeme.end = term_char;
-        return str;
     }
 
     return NULL;
 }
 
+/**
+ * Return the offset into the scanner's input of the start of the current
+ * lexeme.
+ */
+uint32_t scanner_get_lexeme_offset(PScanner *scanner) {
+    assert_not_null(scanner);
+    return scanner->input.num_read
+         - (uint32_t) (scanner->buffer.end - scanner->lexeme.start);
+}
+
+/**
+ * Find the line and column of the character at 'offset' into the scanner's
+ * input; both count from zero, unless the input was said to start at some
+ * other position. The position is found by a binary search through the offsets
+ * of the newlines that come before it in the input, and so the scanner only
+ * keeps track of offsets as it goes.
+ */
+void scanner_get_position(PScanner *scanner,
+                          uint32_t offset,
+                          uint32_t *line,
+                          uint32_t *column) {
+
+    uint32_t *newlines,
+             low = 0,
+             high,
+             middle;
+
+    assert_not_null(scanner);
+    assert_not_null(line);
+    assert_not_null(column);
+
+    if(offset > scanner->input.num_read) {
+        offset = scanner->input.num_read;
+    }
+
+    /* input scanned in place has its newlines indexed as they are needed */
+    if(offset > scanner->input.num_indexed) {
+        I_index_newlines(
+            scanner,
+            scanner->buffer.start + scanner->input.num_indexed,
+            offset - scanner->input.num_indexed,
+            scanner->input.num_indexed
+        );
+    }
+
+    /* find the number of newlines before the offset */
+    newlines = scanner->input.newlines;
+    high = scanner->input.num_newlines;
+
+    while(low < high) {
+        middle = low + (high - low) / 2;
+        if(newlines[middle] < offset) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    *line = scanner->input.line + low;
+
+    if(0 == low) {
+        *column = scanner->input.column + offset;
+    } else {
+        *column = offset - (newlines[low - 1] + 1);
+    }
+}
+
+/**
+ * Return where the current lexeme starts in the scanner's input if that input
+ * is text in memory, or NULL if it is read from a file. Unlike the lexeme in
+ * the buffer, these characters stay put for as long as the text does, and so
+ * they can be referred to without being copied.
+ */
+const unsigned char *scanner_get_lexeme_text(PScanner *scanner) {
+    assert_not_null(scanner);
+
+    if(is_null(scanner->input.text)) {
+        return NULL;
+    }
+
+    return scanner->input.text + scanner_get_lexeme_offset(scanner);
+}
@@ -35,8 +35,27 @@ typedef struct {
          *language_name;
 
     unsigned int num_symbols,
-                 num_phrases;
+                 num_phrases,
+                 options;
     PString *first_production;
+
+    /* the direct-coded parser, if one is being generated. the code for each
+     * phrase is written out as the phrase is found, and the phrases are put
+     * into a function once the production rule that they belong to is found,
+     * in the same way that the grammar is built. direct-coded parsers can't
+     * grow left recursion, so a copy of the grammar's production rules is
+     * built along with them in order to find any left recursion up front. */
+    struct {
+        FILE *functions,
+             *phrases;
+        unsigned int num_phrases,
+                     needs_next_phrase:1,
+                     needs_failed:1;
+
+        PGrammar *grammar;
+        PDictionary *productions;
+        PString **names;
+    } direct;
 } PParserInfo;
 
 /* -------------------------------------------------------------------------- */
@@ -60,10 +79,10 @@ static void change_self_refs(PParseTree **branches,
                 term = (PT_Terminal *) rule_branches[k];
                 if(term->terminal == L_pg_self) {
                     term->terminal = L_pg_non_terminal;
-                    if(is_not_null(term->lexeme)) {
-                        string_free(term->lexeme);
-                    }
-                    term->lexeme = string_copy(new_name);
+
+                    /* lexemes belong to the parse tree, so share the name
+                     * instead of freeing and copying it. */
+                    term->lexeme = new_name;
                 }
             }
         }
@@ -76,7 +95,7 @@ static void I_Production(PParserInfo *state,
                         PParseTree *branches[]) {
 
     int i;
-    PString *production_name = ((PT_Terminal *) branches[0])->lexeme;
+    PString *production_name = PT_get_lexeme((PT_Terminal *) branches[0]);
 
     if(dict_is_set(state->production_rules, production_name)) {
         D( printf("Production rule: %s \n", production_name->str); )
@@ -135,8 +154,8 @@ static void I_Terminal(PParserInfo *state,
                      PParseTree *branches[]) {
 
     PT_Terminal *term_regexp = (PT_Terminal *) branches[1];
-    PString *regexp = trim_regexp(term_regexp->lexeme),
-            *terminal = ((PT_Terminal *) branches[0])->lexeme;
+    PString *regexp = trim_regexp(PT_get_lexeme(term_regexp)),
+            *terminal = PT_get_lexeme((PT_Terminal *) branches[0]);
 
     D( printf("Found terminal '%s' -> {%s} \n", terminal->str, regexp->str); )
 
@@ -148,6 +167,30 @@ static void I_Terminal(PParserInfo *state,
     );
 }
 
+/**
+ * Check the terminals of a synchronization declaration. In-line strings are
+ * only trimmed here; they are looked up once every string in the grammar has
+ * been named.
+ */
+static void I_SyncTerminals(PParserInfo *state,
+                            unsigned char phrase,
+                            unsigned int num_branches,
+                            PParseTree *branches[]) {
+    unsigned int i;
+    PT_Terminal *term;
+
+    for(i = 0; i < num_branches; ++i) {
+        term = (PT_Terminal *) branches[i];
+
+        if(term->terminal == L_pg_string) {
+            trim_regexp(PT_get_lexeme(term));
+        } else if(!dict_is_set(state->terminals, PT_get_lexeme(term))) {
+            D( printf("Terminal symbol: %s \n", PT_get_lexeme(term)->str); )
+            std_error("Grammar Error: Undefined synchronization terminal.");
+        }
+    }
+}
+
 static void I_Rules(PParserInfo *state,
                      unsigned char phrase,
                      unsigned int num_branches,
@@ -164,7 +207,7 @@ static void I_Rules(PParserInfo *state,
         if(branches[i]->type == PT_NON_TERMINAL) {
 
             ++(state->num_symbols);
-            state->num_phrases += num_branches - 1;
+            state->num_phrases += tree_get_num_branches((PTree *) branches[i]);
 
             sprintf(term_name, "subrule_%d", ++l);
             for(c = term_name, j = 0; *c; ++j, ++c)
@@ -193,24 +236,24 @@ static void I_Rules(PParserInfo *state,
                 ++(state->num_symbols);
                 dict_set(
                     state->non_terminals,
-                    term->lexeme,
+                    PT_get_lexeme(term),
                     NULL,
                     &delegate_do_nothing
                 );
                 break;
             case L_pg_terminal:
                 ++(state->num_symbols);
-                if(!dict_is_set(state->terminals, term->lexeme)) {
-                    D( printf("Terminal symbol: %s \n", term->lexeme->str); )
+                if(!dict_is_set(state->terminals, PT_get_lexeme(term))) {
+                    D( printf("Terminal symbol: %s \n", PT_get_lexeme(term)->str); )
                     std_error("Grammar Error: Undefined terminal symbol.");
                 }
                 break;
             case L_pg_regexp:
                 ++(state->num_symbols);
 
-                trim_regexp(term->lexeme);
+                trim_regexp(PT_get_lexeme(term));
 
-                if(!dict_is_set(state->regexps, term->lexeme)) {
+                if(!dict_is_set(state->regexps, PT_get_lexeme(term))) {
                     sprintf(term_name, "regexp_%d", ++k);
                     for(c = term_name, j = 0; *c; ++j, ++c)
                         ;
@@ -219,23 +262,23 @@ static void I_Rules(PParserInfo *state,
                     record_regexp(
                         state->regexps,
                         state->terminals,
-                        term->lexeme,
+                        PT_get_lexeme(term),
                         str
                     );
 
                     D( printf(
                         "Found in-line regular expression '%s' -> {%s} \n",
                         term_name,
-                        term->lexeme->str
+                        PT_get_lexeme(term)->str
                     ); )
                 }
                 break;
             case L_pg_string:
                 ++(state->num_symbols);
 
-                trim_regexp(term->lexeme);
+                trim_regexp(PT_get_lexeme(term));
 
-                if(!dict_is_set(state->strings, term->lexeme)) {
+                if(!dict_is_set(state->strings, PT_get_lexeme(term))) {
                     sprintf(term_name, "string_%d", ++k);
                     for(c = term_name, j = 0; *c; ++j, ++c)
                         ;
@@ -244,14 +287,14 @@ static void I_Rules(PParserInfo *state,
                     record_regexp(
                         state->strings,
                         state->terminals,
-                        term->lexeme,
+                        PT_get_lexeme(term),
                         str
                     );
 
                     D( printf(
                         "Found in-line string '%s' -> {%s} \n",
                         term_name,
-                        term->lexeme->str
+                        PT_get_lexeme(term)->str
                     ); )
                 }
                 break;
@@ -269,6 +312,149 @@ static void I_Rules(PParserInfo *state,
 
 /* -------------------------------------------------------------------------- */
 
+/**
+ * Remember the number that a production is given in the generated grammar, so
+ * that the copy of the grammar made for the direct-coded parser can refer to
+ * the production by its name.
+ */
+static void D_number_production(PParserInfo *state,
+                                PString *name,
+                                unsigned int i) {
+    if(is_null(state->direct.functions)) {
+        return;
+    }
+
+    if(is_null(state->direct.names)) {
+        state->direct.names = mem_alloc(
+            (dict_size(state->production_rules) + dict_size(state->sub_rules))
+          * sizeof(PString *)
+        );
+
+        if(is_null(state->direct.names)) {
+            mem_error("Unable to allocate the names of the productions.");
+        }
+    }
+
+    state->direct.names[i] = name;
+    dict_set(
+        state->direct.productions,
+        name,
+        state->direct.names + i,
+        &delegate_do_nothing
+    );
+}
+
+/**
+ * Get the number of a production given its name.
+ */
+static G_NonTerminal D_production(PParserInfo *state, PString *name) {
+    return (G_NonTerminal) (
+        ((PString **) dict_get(state->direct.productions, name))
+      - state->direct.names
+    );
+}
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Build a DFA that matches only the lexemes of one terminal.
+ */
+static PNFA *R_terminal_dfa(PParserInfo *state,
+                            PParser *parser,
+                            PGrammar *grammar,
+                            PString *regexp,
+                            unsigned int terminal) {
+    PNFA *nfa = nfa_alloc(),
+         *dfa;
+    PSet *priority_set = set_alloc();
+    unsigned int start = nfa_add_state(nfa);
+
+    nfa_change_start_state(nfa, start);
+
+    if(dict_is_set(state->strings, regexp)) {
+        regexp_parse_cat(
+            parser,
+            grammar,
+            state->scanner,
+            nfa,
+            (unsigned char *) regexp->str,
+            start,
+            terminal
+        );
+    } else {
+        regexp_parse(
+            parser,
+            grammar,
+            state->scanner,
+            nfa,
+            (unsigned char *) regexp->str,
+            start,
+            terminal
+        );
+    }
+
+    dfa = nfa_to_dfa(nfa, priority_set);
+    set_free(priority_set);
+    nfa_free(nfa);
+
+    return dfa;
+}
+
+/**
+ * Check if a string terminal is a keyword, i.e. if exactly one regular
+ * expression terminal matches it. A keyword doesn't need to be put into the
+ * scanner's DFA: the scanner matches it as the regular expression's terminal
+ * and then finds it in a hash table of keywords. This is the same as matching
+ * it directly, as the longest lexeme is the same either way and no other
+ * terminal can match the keyword. If the string is a keyword, fill in
+ * 'keyword' and return 1.
+ */
+static int R_is_keyword(PParserInfo *state,
+                        PParser *parser,
+                        PGrammar *grammar,
+                        PNFA **regexp_dfas,
+                        unsigned int num_terminals,
+                        PString *string,
+                        unsigned int terminal,
+                        NFA_Keyword *keyword) {
+    PNFA *dfa = R_terminal_dfa(state, parser, grammar, string, terminal);
+    unsigned char *text = mem_alloc(string->len + 1);
+    unsigned int i;
+    int length,
+        covered_by = -1;
+
+    if(is_null(text)) {
+        mem_error("Unable to allocate keyword.");
+    }
+
+    /* any escapes in the string are only one character once parsed */
+    length = nfa_only_string(dfa, text, string->len);
+    nfa_free(dfa);
+
+    for(i = 0; length > 0 && i < num_terminals; ++i) {
+        if(is_not_null(regexp_dfas[i])
+        && 0 <= nfa_match(regexp_dfas[i], text, (unsigned int) length)) {
+            if(covered_by >= 0) {
+                covered_by = -1;
+                break;
+            }
+            covered_by = (int) i;
+        }
+    }
+
+    if(covered_by < 0) {
+        mem_free(text);
+        return 0;
+    }
+
+    keyword->text = text;
+    keyword->length = (unsigned int) length;
+    keyword->covered_by = covered_by;
+    keyword->conclusion = (int) terminal;
+
+    return 1;
+}
+
 /**
  * Create the scanner/lexer/tokenizer and also begin the creation of the grammar
  * file.
@@ -283,12 +469,20 @@ static void R_make_scanner(PParserInfo *state) {
 
     PGrammar *grammar = regexp_grammar();
 
+    PParser *parser = parser_alloc();
+
     PNFA *nfa = nfa_alloc(),
-         *dfa;
+         *dfa,
+         **regexp_dfas;
 
     PSet *priority_set = set_alloc();
 
+    NFA_Keyword *keywords;
+
     unsigned int start,
+                 scanner_options = 0,
+                 num_terminals = dict_size(state->terminals),
+                 num_keywords = 0,
                  i;
 
     char *sep = "    ";
@@ -313,6 +507,25 @@ static void R_make_scanner(PParserInfo *state) {
     start = nfa_add_state(nfa);
     nfa_change_start_state(nfa, start);
 
+    regexp_dfas = mem_calloc(num_terminals + 1, sizeof(PNFA *));
+    keywords = mem_calloc(num_terminals + 1, sizeof(NFA_Keyword));
+    if(is_null(regexp_dfas) || is_null(keywords)) {
+        mem_error("Unable to allocate keywords.");
+    }
+
+    D( printf("finding keywords... \n"); )
+
+    /* build a DFA for each regular expression terminal on its own, so that
+     * the string terminals that they match can be found. */
+    values = dict_values_generator_alloc(state->terminals);
+    for(i = 0; generator_next(values); ++i) {
+        regexp = generator_current(values);
+        if(!dict_is_set(state->strings, regexp)) {
+            regexp_dfas[i] = R_terminal_dfa(state, parser, grammar, regexp, i);
+        }
+    }
+    generator_free(values);
+
     P(state->fp, "\n\n");
     P(state->fp, "#ifndef _PGEN_%s_\n", state->grammar_func_name);
     P(state->fp, "#define _PGEN_%s_\n", state->grammar_func_name);
@@ -333,9 +546,21 @@ static void R_make_scanner(PParserInfo *state) {
         key = generator_current(keys);
         regexp = generator_current(values);
 
-        if(dict_is_set(state->strings, regexp)) {
+        if(dict_is_set(state->strings, regexp)
+        && R_is_keyword(state,
+                        parser,
+                        grammar,
+                        regexp_dfas,
+                        num_terminals,
+                        regexp,
+                        i,
+                        keywords + num_keywords)) {
+            D( printf("found keyword {%s}...\n", regexp->str); )
+            ++num_keywords;
+        } else if(dict_is_set(state->strings, regexp)) {
             D( printf("parsing string expression {%s}...\n", regexp->str); )
             set_add_elm(priority_set, regexp_parse_cat(
+                parser,
                 grammar,
                 state->scanner,
                 nfa,
@@ -346,6 +571,7 @@ static void R_make_scanner(PParserInfo *state) {
         } else {
             D( printf("parsing regular expression {%s}...\n", regexp->str); )
             regexp_parse(
+                parser,
                 grammar,
                 state->scanner,
                 nfa,
@@ -364,17 +590,43 @@ static void R_make_scanner(PParserInfo *state) {
 
     generator_free(keys);
     generator_free(values);
+    parser_free(parser);
     grammar_free(grammar);
 
+    for(i = 0; i < num_terminals; ++i) {
+        if(is_not_null(regexp_dfas[i])) {
+            nfa_free(regexp_dfas[i]);
+        }
+    }
+    mem_free(regexp_dfas);
+
     /* convert the now constructed NFA of all of the regular expressions that
      * match lexemes and associate then with terminals into a DFA. Once that has
      * been done, print the DFA out as a scanner (in C code) to a file. */
     dfa = nfa_to_mdfa(nfa, priority_set);
     set_free(priority_set);
     nfa_free(nfa);
-    nfa_print_scanner(dfa, state->lexer_output_file, state->lexer_func_name);
+    if(state->options & PGEN_TABLE_LEXER) {
+        scanner_options |= NFA_SCANNER_TABLES;
+    }
+    if(state->options & PGEN_CURSOR_LEXER) {
+        scanner_options |= NFA_SCANNER_CURSOR;
+    }
+    nfa_print_scanner_options(
+        dfa,
+        state->lexer_output_file,
+        state->lexer_func_name,
+        scanner_options,
+        keywords,
+        num_keywords
+    );
     nfa_free(dfa);
 
+    for(i = 0; i < num_keywords; ++i) {
+        mem_free(keywords[i].text);
+    }
+    mem_free(keywords);
+
     D( printf("creating head of grammar file... \n"); )
 
     /* now go and list out the production rules in an enum so that they can be
@@ -386,6 +638,7 @@ static void R_make_scanner(PParserInfo *state) {
     for(i = 0; generator_next(keys); ++i) {
         key = generator_current(keys);
         P(state->fp, "%sP_%s_%s=%d", sep, state->language_name, key->str, i);
+        D_number_production(state, key, i);
         sep = ",\n    ";
     }
     generator_free(keys);
@@ -395,6 +648,7 @@ static void R_make_scanner(PParserInfo *state) {
     for(; generator_next(keys); ++i) {
         key = generator_current(keys);
         P(state->fp, "%sP_%s_%s=%d", sep, state->language_name, key->str, i);
+        D_number_production(state, key, i);
         sep = ",\n    ";
     }
     generator_free(keys);
@@ -412,42 +666,278 @@ static void R_make_scanner(PParserInfo *state) {
     P(state->fp, "        %d /* number of phrase symbols */\n", state->num_symbols);
     P(state->fp, "    );\n\n");
 
+    if(is_not_null(state->direct.functions)) {
+        state->direct.grammar = grammar_alloc(
+            D_production(state, state->first_production),
+            i,
+            dict_size(state->terminals),
+            state->num_phrases,
+            state->num_symbols
+        );
+    }
+
     /* the next step is postorder traversal of the parse tree that prints out
      * the various calls to grammar building functions. */
 }
 
 /* -------------------------------------------------------------------------- */
 
-/* deal with normal production rules */
-static void C_Production(PParserInfo *state,
-                        unsigned char phrase,
-                        unsigned int num_branches,
-                        PParseTree *branches[]) {
-    char *production_name = ((PT_Terminal *) branches[0])->lexeme->str;
-    P(
-        state->fp,
-        "    grammar_add_production_rule(G, P_%s_%s);\n\n",
-        state->language_name,
-        production_name
-    );
+/**
+ * Copy everything written to a temporary file into another file.
+ */
+static void copy_file(FILE *to, FILE *from) {
+    char buffer[BUFSIZ];
+    size_t len;
+
+    rewind(from);
+    while(0 < (len = fread(buffer, sizeof(char), BUFSIZ, from))) {
+        fwrite(buffer, sizeof(char), len, to);
+    }
 }
 
-/* Deal with anonymous production rules. */
-static void C_ProductionRules(PParserInfo *state,
-                        unsigned char phrase,
-                        unsigned int num_branches,
-                        PParseTree *branches[]) {
-    PString *production_name;
-    if(!dict_is_set(state->sub_rules, branches)) {
+/**
+ * Gather the phrases written out since the last production rule into the
+ * function of the direct-coded parser for a production rule.
+ */
+static void D_production_rule(PParserInfo *state, PString *name) {
+    FILE *fp = state->direct.functions;
+    char *production_name;
+
+    if(is_null(fp)) {
         return;
     }
-    production_name = dict_get(state->sub_rules, branches);
-    P(
-        state->fp,
-        "    grammar_add_production_rule(G, P_%s_%s);\n\n",
-        state->language_name,
-        production_name->str
+
+    grammar_add_production_rule(
+        state->direct.grammar,
+        D_production(state, name)
     );
+
+    production_name = name->str;
+
+    P(fp, "static PParseTree *PD_%s_%s(PParser *P) {\n", state->language_name, production_name);
+    P(fp, "    P_DirectFrame F;\n\n");
+    P(fp, "    if(PD_enter(P, &F, P_%s_%s)) {\n", state->language_name, production_name);
+    P(fp, "        return F.parse_tree;\n");
+    P(fp, "    }\n\n");
+
+    /* a production rule without phrases matches the empty string */
+    if(0 == state->direct.num_phrases) {
+        P(fp, "    if(PD_succeed(P, &F)) {\n");
+        P(fp, "        return F.parse_tree;\n");
+        P(fp, "    }\n\n");
+    }
+
+    copy_file(fp, state->direct.phrases);
+
+    if(state->direct.needs_next_phrase) {
+        P(fp, "phrase_%d:\n", state->direct.num_phrases);
+    }
+
+    if(state->direct.needs_failed) {
+        P(fp, "failed:\n");
+    }
+
+    P(fp, "    return PD_fail(P, &F);\n");
+    P(fp, "}\n\n");
+
+    fclose(state->direct.phrases);
+    state->direct.phrases = tmpfile();
+    state->direct.num_phrases = 0;
+    state->direct.needs_next_phrase = 0;
+    state->direct.needs_failed = 0;
+
+    if(is_null(state->direct.phrases)) {
+        std_error("Internal Parser Generator Error: Unable to create temporary file.");
+    }
+}
+
+/* declare the synchronization terminals of the parallel parser */
+static void C_SyncTerminals(PParserInfo *state,
+                            unsigned char phrase,
+                            unsigned int num_branches,
+                            PParseTree *branches[]) {
+    unsigned int i;
+    PT_Terminal *term;
+    PString *name;
+
+    for(i = 0; i < num_branches; ++i) {
+        term = (PT_Terminal *) branches[i];
+        name = PT_get_lexeme(term);
+
+        if(term->terminal == L_pg_string) {
+            if(!dict_is_set(state->strings, name)) {
+                D( printf("String: %s \n", name->str); )
+                std_error(
+                    "Grammar Error: Synchronization string is not used by "
+                    "any production rule."
+                );
+            }
+            name = dict_get(state->strings, name);
+        }
+
+        P(
+            state->fp,
+            "    grammar_add_sync_terminal(G, L_%s_%s);\n",
+            state->language_name,
+            name->str
+        );
+    }
+
+    P(state->fp, "\n");
+}
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Get the label that the direct-coded parser jumps to when the current phrase
+ * fails: the next phrase, or the end of the function once the phrase has been
+ * committed to.
+ */
+static void D_fail_label(PParserInfo *state, int is_committed, char *label) {
+    if(is_committed) {
+        state->direct.needs_failed = 1;
+        sprintf(label, "failed");
+    } else {
+        state->direct.needs_next_phrase = 1;
+        sprintf(label, "phrase_%d", state->direct.num_phrases + 1);
+    }
+}
+
+/**
+ * Write out the code of the direct-coded parser for a single symbol of a
+ * phrase. Terminals are compared in-line. A repeated symbol is matched in a
+ * loop after its first match, if it must have one. The symbol is also added
+ * to the direct-coded parser's copy of the grammar.
+ */
+static void D_symbol(PParserInfo *state,
+                     int is_committed,
+                     char *kind,
+                     PString *name,
+                     char *modifier,
+                     char repetition) {
+    FILE *fp = state->direct.phrases;
+    char label[20];
+
+    if(is_null(fp)) {
+        return;
+    }
+
+    switch(kind[0]) {
+        case 'N':
+            grammar_add_non_terminal_symbol(
+                state->direct.grammar,
+                D_production(state, name),
+                G_AUTO
+            );
+            break;
+        case 'T':
+            grammar_add_terminal_symbol(state->direct.grammar, 0, G_AUTO);
+            break;
+        case 'F':
+            grammar_add_fail_symbol(state->direct.grammar);
+            break;
+        default:
+            grammar_add_epsilon_symbol(state->direct.grammar, G_AUTO);
+            break;
+    }
+
+    switch(repetition) {
+        case '*':
+            grammar_repeat_symbol(state->direct.grammar, G_ZERO_OR_MORE);
+            break;
+        case '+':
+            grammar_repeat_symbol(state->direct.grammar, G_ONE_OR_MORE);
+            break;
+        case '?':
+            grammar_repeat_symbol(state->direct.grammar, G_ZERO_OR_ONE);
+            break;
+        default:
+            break;
+    }
+
+    if('E' != kind[0] && ('\0' == repetition || '+' == repetition)) {
+        D_fail_label(state, is_committed, label);
+    }
+
+    if('N' == kind[0]) {
+        if('\0' == repetition || '+' == repetition) {
+            P(fp, "    if(!PD_non_terminal(P, &F, PD_%s_%s(P), %s)) {\n", state->language_name, name->str, modifier);
+            P(fp, "        goto %s;\n", label);
+            P(fp, "    }\n");
+        }
+
+        if('?' == repetition) {
+            P(fp, "    F.repeat_point = P->token;\n");
+            P(fp, "    PD_repeat(P, &F, PD_%s_%s(P), %s);\n", state->language_name, name->str, modifier);
+        } else if('\0' != repetition) {
+            P(fp, "    do {\n");
+            P(fp, "        F.repeat_point = P->token;\n");
+            P(fp, "    } while(PD_repeat(P, &F, PD_%s_%s(P), %s));\n", state->language_name, name->str, modifier);
+        }
+    } else if('T' == kind[0]) {
+        if('\0' == repetition || '+' == repetition) {
+            P(fp, "    if(PD_TERMINAL(P) != L_%s_%s) {\n", state->language_name, name->str);
+            P(fp, "        goto %s;\n", label);
+            P(fp, "    }\n");
+            P(fp, "    PD_match(P, &F, %s);\n", modifier);
+        }
+
+        if('?' == repetition) {
+            P(fp, "    if(PD_TERMINAL(P) == L_%s_%s) {\n", state->language_name, name->str);
+            P(fp, "        PD_match(P, &F, %s);\n", modifier);
+            P(fp, "    }\n");
+        } else if('\0' != repetition) {
+            P(fp, "    while(PD_TERMINAL(P) == L_%s_%s) {\n", state->language_name, name->str);
+            P(fp, "        PD_match(P, &F, %s);\n", modifier);
+            P(fp, "    }\n");
+        }
+    } else if('F' == kind[0]) {
+        P(fp, "    goto %s;\n", label);
+    } else if(0 != strcmp("G_AUTO", modifier)) {
+        P(fp, "    PD_epsilon(P, &F, %s);\n", modifier);
+    }
+}
+
+/**
+ * Get the repetition operator, if any, that follows the symbol at 'i' in a
+ * phrase: one of '*', '+' or '?'.
+ */
+static char C_repetition(unsigned int i,
+                         unsigned int num_branches,
+                         PParseTree *branches[]) {
+    if(++i >= num_branches || branches[i]->type != PT_TERMINAL) {
+        return '\0';
+    }
+
+    switch(((PT_Terminal *) branches[i])->terminal) {
+        case L_pg_kleene_closure:
+            return '*';
+        case L_pg_positive_closure:
+            return '+';
+        case L_pg_optional:
+            return '?';
+        default:
+            return '\0';
+    }
+}
+
+/**
+ * Repeat the symbol that was just added to the grammar.
+ */
+static void C_repeat(PParserInfo *state, char repetition) {
+    switch(repetition) {
+        case '*':
+            P(state->fp, "    grammar_repeat_symbol(G, G_ZERO_OR_MORE);\n");
+            break;
+        case '+':
+            P(state->fp, "    grammar_repeat_symbol(G, G_ONE_OR_MORE);\n");
+            break;
+        case '?':
+            P(state->fp, "    grammar_repeat_symbol(G, G_ZERO_OR_ONE);\n");
+            break;
+        default:
+            break;
+    }
 }
 
 /* deal with the symbols of a phrase */
@@ -460,10 +950,28 @@ static void C_Rules(PParserInfo *state,
     PT_NonTerminal *nterm;
     PString *str;
 
-    char *modifier = "G_AUTO";
+    char *modifier = "G_AUTO",
+         label[20],
+         repetition;
+
+    int is_committed = 0;
+
+    FILE *direct_fp = state->direct.phrases;
+
+    /* the direct-coded parser only needs a label for this phrase if an earlier
+     * phrase jumps to it. */
+    if(is_not_null(direct_fp)) {
+        if(state->direct.needs_next_phrase) {
+            P(direct_fp, "phrase_%d:\n", state->direct.num_phrases);
+            state->direct.needs_next_phrase = 0;
+        }
+        P(direct_fp, "    PD_phrase(P, &F, %d);\n", state->direct.num_phrases);
+    }
 
     for(; i < num_branches; ++i) {
 
+        repetition = C_repetition(i, num_branches, branches);
+
         if(branches[i]->type == PT_NON_TERMINAL) {
             str = dict_get(state->sub_rules, tree_get_branches(branches[i]));
             P(
@@ -473,6 +981,8 @@ static void C_Rules(PParserInfo *state,
                 str->str,
                 modifier
             );
+            C_repeat(state, repetition);
+            D_symbol(state, is_committed, "N", str, modifier, repetition);
             continue;
         }
 
@@ -485,26 +995,36 @@ static void C_Rules(PParserInfo *state,
             case L_pg_raise_children:
                 modifier = "G_RAISE_CHILDREN";
                 goto next_iteration;
+
+            /* repetitions are dealt with along with the symbol before them */
+            case L_pg_kleene_closure:
+            case L_pg_positive_closure:
+            case L_pg_optional:
+                goto next_iteration;
             case L_pg_non_terminal:
                 P(
                     state->fp,
                     "    grammar_add_non_terminal_symbol(G, P_%s_%s, %s);\n",
                     state->language_name,
-                    term->lexeme->str,
+                    PT_get_lexeme(term)->str,
                     modifier
                 );
+                C_repeat(state, repetition);
+                D_symbol(state, is_committed, "N", PT_get_lexeme(term), modifier, repetition);
                 break;
             case L_pg_terminal:
                 P(
                     state->fp,
                     "    grammar_add_terminal_symbol(G, L_%s_%s, %s);\n",
                     state->language_name,
-                    term->lexeme->str,
+                    PT_get_lexeme(term)->str,
                     modifier
                 );
+                C_repeat(state, repetition);
+                D_symbol(state, is_committed, "T", PT_get_lexeme(term), modifier, repetition);
                 break;
             case L_pg_regexp:
-                str = dict_get(state->regexps, term->lexeme);
+                str = dict_get(state->regexps, PT_get_lexeme(term));
                 P(
                     state->fp,
                     "    grammar_add_terminal_symbol(G, L_%s_%s, %s);\n",
@@ -512,9 +1032,11 @@ static void C_Rules(PParserInfo *state,
                     str->str,
                     modifier
                 );
+                C_repeat(state, repetition);
+                D_symbol(state, is_committed, "T", str, modifier, repetition);
                 break;
             case L_pg_string:
-                str = dict_get(state->strings, term->lexeme);
+                str = dict_get(state->strings, PT_get_lexeme(term));
                 P(
                     state->fp,
                     "    grammar_add_terminal_symbol(G, L_%s_%s, %s);\n",
@@ -522,19 +1044,30 @@ static void C_Rules(PParserInfo *state,
                     str->str,
                     modifier
                 );
+                C_repeat(state, repetition);
+                D_symbol(state, is_committed, "T", str, modifier, repetition);
                 break;
             case L_pg_cut:
                 P(state->fp, "    grammar_add_cut_symbol(G);\n");
+                if(is_not_null(direct_fp)) {
+                    grammar_add_cut_symbol(state->direct.grammar);
+                }
+                is_committed = 1;
                 break;
             case L_pg_fail:
                 P(state->fp, "    grammar_add_fail_symbol(G);\n");
+                D_symbol(state, is_committed, "F", NULL, modifier, '\0');
                 break;
             case L_pg_epsilon:
+                if('\0' != repetition) {
+                    std_error("Grammar Error: The empty string cannot be repeated.");
+                }
                 P(
                     state->fp,
                     "    grammar_add_epsilon_symbol(G, %s);\n",
                     modifier
                 );
+                D_symbol(state, is_committed, "E", NULL, modifier, '\0');
                 break;
             default:
                 break;
@@ -547,51 +1080,196 @@ static void C_Rules(PParserInfo *state,
     }
 
     P(state->fp, "    grammar_add_phrase(G);\n");
+
+    /* the start production must match all of the tokens, so finishing the
+     * phrase can still fail. */
+    if(is_not_null(direct_fp)) {
+        grammar_add_phrase(state->direct.grammar);
+        P(direct_fp, "    if(PD_succeed(P, &F)) {\n");
+        P(direct_fp, "        return F.parse_tree;\n");
+        P(direct_fp, "    }\n");
+        if(is_committed) {
+            D_fail_label(state, is_committed, label);
+            P(direct_fp, "    goto %s;\n", label);
+        }
+        P(direct_fp, "\n");
+        ++(state->direct.num_phrases);
+    }
+}
+
+/**
+ * Generate the phrases of a production rule, one for each of its Rules
+ * branches. This is done once the whole production rule has been parsed, so
+ * that the phrases of any sub-rules inside of it have already been generated
+ * and added to their own production rules.
+ */
+static void C_phrases(PParserInfo *state,
+                      unsigned int num_branches,
+                      PParseTree *branches[]) {
+    unsigned int i;
+
+    for(i = 0; i < num_branches; ++i) {
+        if(branches[i]->type != PT_NON_TERMINAL) {
+            continue;
+        }
+        C_Rules(
+            state,
+            0,
+            tree_get_num_branches((PTree *) branches[i]),
+            (PParseTree **) tree_get_branches(branches[i])
+        );
+    }
+}
+
+/* deal with normal production rules */
+static void C_Production(PParserInfo *state,
+                        unsigned char phrase,
+                        unsigned int num_branches,
+                        PParseTree *branches[]) {
+    PString *production_name = PT_get_lexeme((PT_Terminal *) branches[0]);
+    C_phrases(state, num_branches - 1, branches + 1);
+    P(
+        state->fp,
+        "    grammar_add_production_rule(G, P_%s_%s);\n\n",
+        state->language_name,
+        production_name->str
+    );
+    D_production_rule(state, production_name);
+}
+
+/* Deal with anonymous production rules. */
+static void C_ProductionRules(PParserInfo *state,
+                        unsigned char phrase,
+                        unsigned int num_branches,
+                        PParseTree *branches[]) {
+    PString *production_name;
+    if(!dict_is_set(state->sub_rules, branches)) {
+        return;
+    }
+    production_name = dict_get(state->sub_rules, branches);
+    C_phrases(state, num_branches, branches);
+    P(
+        state->fp,
+        "    grammar_add_production_rule(G, P_%s_%s);\n\n",
+        state->language_name,
+        production_name->str
+    );
+    D_production_rule(state, production_name);
 }
 
 /* -------------------------------------------------------------------------- */
 
 /**
- * Finish off the grammar building function and grammar file.
+ * Make sure that none of the production rules of the direct-coded parser's
+ * copy of the grammar are left recursive. The direct-coded parser would only
+ * find out about left recursion while parsing, so instead it isn't generated.
+ */
+static void D_check_left_recursion(PParserInfo *state) {
+    PGrammar *grammar = state->direct.grammar;
+    unsigned int i;
+
+    G_lock(grammar);
+
+    for(i = 0; i < grammar->num_productions; ++i) {
+        if(grammar->production_rules[i].is_left_recursive) {
+            printf(
+                "Production rule %s is left recursive. \n",
+                state->direct.names[i]->str
+            );
+            std_error(
+                "Grammar Error: Direct-coded parsers do not support left "
+                "recursion."
+            );
+        }
+    }
+
+    G_unlock(grammar);
+}
+
+/**
+ * Finish off the grammar building function, add in the direct-coded parser if
+ * there is one, and finish the grammar file.
  */
 static void C_finish_parser(PParserInfo *state) {
+    PDictionaryGenerator *names;
+    PString *name;
+
     P(state->fp, "    return G;\n");
     P(state->fp, "}\n");
+
+    if(is_not_null(state->direct.functions)) {
+        D_check_left_recursion(state);
+
+        P(state->fp, "\n");
+
+        /* declare the functions for all of the productions up front as they
+         * are mutually recursive. */
+        names = dict_keys_generator_alloc(state->production_rules);
+        while(generator_next(names)) {
+            name = generator_current(names);
+            P(state->fp, "static PParseTree *PD_%s_%s(PParser *P);\n", state->language_name, name->str);
+        }
+        generator_free(names);
+
+        names = dict_values_generator_alloc(state->sub_rules);
+        while(generator_next(names)) {
+            name = generator_current(names);
+            P(state->fp, "static PParseTree *PD_%s_%s(PParser *P);\n", state->language_name, name->str);
+        }
+        generator_free(names);
+
+        P(state->fp, "\n");
+        copy_file(state->fp, state->direct.functions);
+
+        P(state->fp, "extern PParseTree *%s_direct(PParser *P);\n\n", state->grammar_func_name);
+        P(state->fp, "PParseTree *%s_direct(PParser *P) {\n", state->grammar_func_name);
+        P(state->fp, "    return PD_%s_%s(P);\n", state->language_name, state->first_production->str);
+        P(state->fp, "}\n");
+    }
+
     P(state->fp, "#endif\n\n");
 }
 
 /* -------------------------------------------------------------------------- */
 
-void parser_gen(char *grammar_input_file,
-                char *grammar_func_name,
-                char *grammar_output_file,
-                char *lexer_func_name,
-                char *lexer_output_file,
-                char *language_name) {
+/**
+ * Generate the grammar and scanner for the language described in the grammar
+ * input file. The options are a combination of the PGEN_* flags, which choose
+ * what kind of parser and scanner are generated along with the grammar.
+ */
+void parser_gen_options(char *grammar_input_file,
+                        char *grammar_func_name,
+                        char *grammar_output_file,
+                        char *lexer_func_name,
+                        char *lexer_output_file,
+                        char *language_name,
+                        unsigned int options) {
 
     PScanner *scanner = scanner_alloc();
     PGrammar *grammar = parser_grammar_grammar();
     PParserInfo info;
 
-    G_ProductionRuleFunc *symbol_table_actions[] = {
-        &grammar_null_action,
-        &grammar_null_action,
-        (G_ProductionRuleFunc *) &I_Terminal,
-        (G_ProductionRuleFunc *) &I_Production,
-        &grammar_null_action,
-        &grammar_null_action,
-        (G_ProductionRuleFunc *) &I_Rules
-    };
-
-    G_ProductionRuleFunc *code_gen_actions[] = {
-        &grammar_null_action,
-        (G_ProductionRuleFunc *) &C_ProductionRules,
-        &grammar_null_action,
-        (G_ProductionRuleFunc *) &C_Production,
-        &grammar_null_action,
-        &grammar_null_action,
-        (G_ProductionRuleFunc *) &C_Rules
-    };
+    G_ProductionRuleFunc *symbol_table_actions[P_PG_NUM_PRODUCTIONS],
+                         *code_gen_actions[P_PG_NUM_PRODUCTIONS];
+
+    unsigned int i;
+
+    /* the actions are indexed by production, and the productions are numbered
+     * in whatever order pgen found them in when it generated the grammar of
+     * grammars. */
+    for(i = 0; i < P_PG_NUM_PRODUCTIONS; ++i) {
+        symbol_table_actions[i] = &grammar_null_action;
+        code_gen_actions[i] = &grammar_null_action;
+    }
+
+    symbol_table_actions[P_pg_Terminal] = (G_ProductionRuleFunc *) &I_Terminal;
+    symbol_table_actions[P_pg_Production] = (G_ProductionRuleFunc *) &I_Production;
+    symbol_table_actions[P_pg_Rules] = (G_ProductionRuleFunc *) &I_Rules;
+    symbol_table_actions[P_pg_SyncTerminals] = (G_ProductionRuleFunc *) &I_SyncTerminals;
+
+    code_gen_actions[P_pg_ProductionRules] = (G_ProductionRuleFunc *) &C_ProductionRules;
+    code_gen_actions[P_pg_Production] = (G_ProductionRuleFunc *) &C_Production;
+    code_gen_actions[P_pg_SyncTerminals] = (G_ProductionRuleFunc *) &C_SyncTerminals;
 
     grammar_add_tree_actions(grammar, TREE_TRAVERSE_POSTORDER, symbol_table_actions);
     grammar_add_state_action(grammar, (PDelegate *) &R_make_scanner);
@@ -636,21 +1314,45 @@ void parser_gen(char *grammar_input_file,
     info.fp = fopen(grammar_output_file, "w");
     info.num_symbols = 0;
     info.num_phrases = 0;
+    info.options = options;
     info.first_production = NULL;
     info.language_name = language_name;
+    info.direct.functions = NULL;
+    info.direct.phrases = NULL;
+    info.direct.num_phrases = 0;
+    info.direct.needs_next_phrase = 0;
+    info.direct.needs_failed = 0;
+    info.direct.grammar = NULL;
+    info.direct.productions = NULL;
+    info.direct.names = NULL;
 
     if(is_null(info.fp)) {
         std_error("Internal Parser Generator Error: Unable to create output file.");
     }
 
+    if(options & PGEN_DIRECT_PARSER) {
+        info.direct.functions = tmpfile();
+        info.direct.phrases = tmpfile();
+        if(is_null(info.direct.functions) || is_null(info.direct.phrases)) {
+            std_error("Internal Parser Generator Error: Unable to create temporary file.");
+        }
+        info.direct.productions = dict_alloc(
+            53,
+            (PDictionaryHashFunc *) &string_hash_fnc,
+            (PDictionaryCollisionFunc *) &string_collision_fnc
+        );
+    }
+
     if(scanner_use_file(scanner, grammar_input_file)) {
         scanner_flush(scanner, 1);
-        parse_tokens(
+        if(!parse_tokens(
             grammar,
             scanner,
             (PScannerFunc *) &parser_grammar_lexer,
             &info
-        );
+        )) {
+            std_error("Grammar Error: Unable to parse the grammar file.");
+        }
     }
 
     dict_free(info.production_rules, &delegate_do_nothing, &delegate_do_nothing);
@@ -675,5 +1377,68 @@ void parser_gen(char *grammar_input_file,
     scanner_free(scanner);
     grammar_free(grammar);
 
+    if(options & PGEN_DIRECT_PARSER) {
+        fclose(info.direct.functions);
+        fclose(info.direct.phrases);
+        dict_free(
+            info.direct.productions,
+            &delegate_do_nothing,
+            &delegate_do_nothing
+        );
+        if(is_not_null(info.direct.grammar)) {
+            grammar_free(info.direct.grammar);
+        }
+        if(is_not_null(info.direct.names)) {
+            mem_free(info.direct.names);
+        }
+    }
+
     fclose(info.fp);
 }
+
+/**
+ * Generate the grammar building function and scanner for a language. Parsing
+ * with the grammar is done by parse_tokens.
+ */
+void parser_gen(char *grammar_input_file,
+                char *grammar_func_name,
+                char *grammar_output_file,
+                char *lexer_func_name,
+                char *lexer_output_file,
+                char *language_name) {
+    parser_gen_options(
+        grammar_input_file,
+        grammar_func_name,
+        grammar_output_file,
+        lexer_func_name,
+        lexer_output_file,
+        language_name,
+        0
+    );
+}
+
+/**
+ * Generate the grammar building function and scanner for a language, as well
+ * as a direct-coded parser for it. The direct-coded parser has a function for
+ * each production, named <grammar_func_name>_direct for the start production,
+ * that is passed to parser_parse_tokens_direct along with the grammar.
+ * Direct-coded parsers can't grow left recursion, so a grammar with a left
+ * recursive production rule is rejected; it can still be parsed with
+ * parse_tokens.
+ */
+void parser_gen_direct(char *grammar_input_file,
+                       char *grammar_func_name,
+                       char *grammar_output_file,
+                       char *lexer_func_name,
+                       char *lexer_output_file,
+                       char *language_name) {
+    parser_gen_options(
+        grammar_input_file,
+        grammar_func_name,
+        grammar_output_file,
+        lexer_func_name,
+        lexer_output_file,
+        language_name,
+        PGEN_DIRECT_PARSER
+    );
+}
@@ -7,1394 +7,1187 @@
  */
 
 #include <pgen-lexer.h>
+
+static const uint32_t parser_grammar_lexer_keyword_seeds_9[1] = {
+    1
+};
+
+static const PScannerKeyword parser_grammar_lexer_keyword_slots_9[1] = {
+    {"Self", 4, 13}
+};
+
+static const PScannerKeywords parser_grammar_lexer_keywords_9 = {
+    1, 1, 4,
+    parser_grammar_lexer_keyword_seeds_9,
+    parser_grammar_lexer_keyword_slots_9
+};
+
+static const PScannerRun parser_grammar_lexer_run_2 = {
+    {168,248,248,248,248,248,248,248,248,248,240,80,80,80,80,112},
+    4,
+    {{48,9},{65,25},{95,0},{97,25}}
+};
+
+static const PScannerRun parser_grammar_lexer_run_4 = {
+    {168,248,248,248,248,248,248,248,248,248,240,80,80,80,80,112},
+    4,
+    {{48,9},{65,25},{95,0},{97,25}}
+};
+
+static const PScannerRun parser_grammar_lexer_run_15 = {
+    {254,255,255,255,255,255,255,251,255,255,255,255,223,255,255,255},
+    3,
+    {{1,37},{40,51},{93,34}}
+};
+
+static const PScannerRun parser_grammar_lexer_run_17 = {
+    {254,255,251,255,255,255,255,255,255,255,255,255,223,255,255,255},
+    3,
+    {{1,32},{35,56},{93,34}}
+};
+
+static const PScannerRun parser_grammar_lexer_run_19 = {
+    {0,0,0,0,0,0,0,0,0,0,0,0,32,0,0,0},
+    1,
+    {{92,0}}
+};
+
+static const PScannerRun parser_grammar_lexer_run_26 = {
+    {0,0,0,0,0,0,0,0,0,0,0,0,32,0,0,0},
+    1,
+    {{92,0}}
+};
+
 G_Terminal parser_grammar_lexer(PScanner *S) {
     G_Terminal term = -1;
     unsigned int seen_accepting_state = 0;
     int cc, nc = 0, pnc = 0;
-    scanner_skip(S, &isspace);
+    scanner_skip_space(S);
     scanner_mark_lexeme_start(S);
 state_0:
     if(!(cc = scanner_advance(S))) { goto undo_and_commit; }
     ++nc;
     switch(cc) {
-        case 33: goto state_20;
-        case 34: goto state_19;
-        case 38: goto state_18;
-        case 39: goto state_17;
-        case 40: goto state_16;
-        case 41: goto state_15;
-        case 42: goto state_14;
-        case 43: goto state_13;
-        case 45: goto state_12;
-        case 58: goto state_11;
-        case 59: goto state_10;
-        case 60: goto state_9;
-        case 62: goto state_8;
-        case 63: goto state_7;
-        case 65: goto state_5;
-        case 66: goto state_5;
-        case 67: goto state_5;
-        case 68: goto state_5;
-        case 69: goto state_5;
-        case 70: goto state_5;
-        case 71: goto state_5;
-        case 72: goto state_5;
-        case 73: goto state_5;
-        case 74: goto state_5;
-        case 75: goto state_5;
-        case 76: goto state_5;
-        case 77: goto state_5;
-        case 78: goto state_5;
-        case 79: goto state_5;
-        case 80: goto state_5;
-        case 81: goto state_5;
-        case 82: goto state_5;
-        case 83: goto state_6;
-        case 84: goto state_5;
-        case 85: goto state_5;
-        case 86: goto state_5;
-        case 87: goto state_5;
-        case 88: goto state_5;
-        case 89: goto state_5;
-        case 90: goto state_5;
-        case 94: goto state_4;
-        case 97: goto state_3;
-        case 98: goto state_3;
-        case 99: goto state_3;
-        case 100: goto state_3;
-        case 101: goto state_3;
-        case 102: goto state_3;
-        case 103: goto state_3;
-        case 104: goto state_3;
-        case 105: goto state_3;
-        case 106: goto state_3;
-        case 107: goto state_3;
-        case 108: goto state_3;
-        case 109: goto state_3;
-        case 110: goto state_3;
-        case 111: goto state_3;
-        case 112: goto state_3;
-        case 113: goto state_3;
-        case 114: goto state_3;
-        case 115: goto state_3;
-        case 116: goto state_3;
-        case 117: goto state_3;
-        case 118: goto state_3;
-        case 119: goto state_3;
-        case 120: goto state_3;
-        case 121: goto state_3;
-        case 122: goto state_3;
-        case 124: goto state_2;
-        case 126: goto state_1;
+        case 124: goto state_1;
+        case 122: goto state_2;
+        case 120: goto state_2;
+        case 119: goto state_2;
+        case 118: goto state_2;
+        case 117: goto state_2;
+        case 116: goto state_2;
+        case 114: goto state_2;
+        case 113: goto state_2;
+        case 112: goto state_2;
+        case 111: goto state_2;
+        case 109: goto state_2;
+        case 108: goto state_2;
+        case 107: goto state_2;
+        case 106: goto state_2;
+        case 105: goto state_2;
+        case 104: goto state_2;
+        case 103: goto state_2;
+        case 102: goto state_2;
+        case 101: goto state_2;
+        case 100: goto state_2;
+        case 98: goto state_2;
+        case 97: goto state_2;
+        case 121: goto state_2;
+        case 115: goto state_2;
+        case 110: goto state_2;
+        case 99: goto state_2;
+        case 94: goto state_3;
+        case 90: goto state_4;
+        case 89: goto state_4;
+        case 88: goto state_4;
+        case 87: goto state_4;
+        case 86: goto state_4;
+        case 85: goto state_4;
+        case 84: goto state_4;
+        case 83: goto state_4;
+        case 82: goto state_4;
+        case 81: goto state_4;
+        case 80: goto state_4;
+        case 79: goto state_4;
+        case 78: goto state_4;
+        case 77: goto state_4;
+        case 76: goto state_4;
+        case 75: goto state_4;
+        case 74: goto state_4;
+        case 73: goto state_4;
+        case 72: goto state_4;
+        case 71: goto state_4;
+        case 70: goto state_4;
+        case 69: goto state_4;
+        case 68: goto state_4;
+        case 67: goto state_4;
+        case 66: goto state_4;
+        case 65: goto state_4;
+        case 63: goto state_5;
+        case 62: goto state_6;
+        case 60: goto state_7;
+        case 59: goto state_8;
+        case 58: goto state_9;
+        case 45: goto state_10;
+        case 43: goto state_11;
+        case 42: goto state_12;
+        case 41: goto state_13;
+        case 40: goto state_14;
+        case 39: goto state_15;
+        case 37: goto state_16;
+        case 34: goto state_17;
+        case 33: goto state_18;
         default: goto undo_and_commit;
     }
 state_1:
-    term = 16;
-    goto commit;
-state_2:
     term = 4;
     goto commit;
-state_3:
+state_2:
+    nc += (int) scanner_skip_run(S, &parser_grammar_lexer_run_2);
     term = 12;
     pnc = nc;
     seen_accepting_state = 1;
     if(!(cc = scanner_advance(S))) { goto undo_and_commit; }
     ++nc;
     switch(cc) {
-        case 48: goto state_3;
-        case 49: goto state_3;
-        case 50: goto state_3;
-        case 51: goto state_3;
-        case 52: goto state_3;
-        case 53: goto state_3;
-        case 54: goto state_3;
-        case 55: goto state_3;
-        case 56: goto state_3;
-        case 57: goto state_3;
-        case 65: goto state_3;
-        case 66: goto state_3;
-        case 67: goto state_3;
-        case 68: goto state_3;
-        case 69: goto state_3;
-        case 70: goto state_3;
-        case 71: goto state_3;
-        case 72: goto state_3;
-        case 73: goto state_3;
-        case 74: goto state_3;
-        case 75: goto state_3;
-        case 76: goto state_3;
-        case 77: goto state_3;
-        case 78: goto state_3;
-        case 79: goto state_3;
-        case 80: goto state_3;
-        case 81: goto state_3;
-        case 82: goto state_3;
-        case 83: goto state_3;
-        case 84: goto state_3;
-        case 85: goto state_3;
-        case 86: goto state_3;
-        case 87: goto state_3;
-        case 88: goto state_3;
-        case 89: goto state_3;
-        case 90: goto state_3;
-        case 95: goto state_3;
-        case 97: goto state_3;
-        case 98: goto state_3;
-        case 99: goto state_3;
-        case 100: goto state_3;
-        case 101: goto state_3;
-        case 102: goto state_3;
-        case 103: goto state_3;
-        case 104: goto state_3;
-        case 105: goto state_3;
-        case 106: goto state_3;
-        case 107: goto state_3;
-        case 108: goto state_3;
-        case 109: goto state_3;
-        case 110: goto state_3;
-        case 111: goto state_3;
-        case 112: goto state_3;
-        case 113: goto state_3;
-        case 114: goto state_3;
-        case 115: goto state_3;
-        case 116: goto state_3;
-        case 117: goto state_3;
-        case 118: goto state_3;
-        case 119: goto state_3;
-        case 120: goto state_3;
-        case 121: goto state_3;
-        case 122: goto state_3;
+        case 122: goto state_2;
+        case 120: goto state_2;
+        case 119: goto state_2;
+        case 118: goto state_2;
+        case 117: goto state_2;
+        case 116: goto state_2;
+        case 114: goto state_2;
+        case 113: goto state_2;
+        case 112: goto state_2;
+        case 111: goto state_2;
+        case 109: goto state_2;
+        case 108: goto state_2;
+        case 107: goto state_2;
+        case 106: goto state_2;
+        case 105: goto state_2;
+        case 104: goto state_2;
+        case 103: goto state_2;
+        case 102: goto state_2;
+        case 101: goto state_2;
+        case 100: goto state_2;
+        case 98: goto state_2;
+        case 97: goto state_2;
+        case 121: goto state_2;
+        case 115: goto state_2;
+        case 110: goto state_2;
+        case 99: goto state_2;
+        case 95: goto state_2;
+        case 57: goto state_2;
+        case 56: goto state_2;
+        case 55: goto state_2;
+        case 54: goto state_2;
+        case 53: goto state_2;
+        case 52: goto state_2;
+        case 51: goto state_2;
+        case 50: goto state_2;
+        case 49: goto state_2;
+        case 48: goto state_2;
+        case 90: goto state_2;
+        case 89: goto state_2;
+        case 88: goto state_2;
+        case 87: goto state_2;
+        case 86: goto state_2;
+        case 85: goto state_2;
+        case 84: goto state_2;
+        case 83: goto state_2;
+        case 82: goto state_2;
+        case 81: goto state_2;
+        case 80: goto state_2;
+        case 79: goto state_2;
+        case 78: goto state_2;
+        case 77: goto state_2;
+        case 76: goto state_2;
+        case 75: goto state_2;
+        case 74: goto state_2;
+        case 73: goto state_2;
+        case 72: goto state_2;
+        case 71: goto state_2;
+        case 70: goto state_2;
+        case 69: goto state_2;
+        case 68: goto state_2;
+        case 67: goto state_2;
+        case 66: goto state_2;
+        case 65: goto state_2;
         default: goto undo_and_commit;
     }
-state_4:
+state_3:
     term = 15;
     goto commit;
-state_5:
-    term = 8;
+state_4:
+    nc += (int) scanner_skip_run(S, &parser_grammar_lexer_run_4);
+    term = 9;
     pnc = nc;
     seen_accepting_state = 1;
     if(!(cc = scanner_advance(S))) { goto undo_and_commit; }
     ++nc;
     switch(cc) {
-        case 48: goto state_5;
-        case 49: goto state_5;
-        case 50: goto state_5;
-        case 51: goto state_5;
-        case 52: goto state_5;
-        case 53: goto state_5;
-        case 54: goto state_5;
-        case 55: goto state_5;
-        case 56: goto state_5;
-        case 57: goto state_5;
-        case 65: goto state_5;
-        case 66: goto state_5;
-        case 67: goto state_5;
-        case 68: goto state_5;
-        case 69: goto state_5;
-        case 70: goto state_5;
-        case 71: goto state_5;
-        case 72: goto state_5;
-        case 73: goto state_5;
-        case 74: goto state_5;
-        case 75: goto state_5;
-        case 76: goto state_5;
-        case 77: goto state_5;
-        case 78: goto state_5;
-        case 79: goto state_5;
-        case 80: goto state_5;
-        case 81: goto state_5;
-        case 82: goto state_5;
-        case 83: goto state_5;
-        case 84: goto state_5;
-        case 85: goto state_5;
-        case 86: goto state_5;
-        case 87: goto state_5;
-        case 88: goto state_5;
-        case 89: goto state_5;
-        case 90: goto state_5;
-        case 95: goto state_5;
-        case 97: goto state_5;
-        case 98: goto state_5;
-        case 99: goto state_5;
-        case 100: goto state_5;
-        case 101: goto state_5;
-        case 102: goto state_5;
-        case 103: goto state_5;
-        case 104: goto state_5;
-        case 105: goto state_5;
-        case 106: goto state_5;
-        case 107: goto state_5;
-        case 108: goto state_5;
-        case 109: goto state_5;
-        case 110: goto state_5;
-        case 111: goto state_5;
-        case 112: goto state_5;
-        case 113: goto state_5;
-        case 114: goto state_5;
-        case 115: goto state_5;
-        case 116: goto state_5;
-        case 117: goto state_5;
-        case 118: goto state_5;
-        case 119: goto state_5;
-        case 120: goto state_5;
-        case 121: goto state_5;
-        case 122: goto state_5;
+        case 122: goto state_4;
+        case 120: goto state_4;
+        case 119: goto state_4;
+        case 118: goto state_4;
+        case 117: goto state_4;
+        case 116: goto state_4;
+        case 114: goto state_4;
+        case 113: goto state_4;
+        case 112: goto state_4;
+        case 111: goto state_4;
+        case 109: goto state_4;
+        case 108: goto state_4;
+        case 107: goto state_4;
+        case 106: goto state_4;
+        case 105: goto state_4;
+        case 104: goto state_4;
+        case 103: goto state_4;
+        case 102: goto state_4;
+        case 101: goto state_4;
+        case 100: goto state_4;
+        case 98: goto state_4;
+        case 97: goto state_4;
+        case 121: goto state_4;
+        case 115: goto state_4;
+        case 110: goto state_4;
+        case 99: goto state_4;
+        case 95: goto state_4;
+        case 57: goto state_4;
+        case 56: goto state_4;
+        case 55: goto state_4;
+        case 54: goto state_4;
+        case 53: goto state_4;
+        case 52: goto state_4;
+        case 51: goto state_4;
+        case 50: goto state_4;
+        case 49: goto state_4;
+        case 48: goto state_4;
+        case 90: goto state_4;
+        case 89: goto state_4;
+        case 88: goto state_4;
+        case 87: goto state_4;
+        case 86: goto state_4;
+        case 85: goto state_4;
+        case 84: goto state_4;
+        case 83: goto state_4;
+        case 82: goto state_4;
+        case 81: goto state_4;
+        case 80: goto state_4;
+        case 79: goto state_4;
+        case 78: goto state_4;
+        case 77: goto state_4;
+        case 76: goto state_4;
+        case 75: goto state_4;
+        case 74: goto state_4;
+        case 73: goto state_4;
+        case 72: goto state_4;
+        case 71: goto state_4;
+        case 70: goto state_4;
+        case 69: goto state_4;
+        case 68: goto state_4;
+        case 67: goto state_4;
+        case 66: goto state_4;
+        case 65: goto state_4;
         default: goto undo_and_commit;
     }
+state_5:
+    term = 17;
+    goto commit;
 state_6:
-    term = 8;
-    pnc = nc;
-    seen_accepting_state = 1;
     if(!(cc = scanner_advance(S))) { goto undo_and_commit; }
     ++nc;
     switch(cc) {
-        case 48: goto state_5;
-        case 49: goto state_5;
-        case 50: goto state_5;
-        case 51: goto state_5;
-        case 52: goto state_5;
-        case 53: goto state_5;
-        case 54: goto state_5;
-        case 55: goto state_5;
-        case 56: goto state_5;
-        case 57: goto state_5;
-        case 65: goto state_5;
-        case 66: goto state_5;
-        case 67: goto state_5;
-        case 68: goto state_5;
-        case 69: goto state_5;
-        case 70: goto state_5;
-        case 71: goto state_5;
-        case 72: goto state_5;
-        case 73: goto state_5;
-        case 74: goto state_5;
-        case 75: goto state_5;
-        case 76: goto state_5;
-        case 77: goto state_5;
-        case 78: goto state_5;
-        case 79: goto state_5;
-        case 80: goto state_5;
-        case 81: goto state_5;
-        case 82: goto state_5;
-        case 83: goto state_5;
-        case 84: goto state_5;
-        case 85: goto state_5;
-        case 86: goto state_5;
-        case 87: goto state_5;
-        case 88: goto state_5;
-        case 89: goto state_5;
-        case 90: goto state_5;
-        case 95: goto state_5;
-        case 97: goto state_5;
-        case 98: goto state_5;
-        case 99: goto state_5;
-        case 100: goto state_5;
-        case 101: goto state_29;
-        case 102: goto state_5;
-        case 103: goto state_5;
-        case 104: goto state_5;
-        case 105: goto state_5;
-        case 106: goto state_5;
-        case 107: goto state_5;
-        case 108: goto state_5;
-        case 109: goto state_5;
-        case 110: goto state_5;
-        case 111: goto state_5;
-        case 112: goto state_5;
-        case 113: goto state_5;
-        case 114: goto state_5;
-        case 115: goto state_5;
-        case 116: goto state_5;
-        case 117: goto state_5;
-        case 118: goto state_5;
-        case 119: goto state_5;
-        case 120: goto state_5;
-        case 121: goto state_5;
-        case 122: goto state_5;
+        case 60: goto state_30;
         default: goto undo_and_commit;
     }
 state_7:
-    term = 18;
-    goto commit;
-state_8:
     if(!(cc = scanner_advance(S))) { goto undo_and_commit; }
     ++nc;
     switch(cc) {
-        case 60: goto state_28;
+        case 62: goto state_29;
         default: goto undo_and_commit;
     }
+state_8:
+    term = 6;
+    goto commit;
 state_9:
-    if(!(cc = scanner_advance(S))) { goto undo_and_commit; }
-    ++nc;
-    switch(cc) {
-        case 62: goto state_27;
-        default: goto undo_and_commit;
-    }
-state_10:
     term = 7;
     goto commit;
+state_10:
+    term = 11;
+    goto commit;
 state_11:
-    term = 9;
+    term = 2;
     goto commit;
 state_12:
-    term = 11;
+    term = 10;
     goto commit;
 state_13:
-    term = 1;
+    term = 0;
     goto commit;
 state_14:
-    term = 10;
+    term = 1;
     goto commit;
 state_15:
-    term = 0;
-    goto commit;
-state_16:
-    term = 3;
-    goto commit;
-state_17:
-    if(!(cc = scanner_advance(S))) { goto undo_and_commit; }
-    ++nc;
-    switch(cc) {
-        case 69: goto state_17;
-        case 70: goto state_17;
-        case 71: goto state_17;
-        case 72: goto state_17;
-        case 73: goto state_17;
-        case 74: goto state_17;
-        case 75: goto state_17;
-        case 76: goto state_17;
-        case 77: goto state_17;
-        case 78: goto state_17;
-        case 79: goto state_17;
-        case 80: goto state_17;
-        case 81: goto state_17;
-        case 82: goto state_17;
-        case 83: goto state_17;
-        case 84: goto state_17;
-        case 85: goto state_17;
-        case 86: goto state_17;
-        case 87: goto state_17;
-        case 88: goto state_17;
-        case 89: goto state_17;
-        case 90: goto state_17;
-        case 91: goto state_17;
-        case 92: goto state_24;
-        case 93: goto state_17;
-        case 94: goto state_17;
-        case 95: goto state_17;
-        case 96: goto state_17;
-        case 97: goto state_17;
-        case 98: goto state_17;
-        case 99: goto state_17;
-        case 100: goto state_17;
-        case 101: goto state_17;
-        case 102: goto state_17;
-        case 103: goto state_17;
-        case 104: goto state_17;
-        case 105: goto state_17;
-        case 106: goto state_17;
-        case 107: goto state_17;
-        case 108: goto state_17;
-        case 109: goto state_17;
-        case 110: goto state_17;
-        case 111: goto state_17;
-        case 112: goto state_17;
-        case 113: goto state_17;
-        case 114: goto state_17;
-        case 115: goto state_17;
-        case 116: goto state_17;
-        case 117: goto state_17;
-        case 118: goto state_17;
-        case 119: goto state_17;
-        case 120: goto state_17;
-        case 121: goto state_17;
-        case 122: goto state_17;
-        case 123: goto state_17;
-        case 124: goto state_17;
-        case 125: goto state_17;
-        case 126: goto state_17;
-        case 127: goto state_17;
-        case 0: goto state_17;
-        case 1: goto state_17;
-        case 2: goto state_17;
-        case 3: goto state_17;
-        case 4: goto state_17;
-        case 5: goto state_17;
-        case 6: goto state_17;
-        case 7: goto state_17;
-        case 8: goto state_17;
-        case 9: goto state_17;
-        case 10: goto state_17;
-        case 11: goto state_17;
-        case 12: goto state_17;
-        case 13: goto state_17;
-        case 14: goto state_17;
-        case 15: goto state_17;
-        case 16: goto state_17;
-        case 17: goto state_17;
-        case 18: goto state_17;
-        case 19: goto state_17;
-        case 20: goto state_17;
-        case 21: goto state_17;
-        case 22: goto state_17;
-        case 23: goto state_17;
-        case 24: goto state_17;
-        case 25: goto state_17;
-        case 26: goto state_17;
-        case 27: goto state_17;
-        case 28: goto state_17;
-        case 29: goto state_17;
-        case 30: goto state_17;
-        case 31: goto state_17;
-        case 32: goto state_17;
-        case 33: goto state_17;
-        case 34: goto state_17;
-        case 35: goto state_17;
-        case 36: goto state_17;
-        case 37: goto state_17;
-        case 38: goto state_17;
-        case 39: goto state_25;
-        case 40: goto state_17;
-        case 41: goto state_17;
-        case 42: goto state_17;
-        case 43: goto state_17;
-        case 44: goto state_17;
-        case 45: goto state_17;
-        case 46: goto state_17;
-        case 47: goto state_17;
-        case 48: goto state_17;
-        case 49: goto state_17;
-        case 50: goto state_17;
-        case 51: goto state_17;
-        case 52: goto state_17;
-        case 53: goto state_17;
-        case 54: goto state_17;
-        case 55: goto state_17;
-        case 56: goto state_17;
-        case 57: goto state_17;
-        case 58: goto state_17;
-        case 59: goto state_17;
-        case 60: goto state_17;
-        case 61: goto state_17;
-        case 62: goto state_17;
-        case 63: goto state_17;
-        case 64: goto state_17;
-        case 65: goto state_17;
-        case 66: goto state_17;
-        case 67: goto state_17;
-        case 68: goto state_17;
-        default: goto undo_and_commit;
-    }
-state_18:
-    term = 5;
-    goto commit;
-state_19:
-    if(!(cc = scanner_advance(S))) { goto undo_and_commit; }
-    ++nc;
-    switch(cc) {
-        case 69: goto state_19;
-        case 70: goto state_19;
-        case 71: goto state_19;
-        case 72: goto state_19;
-        case 73: goto state_19;
-        case 74: goto state_19;
-        case 75: goto state_19;
-        case 76: goto state_19;
-        case 77: goto state_19;
-        case 78: goto state_19;
-        case 79: goto state_19;
-        case 80: goto state_19;
-        case 81: goto state_19;
-        case 82: goto state_19;
-        case 83: goto state_19;
-        case 84: goto state_19;
-        case 85: goto state_19;
-        case 86: goto state_19;
-        case 87: goto state_19;
-        case 88: goto state_19;
-        case 89: goto state_19;
-        case 90: goto state_19;
-        case 91: goto state_19;
-        case 92: goto state_21;
-        case 93: goto state_19;
-        case 94: goto state_19;
-        case 95: goto state_19;
-        case 96: goto state_19;
-        case 97: goto state_19;
-        case 98: goto state_19;
-        case 99: goto state_19;
-        case 100: goto state_19;
-        case 101: goto state_19;
-        case 102: goto state_19;
-        case 103: goto state_19;
-        case 104: goto state_19;
-        case 105: goto state_19;
-        case 106: goto state_19;
-        case 107: goto state_19;
-        case 108: goto state_19;
-        case 109: goto state_19;
-        case 110: goto state_19;
-        case 111: goto state_19;
-        case 112: goto state_19;
-        case 113: goto state_19;
-        case 114: goto state_19;
-        case 115: goto state_19;
-        case 116: goto state_19;
-        case 117: goto state_19;
-        case 118: goto state_19;
-        case 119: goto state_19;
-        case 120: goto state_19;
-        case 121: goto state_19;
-        case 122: goto state_19;
-        case 123: goto state_19;
-        case 124: goto state_19;
-        case 125: goto state_19;
-        case 126: goto state_19;
-        case 127: goto state_19;
-        case 0: goto state_19;
-        case 1: goto state_19;
-        case 2: goto state_19;
-        case 3: goto state_19;
-        case 4: goto state_19;
-        case 5: goto state_19;
-        case 6: goto state_19;
-        case 7: goto state_19;
-        case 8: goto state_19;
-        case 9: goto state_19;
-        case 10: goto state_19;
-        case 11: goto state_19;
-        case 12: goto state_19;
-        case 13: goto state_19;
-        case 14: goto state_19;
-        case 15: goto state_19;
-        case 16: goto state_19;
-        case 17: goto state_19;
-        case 18: goto state_19;
-        case 19: goto state_19;
-        case 20: goto state_19;
-        case 21: goto state_19;
-        case 22: goto state_19;
-        case 23: goto state_19;
-        case 24: goto state_19;
-        case 25: goto state_19;
-        case 26: goto state_19;
-        case 27: goto state_19;
-        case 28: goto state_19;
-        case 29: goto state_19;
-        case 30: goto state_19;
-        case 31: goto state_19;
-        case 32: goto state_19;
-        case 33: goto state_19;
-        case 34: goto state_22;
-        case 35: goto state_19;
-        case 36: goto state_19;
-        case 37: goto state_19;
-        case 38: goto state_19;
-        case 39: goto state_19;
-        case 40: goto state_19;
-        case 41: goto state_19;
-        case 42: goto state_19;
-        case 43: goto state_19;
-        case 44: goto state_19;
-        case 45: goto state_19;
-        case 46: goto state_19;
-        case 47: goto state_19;
-        case 48: goto state_19;
-        case 49: goto state_19;
-        case 50: goto state_19;
-        case 51: goto state_19;
-        case 52: goto state_19;
-        case 53: goto state_19;
-        case 54: goto state_19;
-        case 55: goto state_19;
-        case 56: goto state_19;
-        case 57: goto state_19;
-        case 58: goto state_19;
-        case 59: goto state_19;
-        case 60: goto state_19;
-        case 61: goto state_19;
-        case 62: goto state_19;
-        case 63: goto state_19;
-        case 64: goto state_19;
-        case 65: goto state_19;
-        case 66: goto state_19;
-        case 67: goto state_19;
-        case 68: goto state_19;
-        default: goto undo_and_commit;
-    }
-state_20:
-    term = 14;
-    goto commit;
-state_21:
+    nc += (int) scanner_skip_run(S, &parser_grammar_lexer_run_15);
     if(!(cc = scanner_advance(S))) { goto undo_and_commit; }
     ++nc;
     switch(cc) {
-        case 69: goto state_19;
-        case 70: goto state_19;
-        case 71: goto state_19;
-        case 72: goto state_19;
-        case 73: goto state_19;
-        case 74: goto state_19;
-        case 75: goto state_19;
-        case 76: goto state_19;
-        case 77: goto state_19;
-        case 78: goto state_19;
-        case 79: goto state_19;
-        case 80: goto state_19;
-        case 81: goto state_19;
-        case 82: goto state_19;
-        case 83: goto state_19;
-        case 84: goto state_19;
-        case 85: goto state_19;
-        case 86: goto state_19;
-        case 87: goto state_19;
-        case 88: goto state_19;
-        case 89: goto state_19;
-        case 90: goto state_19;
-        case 91: goto state_19;
-        case 92: goto state_21;
-        case 93: goto state_19;
-        case 94: goto state_19;
-        case 95: goto state_19;
-        case 96: goto state_19;
-        case 97: goto state_19;
-        case 98: goto state_19;
-        case 99: goto state_19;
-        case 100: goto state_19;
-        case 101: goto state_19;
-        case 102: goto state_19;
-        case 103: goto state_19;
-        case 104: goto state_19;
-        case 105: goto state_19;
-        case 106: goto state_19;
-        case 107: goto state_19;
-        case 108: goto state_19;
-        case 109: goto state_19;
-        case 110: goto state_19;
-        case 111: goto state_19;
-        case 112: goto state_19;
-        case 113: goto state_19;
-        case 114: goto state_19;
-        case 115: goto state_19;
-        case 116: goto state_19;
-        case 117: goto state_19;
-        case 118: goto state_19;
-        case 119: goto state_19;
-        case 120: goto state_19;
-        case 121: goto state_19;
-        case 122: goto state_19;
-        case 123: goto state_19;
-        case 124: goto state_19;
-        case 125: goto state_19;
-        case 126: goto state_19;
-        case 127: goto state_19;
-        case 0: goto state_19;
-        case 1: goto state_19;
-        case 2: goto state_19;
-        case 3: goto state_19;
-        case 4: goto state_19;
-        case 5: goto state_19;
-        case 6: goto state_19;
-        case 7: goto state_19;
-        case 8: goto state_19;
-        case 9: goto state_19;
-        case 10: goto state_19;
-        case 11: goto state_19;
-        case 12: goto state_19;
-        case 13: goto state_19;
-        case 14: goto state_19;
-        case 15: goto state_19;
-        case 16: goto state_19;
-        case 17: goto state_19;
-        case 18: goto state_19;
-        case 19: goto state_19;
-        case 20: goto state_19;
-        case 21: goto state_19;
-        case 22: goto state_19;
-        case 23: goto state_19;
-        case 24: goto state_19;
-        case 25: goto state_19;
-        case 26: goto state_19;
-        case 27: goto state_19;
-        case 28: goto state_19;
-        case 29: goto state_19;
-        case 30: goto state_19;
-        case 31: goto state_19;
-        case 32: goto state_19;
-        case 33: goto state_19;
-        case 34: goto state_23;
-        case 35: goto state_19;
-        case 36: goto state_19;
-        case 37: goto state_19;
-        case 38: goto state_19;
-        case 39: goto state_19;
-        case 40: goto state_19;
-        case 41: goto state_19;
-        case 42: goto state_19;
-        case 43: goto state_19;
-        case 44: goto state_19;
-        case 45: goto state_19;
-        case 46: goto state_19;
-        case 47: goto state_19;
-        case 48: goto state_19;
-        case 49: goto state_19;
-        case 50: goto state_19;
-        case 51: goto state_19;
-        case 52: goto state_19;
-        case 53: goto state_19;
-        case 54: goto state_19;
-        case 55: goto state_19;
-        case 56: goto state_19;
-        case 57: goto state_19;
-        case 58: goto state_19;
-        case 59: goto state_19;
-        case 60: goto state_19;
-        case 61: goto state_19;
-        case 62: goto state_19;
-        case 63: goto state_19;
-        case 64: goto state_19;
-        case 65: goto state_19;
-        case 66: goto state_19;
-        case 67: goto state_19;
-        case 68: goto state_19;
+        case 127: goto state_15;
+        case 126: goto state_15;
+        case 125: goto state_15;
+        case 123: goto state_15;
+        case 96: goto state_15;
+        case 93: goto state_15;
+        case 91: goto state_15;
+        case 64: goto state_15;
+        case 61: goto state_15;
+        case 47: goto state_15;
+        case 46: goto state_15;
+        case 44: goto state_15;
+        case 38: goto state_15;
+        case 36: goto state_15;
+        case 35: goto state_15;
+        case 32: goto state_15;
+        case 31: goto state_15;
+        case 30: goto state_15;
+        case 29: goto state_15;
+        case 28: goto state_15;
+        case 27: goto state_15;
+        case 26: goto state_15;
+        case 25: goto state_15;
+        case 24: goto state_15;
+        case 23: goto state_15;
+        case 22: goto state_15;
+        case 21: goto state_15;
+        case 20: goto state_15;
+        case 19: goto state_15;
+        case 18: goto state_15;
+        case 17: goto state_15;
+        case 16: goto state_15;
+        case 15: goto state_15;
+        case 14: goto state_15;
+        case 13: goto state_15;
+        case 12: goto state_15;
+        case 11: goto state_15;
+        case 10: goto state_15;
+        case 9: goto state_15;
+        case 8: goto state_15;
+        case 7: goto state_15;
+        case 6: goto state_15;
+        case 5: goto state_15;
+        case 4: goto state_15;
+        case 3: goto state_15;
+        case 2: goto state_15;
+        case 1: goto state_15;
+        case 0: goto state_15;
+        case 124: goto state_15;
+        case 122: goto state_15;
+        case 120: goto state_15;
+        case 119: goto state_15;
+        case 118: goto state_15;
+        case 117: goto state_15;
+        case 116: goto state_15;
+        case 114: goto state_15;
+        case 113: goto state_15;
+        case 112: goto state_15;
+        case 111: goto state_15;
+        case 109: goto state_15;
+        case 108: goto state_15;
+        case 107: goto state_15;
+        case 106: goto state_15;
+        case 105: goto state_15;
+        case 104: goto state_15;
+        case 103: goto state_15;
+        case 102: goto state_15;
+        case 101: goto state_15;
+        case 100: goto state_15;
+        case 98: goto state_15;
+        case 97: goto state_15;
+        case 121: goto state_15;
+        case 115: goto state_15;
+        case 110: goto state_15;
+        case 99: goto state_15;
+        case 95: goto state_15;
+        case 57: goto state_15;
+        case 56: goto state_15;
+        case 55: goto state_15;
+        case 54: goto state_15;
+        case 53: goto state_15;
+        case 52: goto state_15;
+        case 51: goto state_15;
+        case 50: goto state_15;
+        case 49: goto state_15;
+        case 48: goto state_15;
+        case 94: goto state_15;
+        case 92: goto state_26;
+        case 90: goto state_15;
+        case 89: goto state_15;
+        case 88: goto state_15;
+        case 87: goto state_15;
+        case 86: goto state_15;
+        case 85: goto state_15;
+        case 84: goto state_15;
+        case 83: goto state_15;
+        case 82: goto state_15;
+        case 81: goto state_15;
+        case 80: goto state_15;
+        case 79: goto state_15;
+        case 78: goto state_15;
+        case 77: goto state_15;
+        case 76: goto state_15;
+        case 75: goto state_15;
+        case 74: goto state_15;
+        case 73: goto state_15;
+        case 72: goto state_15;
+        case 71: goto state_15;
+        case 70: goto state_15;
+        case 69: goto state_15;
+        case 68: goto state_15;
+        case 67: goto state_15;
+        case 66: goto state_15;
+        case 65: goto state_15;
+        case 63: goto state_15;
+        case 62: goto state_15;
+        case 60: goto state_15;
+        case 59: goto state_15;
+        case 58: goto state_15;
+        case 45: goto state_15;
+        case 43: goto state_15;
+        case 42: goto state_15;
+        case 41: goto state_15;
+        case 40: goto state_15;
+        case 39: goto state_27;
+        case 37: goto state_15;
+        case 34: goto state_15;
+        case 33: goto state_15;
         default: goto undo_and_commit;
     }
-state_22:
-    term = 17;
-    goto commit;
-state_23:
-    term = 17;
-    pnc = nc;
-    seen_accepting_state = 1;
+state_16:
     if(!(cc = scanner_advance(S))) { goto undo_and_commit; }
     ++nc;
     switch(cc) {
-        case 0: goto state_19;
-        case 1: goto state_19;
-        case 2: goto state_19;
-        case 3: goto state_19;
-        case 4: goto state_19;
-        case 5: goto state_19;
-        case 6: goto state_19;
-        case 7: goto state_19;
-        case 8: goto state_19;
-        case 9: goto state_19;
-        case 10: goto state_19;
-        case 11: goto state_19;
-        case 12: goto state_19;
-        case 13: goto state_19;
-        case 14: goto state_19;
-        case 15: goto state_19;
-        case 16: goto state_19;
-        case 17: goto state_19;
-        case 18: goto state_19;
-        case 19: goto state_19;
-        case 20: goto state_19;
-        case 21: goto state_19;
-        case 22: goto state_19;
-        case 23: goto state_19;
-        case 24: goto state_19;
-        case 25: goto state_19;
-        case 26: goto state_19;
-        case 27: goto state_19;
-        case 28: goto state_19;
-        case 29: goto state_19;
-        case 30: goto state_19;
-        case 31: goto state_19;
-        case 32: goto state_19;
-        case 33: goto state_19;
-        case 34: goto state_22;
-        case 35: goto state_19;
-        case 36: goto state_19;
-        case 37: goto state_19;
-        case 38: goto state_19;
-        case 39: goto state_19;
-        case 40: goto state_19;
-        case 41: goto state_19;
-        case 42: goto state_19;
-        case 43: goto state_19;
-        case 44: goto state_19;
-        case 45: goto state_19;
-        case 46: goto state_19;
-        case 47: goto state_19;
-        case 48: goto state_19;
-        case 49: goto state_19;
-        case 50: goto state_19;
-        case 51: goto state_19;
-        case 52: goto state_19;
-        case 53: goto state_19;
-        case 54: goto state_19;
-        case 55: goto state_19;
-        case 56: goto state_19;
-        case 57: goto state_19;
-        case 58: goto state_19;
-        case 59: goto state_19;
-        case 60: goto state_19;
-        case 61: goto state_19;
-        case 62: goto state_19;
-        case 63: goto state_19;
-        case 64: goto state_19;
-        case 65: goto state_19;
-        case 66: goto state_19;
-        case 67: goto state_19;
-        case 68: goto state_19;
-        case 69: goto state_19;
-        case 70: goto state_19;
-        case 71: goto state_19;
-        case 72: goto state_19;
-        case 73: goto state_19;
-        case 74: goto state_19;
-        case 75: goto state_19;
-        case 76: goto state_19;
-        case 77: goto state_19;
-        case 78: goto state_19;
-        case 79: goto state_19;
-        case 80: goto state_19;
-        case 81: goto state_19;
-        case 82: goto state_19;
-        case 83: goto state_19;
-        case 84: goto state_19;
-        case 85: goto state_19;
-        case 86: goto state_19;
-        case 87: goto state_19;
-        case 88: goto state_19;
-        case 89: goto state_19;
-        case 90: goto state_19;
-        case 91: goto state_19;
-        case 92: goto state_21;
-        case 93: goto state_19;
-        case 94: goto state_19;
-        case 95: goto state_19;
-        case 96: goto state_19;
-        case 97: goto state_19;
-        case 98: goto state_19;
-        case 99: goto state_19;
-        case 100: goto state_19;
-        case 101: goto state_19;
-        case 102: goto state_19;
-        case 103: goto state_19;
-        case 104: goto state_19;
-        case 105: goto state_19;
-        case 106: goto state_19;
-        case 107: goto state_19;
-        case 108: goto state_19;
-        case 109: goto state_19;
-        case 110: goto state_19;
-        case 111: goto state_19;
-        case 112: goto state_19;
-        case 113: goto state_19;
-        case 114: goto state_19;
-        case 115: goto state_19;
-        case 116: goto state_19;
-        case 117: goto state_19;
-        case 118: goto state_19;
-        case 119: goto state_19;
-        case 120: goto state_19;
-        case 121: goto state_19;
-        case 122: goto state_19;
-        case 123: goto state_19;
-        case 124: goto state_19;
-        case 125: goto state_19;
-        case 126: goto state_19;
-        case 127: goto state_19;
+        case 115: goto state_22;
         default: goto undo_and_commit;
     }
-state_24:
+state_17:
+    nc += (int) scanner_skip_run(S, &parser_grammar_lexer_run_17);
     if(!(cc = scanner_advance(S))) { goto undo_and_commit; }
     ++nc;
     switch(cc) {
-        case 69: goto state_17;
-        case 70: goto state_17;
-        case 71: goto state_17;
-        case 72: goto state_17;
-        case 73: goto state_17;
-        case 74: goto state_17;
-        case 75: goto state_17;
-        case 76: goto state_17;
-        case 77: goto state_17;
-        case 78: goto state_17;
-        case 79: goto state_17;
-        case 80: goto state_17;
-        case 81: goto state_17;
-        case 82: goto state_17;
-        case 83: goto state_17;
-        case 84: goto state_17;
-        case 85: goto state_17;
-        case 86: goto state_17;
-        case 87: goto state_17;
-        case 88: goto state_17;
-        case 89: goto state_17;
-        case 90: goto state_17;
-        case 91: goto state_17;
-        case 92: goto state_24;
-        case 93: goto state_17;
-        case 94: goto state_17;
-        case 95: goto state_17;
+        case 127: goto state_17;
+        case 126: goto state_17;
+        case 125: goto state_17;
+        case 123: goto state_17;
         case 96: goto state_17;
-        case 97: goto state_17;
-        case 98: goto state_17;
-        case 99: goto state_17;
-        case 100: goto state_17;
-        case 101: goto state_17;
-        case 102: goto state_17;
-        case 103: goto state_17;
-        case 104: goto state_17;
-        case 105: goto state_17;
-        case 106: goto state_17;
-        case 107: goto state_17;
-        case 108: goto state_17;
-        case 109: goto state_17;
-        case 110: goto state_17;
-        case 111: goto state_17;
-        case 112: goto state_17;
-        case 113: goto state_17;
-        case 114: goto state_17;
-        case 115: goto state_17;
-        case 116: goto state_17;
-        case 117: goto state_17;
-        case 118: goto state_17;
-        case 119: goto state_17;
+        case 93: goto state_17;
+        case 91: goto state_17;
+        case 64: goto state_17;
+        case 61: goto state_17;
+        case 47: goto state_17;
+        case 46: goto state_17;
+        case 44: goto state_17;
+        case 38: goto state_17;
+        case 36: goto state_17;
+        case 35: goto state_17;
+        case 32: goto state_17;
+        case 31: goto state_17;
+        case 30: goto state_17;
+        case 29: goto state_17;
+        case 28: goto state_17;
+        case 27: goto state_17;
+        case 26: goto state_17;
+        case 25: goto state_17;
+        case 24: goto state_17;
+        case 23: goto state_17;
+        case 22: goto state_17;
+        case 21: goto state_17;
+        case 20: goto state_17;
+        case 19: goto state_17;
+        case 18: goto state_17;
+        case 17: goto state_17;
+        case 16: goto state_17;
+        case 15: goto state_17;
+        case 14: goto state_17;
+        case 13: goto state_17;
+        case 12: goto state_17;
+        case 11: goto state_17;
+        case 10: goto state_17;
+        case 9: goto state_17;
+        case 8: goto state_17;
+        case 7: goto state_17;
+        case 6: goto state_17;
+        case 5: goto state_17;
+        case 4: goto state_17;
+        case 3: goto state_17;
+        case 2: goto state_17;
+        case 1: goto state_17;
+        case 0: goto state_17;
+        case 124: goto state_17;
+        case 122: goto state_17;
         case 120: goto state_17;
+        case 119: goto state_17;
+        case 118: goto state_17;
+        case 117: goto state_17;
+        case 116: goto state_17;
+        case 114: goto state_17;
+        case 113: goto state_17;
+        case 112: goto state_17;
+        case 111: goto state_17;
+        case 109: goto state_17;
+        case 108: goto state_17;
+        case 107: goto state_17;
+        case 106: goto state_17;
+        case 105: goto state_17;
+        case 104: goto state_17;
+        case 103: goto state_17;
+        case 102: goto state_17;
+        case 101: goto state_17;
+        case 100: goto state_17;
+        case 98: goto state_17;
+        case 97: goto state_17;
         case 121: goto state_17;
-        case 122: goto state_17;
-        case 123: goto state_17;
-        case 124: goto state_17;
-        case 125: goto state_17;
-        case 126: goto state_17;
-        case 127: goto state_17;
-        case 0: goto state_17;
-        case 1: goto state_17;
-        case 2: goto state_17;
-        case 3: goto state_17;
-        case 4: goto state_17;
-        case 5: goto state_17;
-        case 6: goto state_17;
-        case 7: goto state_17;
-        case 8: goto state_17;
-        case 9: goto state_17;
-        case 10: goto state_17;
-        case 11: goto state_17;
-        case 12: goto state_17;
-        case 13: goto state_17;
-        case 14: goto state_17;
-        case 15: goto state_17;
-        case 16: goto state_17;
-        case 17: goto state_17;
-        case 18: goto state_17;
-        case 19: goto state_17;
-        case 20: goto state_17;
-        case 21: goto state_17;
-        case 22: goto state_17;
-        case 23: goto state_17;
-        case 24: goto state_17;
-        case 25: goto state_17;
-        case 26: goto state_17;
-        case 27: goto state_17;
-        case 28: goto state_17;
-        case 29: goto state_17;
-        case 30: goto state_17;
-        case 31: goto state_17;
-        case 32: goto state_17;
-        case 33: goto state_17;
-        case 34: goto state_17;
-        case 35: goto state_17;
-        case 36: goto state_17;
-        case 37: goto state_17;
-        case 38: goto state_17;
-        case 39: goto state_26;
-        case 40: goto state_17;
-        case 41: goto state_17;
-        case 42: goto state_17;
+        case 115: goto state_17;
+        case 110: goto state_17;
+        case 99: goto state_17;
+        case 95: goto state_17;
+        case 57: goto state_17;
+        case 56: goto state_17;
+        case 55: goto state_17;
+        case 54: goto state_17;
+        case 53: goto state_17;
+        case 52: goto state_17;
+        case 51: goto state_17;
+        case 50: goto state_17;
+        case 49: goto state_17;
+        case 48: goto state_17;
+        case 94: goto state_17;
+        case 92: goto state_19;
+        case 90: goto state_17;
+        case 89: goto state_17;
+        case 88: goto state_17;
+        case 87: goto state_17;
+        case 86: goto state_17;
+        case 85: goto state_17;
+        case 84: goto state_17;
+        case 83: goto state_17;
+        case 82: goto state_17;
+        case 81: goto state_17;
+        case 80: goto state_17;
+        case 79: goto state_17;
+        case 78: goto state_17;
+        case 77: goto state_17;
+        case 76: goto state_17;
+        case 75: goto state_17;
+        case 74: goto state_17;
+        case 73: goto state_17;
+        case 72: goto state_17;
+        case 71: goto state_17;
+        case 70: goto state_17;
+        case 69: goto state_17;
+        case 68: goto state_17;
+        case 67: goto state_17;
+        case 66: goto state_17;
+        case 65: goto state_17;
+        case 63: goto state_17;
+        case 62: goto state_17;
+        case 60: goto state_17;
+        case 59: goto state_17;
+        case 58: goto state_17;
+        case 45: goto state_17;
         case 43: goto state_17;
+        case 42: goto state_17;
+        case 41: goto state_17;
+        case 40: goto state_17;
+        case 39: goto state_17;
+        case 37: goto state_17;
+        case 34: goto state_20;
+        case 33: goto state_17;
+        default: goto undo_and_commit;
+    }
+state_18:
+    term = 14;
+    goto commit;
+state_19:
+    nc += (int) scanner_skip_run(S, &parser_grammar_lexer_run_19);
+    if(!(cc = scanner_advance(S))) { goto undo_and_commit; }
+    ++nc;
+    switch(cc) {
+        case 127: goto state_17;
+        case 126: goto state_17;
+        case 125: goto state_17;
+        case 123: goto state_17;
+        case 96: goto state_17;
+        case 93: goto state_17;
+        case 91: goto state_17;
+        case 64: goto state_17;
+        case 61: goto state_17;
+        case 47: goto state_17;
+        case 46: goto state_17;
         case 44: goto state_17;
+        case 38: goto state_17;
+        case 36: goto state_17;
+        case 35: goto state_17;
+        case 32: goto state_17;
+        case 31: goto state_17;
+        case 30: goto state_17;
+        case 29: goto state_17;
+        case 28: goto state_17;
+        case 27: goto state_17;
+        case 26: goto state_17;
+        case 25: goto state_17;
+        case 24: goto state_17;
+        case 23: goto state_17;
+        case 22: goto state_17;
+        case 21: goto state_17;
+        case 20: goto state_17;
+        case 19: goto state_17;
+        case 18: goto state_17;
+        case 17: goto state_17;
+        case 16: goto state_17;
+        case 15: goto state_17;
+        case 14: goto state_17;
+        case 13: goto state_17;
+        case 12: goto state_17;
+        case 11: goto state_17;
+        case 10: goto state_17;
+        case 9: goto state_17;
+        case 8: goto state_17;
+        case 7: goto state_17;
+        case 6: goto state_17;
+        case 5: goto state_17;
+        case 4: goto state_17;
+        case 3: goto state_17;
+        case 2: goto state_17;
+        case 1: goto state_17;
+        case 0: goto state_17;
+        case 124: goto state_17;
+        case 122: goto state_17;
+        case 120: goto state_17;
+        case 119: goto state_17;
+        case 118: goto state_17;
+        case 117: goto state_17;
+        case 116: goto state_17;
+        case 114: goto state_17;
+        case 113: goto state_17;
+        case 112: goto state_17;
+        case 111: goto state_17;
+        case 109: goto state_17;
+        case 108: goto state_17;
+        case 107: goto state_17;
+        case 106: goto state_17;
+        case 105: goto state_17;
+        case 104: goto state_17;
+        case 103: goto state_17;
+        case 102: goto state_17;
+        case 101: goto state_17;
+        case 100: goto state_17;
+        case 98: goto state_17;
+        case 97: goto state_17;
+        case 121: goto state_17;
+        case 115: goto state_17;
+        case 110: goto state_17;
+        case 99: goto state_17;
+        case 95: goto state_17;
+        case 57: goto state_17;
+        case 56: goto state_17;
+        case 55: goto state_17;
+        case 54: goto state_17;
+        case 53: goto state_17;
+        case 52: goto state_17;
+        case 51: goto state_17;
+        case 50: goto state_17;
+        case 49: goto state_17;
+        case 48: goto state_17;
+        case 94: goto state_17;
+        case 92: goto state_19;
+        case 90: goto state_17;
+        case 89: goto state_17;
+        case 88: goto state_17;
+        case 87: goto state_17;
+        case 86: goto state_17;
+        case 85: goto state_17;
+        case 84: goto state_17;
+        case 83: goto state_17;
+        case 82: goto state_17;
+        case 81: goto state_17;
+        case 80: goto state_17;
+        case 79: goto state_17;
+        case 78: goto state_17;
+        case 77: goto state_17;
+        case 76: goto state_17;
+        case 75: goto state_17;
+        case 74: goto state_17;
+        case 73: goto state_17;
+        case 72: goto state_17;
+        case 71: goto state_17;
+        case 70: goto state_17;
+        case 69: goto state_17;
+        case 68: goto state_17;
+        case 67: goto state_17;
+        case 66: goto state_17;
+        case 65: goto state_17;
+        case 63: goto state_17;
+        case 62: goto state_17;
+        case 60: goto state_17;
+        case 59: goto state_17;
+        case 58: goto state_17;
         case 45: goto state_17;
-        case 46: goto state_17;
+        case 43: goto state_17;
+        case 42: goto state_17;
+        case 41: goto state_17;
+        case 40: goto state_17;
+        case 39: goto state_17;
+        case 37: goto state_17;
+        case 34: goto state_21;
+        case 33: goto state_17;
+        default: goto undo_and_commit;
+    }
+state_20:
+    term = 16;
+    goto commit;
+state_21:
+    term = 16;
+    pnc = nc;
+    seen_accepting_state = 1;
+    if(!(cc = scanner_advance(S))) { goto undo_and_commit; }
+    ++nc;
+    switch(cc) {
+        case 127: goto state_17;
+        case 126: goto state_17;
+        case 125: goto state_17;
+        case 123: goto state_17;
+        case 96: goto state_17;
+        case 93: goto state_17;
+        case 91: goto state_17;
+        case 64: goto state_17;
+        case 61: goto state_17;
         case 47: goto state_17;
-        case 48: goto state_17;
-        case 49: goto state_17;
-        case 50: goto state_17;
-        case 51: goto state_17;
-        case 52: goto state_17;
-        case 53: goto state_17;
-        case 54: goto state_17;
-        case 55: goto state_17;
-        case 56: goto state_17;
+        case 46: goto state_17;
+        case 44: goto state_17;
+        case 38: goto state_17;
+        case 36: goto state_17;
+        case 35: goto state_17;
+        case 32: goto state_17;
+        case 31: goto state_17;
+        case 30: goto state_17;
+        case 29: goto state_17;
+        case 28: goto state_17;
+        case 27: goto state_17;
+        case 26: goto state_17;
+        case 25: goto state_17;
+        case 24: goto state_17;
+        case 23: goto state_17;
+        case 22: goto state_17;
+        case 21: goto state_17;
+        case 20: goto state_17;
+        case 19: goto state_17;
+        case 18: goto state_17;
+        case 17: goto state_17;
+        case 16: goto state_17;
+        case 15: goto state_17;
+        case 14: goto state_17;
+        case 13: goto state_17;
+        case 12: goto state_17;
+        case 11: goto state_17;
+        case 10: goto state_17;
+        case 9: goto state_17;
+        case 8: goto state_17;
+        case 7: goto state_17;
+        case 6: goto state_17;
+        case 5: goto state_17;
+        case 4: goto state_17;
+        case 3: goto state_17;
+        case 2: goto state_17;
+        case 1: goto state_17;
+        case 0: goto state_17;
+        case 124: goto state_17;
+        case 122: goto state_17;
+        case 120: goto state_17;
+        case 119: goto state_17;
+        case 118: goto state_17;
+        case 117: goto state_17;
+        case 116: goto state_17;
+        case 114: goto state_17;
+        case 113: goto state_17;
+        case 112: goto state_17;
+        case 111: goto state_17;
+        case 109: goto state_17;
+        case 108: goto state_17;
+        case 107: goto state_17;
+        case 106: goto state_17;
+        case 105: goto state_17;
+        case 104: goto state_17;
+        case 103: goto state_17;
+        case 102: goto state_17;
+        case 101: goto state_17;
+        case 100: goto state_17;
+        case 98: goto state_17;
+        case 97: goto state_17;
+        case 121: goto state_17;
+        case 115: goto state_17;
+        case 110: goto state_17;
+        case 99: goto state_17;
+        case 95: goto state_17;
         case 57: goto state_17;
-        case 58: goto state_17;
-        case 59: goto state_17;
-        case 60: goto state_17;
-        case 61: goto state_17;
-        case 62: goto state_17;
-        case 63: goto state_17;
-        case 64: goto state_17;
-        case 65: goto state_17;
-        case 66: goto state_17;
-        case 67: goto state_17;
+        case 56: goto state_17;
+        case 55: goto state_17;
+        case 54: goto state_17;
+        case 53: goto state_17;
+        case 52: goto state_17;
+        case 51: goto state_17;
+        case 50: goto state_17;
+        case 49: goto state_17;
+        case 48: goto state_17;
+        case 94: goto state_17;
+        case 92: goto state_19;
+        case 90: goto state_17;
+        case 89: goto state_17;
+        case 88: goto state_17;
+        case 87: goto state_17;
+        case 86: goto state_17;
+        case 85: goto state_17;
+        case 84: goto state_17;
+        case 83: goto state_17;
+        case 82: goto state_17;
+        case 81: goto state_17;
+        case 80: goto state_17;
+        case 79: goto state_17;
+        case 78: goto state_17;
+        case 77: goto state_17;
+        case 76: goto state_17;
+        case 75: goto state_17;
+        case 74: goto state_17;
+        case 73: goto state_17;
+        case 72: goto state_17;
+        case 71: goto state_17;
+        case 70: goto state_17;
+        case 69: goto state_17;
         case 68: goto state_17;
+        case 67: goto state_17;
+        case 66: goto state_17;
+        case 65: goto state_17;
+        case 63: goto state_17;
+        case 62: goto state_17;
+        case 60: goto state_17;
+        case 59: goto state_17;
+        case 58: goto state_17;
+        case 45: goto state_17;
+        case 43: goto state_17;
+        case 42: goto state_17;
+        case 41: goto state_17;
+        case 40: goto state_17;
+        case 39: goto state_17;
+        case 37: goto state_17;
+        case 34: goto state_20;
+        case 33: goto state_17;
         default: goto undo_and_commit;
     }
-state_25:
-    term = 6;
-    goto commit;
-state_26:
-    term = 6;
-    pnc = nc;
-    seen_accepting_state = 1;
+state_22:
     if(!(cc = scanner_advance(S))) { goto undo_and_commit; }
     ++nc;
     switch(cc) {
-        case 0: goto state_17;
-        case 1: goto state_17;
-        case 2: goto state_17;
-        case 3: goto state_17;
-        case 4: goto state_17;
-        case 5: goto state_17;
-        case 6: goto state_17;
-        case 7: goto state_17;
-        case 8: goto state_17;
-        case 9: goto state_17;
-        case 10: goto state_17;
-        case 11: goto state_17;
-        case 12: goto state_17;
-        case 13: goto state_17;
-        case 14: goto state_17;
-        case 15: goto state_17;
-        case 16: goto state_17;
-        case 17: goto state_17;
-        case 18: goto state_17;
-        case 19: goto state_17;
-        case 20: goto state_17;
-        case 21: goto state_17;
-        case 22: goto state_17;
-        case 23: goto state_17;
-        case 24: goto state_17;
-        case 25: goto state_17;
-        case 26: goto state_17;
-        case 27: goto state_17;
-        case 28: goto state_17;
-        case 29: goto state_17;
-        case 30: goto state_17;
-        case 31: goto state_17;
-        case 32: goto state_17;
-        case 33: goto state_17;
-        case 34: goto state_17;
-        case 35: goto state_17;
-        case 36: goto state_17;
-        case 37: goto state_17;
-        case 38: goto state_17;
-        case 39: goto state_25;
-        case 40: goto state_17;
-        case 41: goto state_17;
-        case 42: goto state_17;
-        case 43: goto state_17;
-        case 44: goto state_17;
-        case 45: goto state_17;
-        case 46: goto state_17;
-        case 47: goto state_17;
-        case 48: goto state_17;
-        case 49: goto state_17;
-        case 50: goto state_17;
-        case 51: goto state_17;
-        case 52: goto state_17;
-        case 53: goto state_17;
-        case 54: goto state_17;
-        case 55: goto state_17;
-        case 56: goto state_17;
-        case 57: goto state_17;
-        case 58: goto state_17;
-        case 59: goto state_17;
-        case 60: goto state_17;
-        case 61: goto state_17;
-        case 62: goto state_17;
-        case 63: goto state_17;
-        case 64: goto state_17;
-        case 65: goto state_17;
-        case 66: goto state_17;
-        case 67: goto state_17;
-        case 68: goto state_17;
-        case 69: goto state_17;
-        case 70: goto state_17;
-        case 71: goto state_17;
-        case 72: goto state_17;
-        case 73: goto state_17;
-        case 74: goto state_17;
-        case 75: goto state_17;
-        case 76: goto state_17;
-        case 77: goto state_17;
-        case 78: goto state_17;
-        case 79: goto state_17;
-        case 80: goto state_17;
-        case 81: goto state_17;
-        case 82: goto state_17;
-        case 83: goto state_17;
-        case 84: goto state_17;
-        case 85: goto state_17;
-        case 86: goto state_17;
-        case 87: goto state_17;
-        case 88: goto state_17;
-        case 89: goto state_17;
-        case 90: goto state_17;
-        case 91: goto state_17;
-        case 92: goto state_24;
-        case 93: goto state_17;
-        case 94: goto state_17;
-        case 95: goto state_17;
-        case 96: goto state_17;
-        case 97: goto state_17;
-        case 98: goto state_17;
-        case 99: goto state_17;
-        case 100: goto state_17;
-        case 101: goto state_17;
-        case 102: goto state_17;
-        case 103: goto state_17;
-        case 104: goto state_17;
-        case 105: goto state_17;
-        case 106: goto state_17;
-        case 107: goto state_17;
-        case 108: goto state_17;
-        case 109: goto state_17;
-        case 110: goto state_17;
-        case 111: goto state_17;
-        case 112: goto state_17;
-        case 113: goto state_17;
-        case 114: goto state_17;
-        case 115: goto state_17;
-        case 116: goto state_17;
-        case 117: goto state_17;
-        case 118: goto state_17;
-        case 119: goto state_17;
-        case 120: goto state_17;
-        case 121: goto state_17;
-        case 122: goto state_17;
-        case 123: goto state_17;
-        case 124: goto state_17;
-        case 125: goto state_17;
-        case 126: goto state_17;
-        case 127: goto state_17;
+        case 121: goto state_23;
         default: goto undo_and_commit;
     }
-state_27:
-    term = 2;
-    goto commit;
-state_28:
-    term = 19;
-    goto commit;
-state_29:
-    term = 8;
-    pnc = nc;
-    seen_accepting_state = 1;
+state_23:
     if(!(cc = scanner_advance(S))) { goto undo_and_commit; }
     ++nc;
     switch(cc) {
-        case 48: goto state_5;
-        case 49: goto state_5;
-        case 50: goto state_5;
-        case 51: goto state_5;
-        case 52: goto state_5;
-        case 53: goto state_5;
-        case 54: goto state_5;
-        case 55: goto state_5;
-        case 56: goto state_5;
-        case 57: goto state_5;
-        case 65: goto state_5;
-        case 66: goto state_5;
-        case 67: goto state_5;
-        case 68: goto state_5;
-        case 69: goto state_5;
-        case 70: goto state_5;
-        case 71: goto state_5;
-        case 72: goto state_5;
-        case 73: goto state_5;
-        case 74: goto state_5;
-        case 75: goto state_5;
-        case 76: goto state_5;
-        case 77: goto state_5;
-        case 78: goto state_5;
-        case 79: goto state_5;
-        case 80: goto state_5;
-        case 81: goto state_5;
-        case 82: goto state_5;
-        case 83: goto state_5;
-        case 84: goto state_5;
-        case 85: goto state_5;
-        case 86: goto state_5;
-        case 87: goto state_5;
-        case 88: goto state_5;
-        case 89: goto state_5;
-        case 90: goto state_5;
-        case 95: goto state_5;
-        case 97: goto state_5;
-        case 98: goto state_5;
-        case 99: goto state_5;
-        case 100: goto state_5;
-        case 101: goto state_5;
-        case 102: goto state_5;
-        case 103: goto state_5;
-        case 104: goto state_5;
-        case 105: goto state_5;
-        case 106: goto state_5;
-        case 107: goto state_5;
-        case 108: goto state_30;
-        case 109: goto state_5;
-        case 110: goto state_5;
-        case 111: goto state_5;
-        case 112: goto state_5;
-        case 113: goto state_5;
-        case 114: goto state_5;
-        case 115: goto state_5;
-        case 116: goto state_5;
-        case 117: goto state_5;
-        case 118: goto state_5;
-        case 119: goto state_5;
-        case 120: goto state_5;
-        case 121: goto state_5;
-        case 122: goto state_5;
+        case 110: goto state_24;
         default: goto undo_and_commit;
     }
-state_30:
-    term = 8;
-    pnc = nc;
-    seen_accepting_state = 1;
+state_24:
+    if(!(cc = scanner_advance(S))) { goto undo_and_commit; }
+    ++nc;
+    switch(cc) {
+        case 99: goto state_25;
+        default: goto undo_and_commit;
+    }
+state_25:
+    term = 5;
+    goto commit;
+state_26:
+    nc += (int) scanner_skip_run(S, &parser_grammar_lexer_run_26);
     if(!(cc = scanner_advance(S))) { goto undo_and_commit; }
     ++nc;
     switch(cc) {
-        case 52: goto state_5;
-        case 53: goto state_5;
-        case 54: goto state_5;
-        case 55: goto state_5;
-        case 56: goto state_5;
-        case 57: goto state_5;
-        case 65: goto state_5;
-        case 66: goto state_5;
-        case 67: goto state_5;
-        case 68: goto state_5;
-        case 69: goto state_5;
-        case 70: goto state_5;
-        case 71: goto state_5;
-        case 72: goto state_5;
-        case 73: goto state_5;
-        case 74: goto state_5;
-        case 75: goto state_5;
-        case 76: goto state_5;
-        case 77: goto state_5;
-        case 78: goto state_5;
-        case 79: goto state_5;
-        case 80: goto state_5;
-        case 81: goto state_5;
-        case 82: goto state_5;
-        case 83: goto state_5;
-        case 84: goto state_5;
-        case 85: goto state_5;
-        case 86: goto state_5;
-        case 87: goto state_5;
-        case 88: goto state_5;
-        case 89: goto state_5;
-        case 90: goto state_5;
-        case 95: goto state_5;
-        case 97: goto state_5;
-        case 98: goto state_5;
-        case 99: goto state_5;
-        case 100: goto state_5;
-        case 101: goto state_5;
-        case 102: goto state_31;
-        case 103: goto state_5;
-        case 104: goto state_5;
-        case 105: goto state_5;
-        case 106: goto state_5;
-        case 107: goto state_5;
-        case 108: goto state_5;
-        case 109: goto state_5;
-        case 110: goto state_5;
-        case 111: goto state_5;
-        case 112: goto state_5;
-        case 113: goto state_5;
-        case 114: goto state_5;
-        case 115: goto state_5;
-        case 116: goto state_5;
-        case 117: goto state_5;
-        case 118: goto state_5;
-        case 119: goto state_5;
-        case 120: goto state_5;
-        case 121: goto state_5;
-        case 122: goto state_5;
-        case 48: goto state_5;
-        case 49: goto state_5;
-        case 50: goto state_5;
-        case 51: goto state_5;
+        case 127: goto state_15;
+        case 126: goto state_15;
+        case 125: goto state_15;
+        case 123: goto state_15;
+        case 96: goto state_15;
+        case 93: goto state_15;
+        case 91: goto state_15;
+        case 64: goto state_15;
+        case 61: goto state_15;
+        case 47: goto state_15;
+        case 46: goto state_15;
+        case 44: goto state_15;
+        case 38: goto state_15;
+        case 36: goto state_15;
+        case 35: goto state_15;
+        case 32: goto state_15;
+        case 31: goto state_15;
+        case 30: goto state_15;
+        case 29: goto state_15;
+        case 28: goto state_15;
+        case 27: goto state_15;
+        case 26: goto state_15;
+        case 25: goto state_15;
+        case 24: goto state_15;
+        case 23: goto state_15;
+        case 22: goto state_15;
+        case 21: goto state_15;
+        case 20: goto state_15;
+        case 19: goto state_15;
+        case 18: goto state_15;
+        case 17: goto state_15;
+        case 16: goto state_15;
+        case 15: goto state_15;
+        case 14: goto state_15;
+        case 13: goto state_15;
+        case 12: goto state_15;
+        case 11: goto state_15;
+        case 10: goto state_15;
+        case 9: goto state_15;
+        case 8: goto state_15;
+        case 7: goto state_15;
+        case 6: goto state_15;
+        case 5: goto state_15;
+        case 4: goto state_15;
+        case 3: goto state_15;
+        case 2: goto state_15;
+        case 1: goto state_15;
+        case 0: goto state_15;
+        case 124: goto state_15;
+        case 122: goto state_15;
+        case 120: goto state_15;
+        case 119: goto state_15;
+        case 118: goto state_15;
+        case 117: goto state_15;
+        case 116: goto state_15;
+        case 114: goto state_15;
+        case 113: goto state_15;
+        case 112: goto state_15;
+        case 111: goto state_15;
+        case 109: goto state_15;
+        case 108: goto state_15;
+        case 107: goto state_15;
+        case 106: goto state_15;
+        case 105: goto state_15;
+        case 104: goto state_15;
+        case 103: goto state_15;
+        case 102: goto state_15;
+        case 101: goto state_15;
+        case 100: goto state_15;
+        case 98: goto state_15;
+        case 97: goto state_15;
+        case 121: goto state_15;
+        case 115: goto state_15;
+        case 110: goto state_15;
+        case 99: goto state_15;
+        case 95: goto state_15;
+        case 57: goto state_15;
+        case 56: goto state_15;
+        case 55: goto state_15;
+        case 54: goto state_15;
+        case 53: goto state_15;
+        case 52: goto state_15;
+        case 51: goto state_15;
+        case 50: goto state_15;
+        case 49: goto state_15;
+        case 48: goto state_15;
+        case 94: goto state_15;
+        case 92: goto state_26;
+        case 90: goto state_15;
+        case 89: goto state_15;
+        case 88: goto state_15;
+        case 87: goto state_15;
+        case 86: goto state_15;
+        case 85: goto state_15;
+        case 84: goto state_15;
+        case 83: goto state_15;
+        case 82: goto state_15;
+        case 81: goto state_15;
+        case 80: goto state_15;
+        case 79: goto state_15;
+        case 78: goto state_15;
+        case 77: goto state_15;
+        case 76: goto state_15;
+        case 75: goto state_15;
+        case 74: goto state_15;
+        case 73: goto state_15;
+        case 72: goto state_15;
+        case 71: goto state_15;
+        case 70: goto state_15;
+        case 69: goto state_15;
+        case 68: goto state_15;
+        case 67: goto state_15;
+        case 66: goto state_15;
+        case 65: goto state_15;
+        case 63: goto state_15;
+        case 62: goto state_15;
+        case 60: goto state_15;
+        case 59: goto state_15;
+        case 58: goto state_15;
+        case 45: goto state_15;
+        case 43: goto state_15;
+        case 42: goto state_15;
+        case 41: goto state_15;
+        case 40: goto state_15;
+        case 39: goto state_28;
+        case 37: goto state_15;
+        case 34: goto state_15;
+        case 33: goto state_15;
         default: goto undo_and_commit;
     }
-state_31:
-    term = 13;
+state_27:
+    term = 8;
+    goto commit;
+state_28:
+    term = 8;
     pnc = nc;
     seen_accepting_state = 1;
     if(!(cc = scanner_advance(S))) { goto undo_and_commit; }
     ++nc;
     switch(cc) {
-        case 48: goto state_5;
-        case 49: goto state_5;
-        case 50: goto state_5;
-        case 51: goto state_5;
-        case 52: goto state_5;
-        case 53: goto state_5;
-        case 54: goto state_5;
-        case 55: goto state_5;
-        case 56: goto state_5;
-        case 57: goto state_5;
-        case 65: goto state_5;
-        case 66: goto state_5;
-        case 67: goto state_5;
-        case 68: goto state_5;
-        case 69: goto state_5;
-        case 70: goto state_5;
-        case 71: goto state_5;
-        case 72: goto state_5;
-        case 73: goto state_5;
-        case 74: goto state_5;
-        case 75: goto state_5;
-        case 76: goto state_5;
-        case 77: goto state_5;
-        case 78: goto state_5;
-        case 79: goto state_5;
-        case 80: goto state_5;
-        case 81: goto state_5;
-        case 82: goto state_5;
-        case 83: goto state_5;
-        case 84: goto state_5;
-        case 85: goto state_5;
-        case 86: goto state_5;
-        case 87: goto state_5;
-        case 88: goto state_5;
-        case 89: goto state_5;
-        case 90: goto state_5;
-        case 95: goto state_5;
-        case 97: goto state_5;
-        case 98: goto state_5;
-        case 99: goto state_5;
-        case 100: goto state_5;
-        case 101: goto state_5;
-        case 102: goto state_5;
-        case 103: goto state_5;
-        case 104: goto state_5;
-        case 105: goto state_5;
-        case 106: goto state_5;
-        case 107: goto state_5;
-        case 108: goto state_5;
-        case 109: goto state_5;
-        case 110: goto state_5;
-        case 111: goto state_5;
-        case 112: goto state_5;
-        case 113: goto state_5;
-        case 114: goto state_5;
-        case 115: goto state_5;
-        case 116: goto state_5;
-        case 117: goto state_5;
-        case 118: goto state_5;
-        case 119: goto state_5;
-        case 120: goto state_5;
-        case 121: goto state_5;
-        case 122: goto state_5;
+        case 127: goto state_15;
+        case 126: goto state_15;
+        case 125: goto state_15;
+        case 123: goto state_15;
+        case 96: goto state_15;
+        case 93: goto state_15;
+        case 91: goto state_15;
+        case 64: goto state_15;
+        case 61: goto state_15;
+        case 47: goto state_15;
+        case 46: goto state_15;
+        case 44: goto state_15;
+        case 38: goto state_15;
+        case 36: goto state_15;
+        case 35: goto state_15;
+        case 32: goto state_15;
+        case 31: goto state_15;
+        case 30: goto state_15;
+        case 29: goto state_15;
+        case 28: goto state_15;
+        case 27: goto state_15;
+        case 26: goto state_15;
+        case 25: goto state_15;
+        case 24: goto state_15;
+        case 23: goto state_15;
+        case 22: goto state_15;
+        case 21: goto state_15;
+        case 20: goto state_15;
+        case 19: goto state_15;
+        case 18: goto state_15;
+        case 17: goto state_15;
+        case 16: goto state_15;
+        case 15: goto state_15;
+        case 14: goto state_15;
+        case 13: goto state_15;
+        case 12: goto state_15;
+        case 11: goto state_15;
+        case 10: goto state_15;
+        case 9: goto state_15;
+        case 8: goto state_15;
+        case 7: goto state_15;
+        case 6: goto state_15;
+        case 5: goto state_15;
+        case 4: goto state_15;
+        case 3: goto state_15;
+        case 2: goto state_15;
+        case 1: goto state_15;
+        case 0: goto state_15;
+        case 124: goto state_15;
+        case 122: goto state_15;
+        case 120: goto state_15;
+        case 119: goto state_15;
+        case 118: goto state_15;
+        case 117: goto state_15;
+        case 116: goto state_15;
+        case 114: goto state_15;
+        case 113: goto state_15;
+        case 112: goto state_15;
+        case 111: goto state_15;
+        case 109: goto state_15;
+        case 108: goto state_15;
+        case 107: goto state_15;
+        case 106: goto state_15;
+        case 105: goto state_15;
+        case 104: goto state_15;
+        case 103: goto state_15;
+        case 102: goto state_15;
+        case 101: goto state_15;
+        case 100: goto state_15;
+        case 98: goto state_15;
+        case 97: goto state_15;
+        case 121: goto state_15;
+        case 115: goto state_15;
+        case 110: goto state_15;
+        case 99: goto state_15;
+        case 95: goto state_15;
+        case 57: goto state_15;
+        case 56: goto state_15;
+        case 55: goto state_15;
+        case 54: goto state_15;
+        case 53: goto state_15;
+        case 52: goto state_15;
+        case 51: goto state_15;
+        case 50: goto state_15;
+        case 49: goto state_15;
+        case 48: goto state_15;
+        case 94: goto state_15;
+        case 92: goto state_26;
+        case 90: goto state_15;
+        case 89: goto state_15;
+        case 88: goto state_15;
+        case 87: goto state_15;
+        case 86: goto state_15;
+        case 85: goto state_15;
+        case 84: goto state_15;
+        case 83: goto state_15;
+        case 82: goto state_15;
+        case 81: goto state_15;
+        case 80: goto state_15;
+        case 79: goto state_15;
+        case 78: goto state_15;
+        case 77: goto state_15;
+        case 76: goto state_15;
+        case 75: goto state_15;
+        case 74: goto state_15;
+        case 73: goto state_15;
+        case 72: goto state_15;
+        case 71: goto state_15;
+        case 70: goto state_15;
+        case 69: goto state_15;
+        case 68: goto state_15;
+        case 67: goto state_15;
+        case 66: goto state_15;
+        case 65: goto state_15;
+        case 63: goto state_15;
+        case 62: goto state_15;
+        case 60: goto state_15;
+        case 59: goto state_15;
+        case 58: goto state_15;
+        case 45: goto state_15;
+        case 43: goto state_15;
+        case 42: goto state_15;
+        case 41: goto state_15;
+        case 40: goto state_15;
+        case 39: goto state_27;
+        case 37: goto state_15;
+        case 34: goto state_15;
+        case 33: goto state_15;
         default: goto undo_and_commit;
     }
+state_29:
+    term = 3;
+    goto commit;
+state_30:
+    term = 18;
+    goto commit;
 undo_and_commit:
     if(!seen_accepting_state) {
         return -1;
@@ -1402,5 +1195,8 @@ undo_and_commit:
     scanner_pushback(S, nc - pnc);
 commit:
     scanner_mark_lexeme_end(S);
+    if(9 == term) {
+        term = scanner_keyword(S, &parser_grammar_lexer_keywords_9, term);
+    }
     return term;
 }
@@ -0,0 +1,171 @@
+/*
+ * arena.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: petergoodman
+ *     Version: $Id$
+ */
+
+#include <std-arena.h>
+
+/* a chunk of memory owned by an arena. the memory for objects immediately
+ * follows the block header. */
+typedef struct PArenaBlock {
+    struct PArenaBlock *next;
+    union {
+        size_t size;
+        double _align;
+    } u;
+} PArenaBlock;
+
+/* a released object, threaded onto its size class's free list */
+typedef struct A_FreeObject {
+    struct A_FreeObject *next;
+} A_FreeObject;
+
+/* round a size up to the arena's alignment */
+#define A_ALIGN(size) (((size) + (A_ALIGNMENT - 1)) & ~((size_t) A_ALIGNMENT - 1))
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Allocate a new block of memory and add it to the arena.
+ */
+static unsigned char *A_block_alloc(PArena *arena, size_t size) {
+    PArenaBlock *block = mem_alloc(sizeof(PArenaBlock) + size);
+    if(is_null(block)) {
+        mem_error("Unable to allocate arena block.");
+    }
+
+    block->next = arena->blocks;
+    block->u.size = size;
+    arena->blocks = block;
+
+    return (unsigned char *) (block + 1);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Allocate a new, empty arena.
+ */
+PArena *arena_alloc(void) {
+    PArena *arena = mem_calloc(1, sizeof(PArena));
+    if(is_null(arena)) {
+        mem_error("Unable to allocate arena.");
+    }
+
+    arena->blocks = NULL;
+    arena->next = NULL;
+    arena->end = NULL;
+
+    return arena;
+}
+
+/**
+ * Free an arena and every object allocated from it.
+ */
+void arena_free(PArena *arena) {
+    PArenaBlock *block,
+                *next;
+
+    assert_not_null(arena);
+
+    for(block = arena->blocks; is_not_null(block); block = next) {
+        next = block->next;
+        mem_free(block);
+    }
+
+    mem_free(arena);
+}
+
+/**
+ * Forget every object allocated from the arena so that its memory can be used
+ * again. One block is kept so that small workloads can reset and re-fill the
+ * arena without going back to the system allocator.
+ */
+void arena_reset(PArena *arena) {
+    PArenaBlock *block,
+                *next,
+                *kept = NULL;
+
+    assert_not_null(arena);
+
+    for(block = arena->blocks; is_not_null(block); block = next) {
+        next = block->next;
+        if(is_null(kept) && A_BLOCK_SIZE == block->u.size) {
+            kept = block;
+        } else {
+            mem_free(block);
+        }
+    }
+
+    memset(arena->free_lists, 0, sizeof(arena->free_lists));
+
+    arena->blocks = kept;
+    arena->next = NULL;
+    arena->end = NULL;
+
+    if(is_not_null(kept)) {
+        kept->next = NULL;
+        arena->next = (unsigned char *) (kept + 1);
+        arena->end = arena->next + A_BLOCK_SIZE;
+    }
+}
+
+/**
+ * Allocate an object from the arena. Released objects of the same size class
+ * are re-used first.
+ */
+void *arena_malloc(PArena *arena, size_t size) {
+    A_FreeObject *object;
+    unsigned char *pointer;
+
+    assert_not_null(arena);
+
+    size = A_ALIGN(size > 0 ? size : 1);
+
+    if(size <= A_MAX_CLASS_SIZE) {
+        object = arena->free_lists[(size / A_ALIGNMENT) - 1];
+        if(is_not_null(object)) {
+            arena->free_lists[(size / A_ALIGNMENT) - 1] = object->next;
+            return object;
+        }
+    }
+
+    /* large objects get a block of their own so that the current block isn't
+     * wasted. */
+    if(size > (A_BLOCK_SIZE / 4)) {
+        return A_block_alloc(arena, size);
+    }
+
+    if(is_null(arena->next) || (size_t) (arena->end - arena->next) < size) {
+        arena->next = A_block_alloc(arena, A_BLOCK_SIZE);
+        arena->end = arena->next + A_BLOCK_SIZE;
+    }
+
+    pointer = arena->next;
+    arena->next += size;
+
+    return pointer;
+}
+
+/**
+ * Release an object allocated from the arena so that its memory can be re-used
+ * by a later allocation of the same size class. Large objects are only freed
+ * along with the arena.
+ */
+void arena_release(PArena *arena, void *pointer, size_t size) {
+    A_FreeObject *object = pointer;
+
+    assert_not_null(arena);
+
+    size = A_ALIGN(size > 0 ? size : 1);
+
+    if(is_null(pointer) || size > A_MAX_CLASS_SIZE) {
+        return;
+    }
+
+    object->next = arena->free_lists[(size / A_ALIGNMENT) - 1];
+    arena->free_lists[(size / A_ALIGNMENT) - 1] = object;
+}
@@ -23,7 +23,7 @@ unsigned long int mem_num_allocated_pointers(void) {
 void *_mem_calloc(size_t s, size_t e, const unsigned int line, const char *file ) {
     void *x = calloc(s, e);
 
-    ++num_allocated_pointers;
+    mem_count_alloc(num_allocated_pointers);
     /*
     printf("Allocated memory address 0x%X, %d:%s, loose pointers remaining: %d.\n", (int)x, line, file, num_allocated_pointers);
     fflush(stdout);
@@ -35,7 +35,7 @@ void *_mem_calloc(size_t s, size_t e, const unsigned int line, const char *file
 void *_mem_alloc(size_t s, const unsigned int line, const char *file ) {
     void *x = malloc(s);
 
-    ++num_allocated_pointers;
+    mem_count_alloc(num_allocated_pointers);
     /*
     printf("Allocated memory address 0x%X, %d:%s, loose pointers remaining: %d.\n", (int)x, line, file, num_allocated_pointers);
     fflush(stdout);
@@ -45,7 +45,7 @@ void *_mem_alloc(size_t s, const unsigned int line, const char *file ) {
 }
 
 void _mem_free(void *x, const unsigned int line, const char *file ) {
-    --num_allocated_pointers;
+    mem_count_free(num_allocated_pointers);
 
     assert_not_null(x);
 
@@ -60,7 +60,7 @@ void _mem_free(void *x, const unsigned int line, const char *file ) {
 
 void _D1_mem_free(void *x ) {
 
-    --num_allocated_pointers;
+    mem_count_free(num_allocated_pointers);
 
     /*
     printf("Freeing memory address 0x%X, loose pointers remaining: %d.\n", (unsigned int)x, num_allocated_pointers);
@@ -10,9 +10,9 @@
 
 static unsigned long int num_allocations = 0;
 
-#define string_mem_alloc(x) mem_alloc(x); ++num_allocations
-#define string_mem_calloc(x,y) mem_calloc(x,y); ++num_allocations
-#define string_mem_free(x) mem_free(x); --num_allocations
+#define string_mem_alloc(x) mem_alloc(x); mem_count_alloc(num_allocations)
+#define string_mem_calloc(x,y) mem_calloc(x,y); mem_count_alloc(num_allocations)
+#define string_mem_free(x) mem_free(x); mem_count_free(num_allocations)
 #define string_mem_error(x) mem_error(x)
 
 unsigned long int string_num_allocated_pointers(void) {
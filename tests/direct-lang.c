@@ -0,0 +1,144 @@
+/*
+ * direct-lang.c
+ *
+ * Parse a lang.g program with the grammar interpreter and with the direct-coded
+ * parser that pgen generates for lang.g, and make sure that the grammar actions
+ * see the same parse tree both times. The program nests an expression deeper
+ * than the direct-coded parser's stack starts out with room for.
+ */
+
+#include "lang-direct-grammar.h"
+#include "lang-direct-lexer.h"
+#include "tree-text.h"
+
+#define NUM_COPIES 50
+#define NESTING_DEPTH 2000
+
+static const char *program = (
+    "type Foo : Bar Baz, Qux.\n"
+    "type A : B.\n"
+    "def main(Int x, y; Str z) -> Int :\n"
+    "    with a { bind Foo(b _ Bar(c)) { print (x), pass. } bind Q(r) { pass. } },\n"
+    "    bind Baz(q) { pass. },\n"
+    "    (f), return (g), pass.\n"
+    "def other(B b) -> Bool : pass.\n"
+    "def atoms(Int n) -> Int : print n, 1, true, (g n 2.5 false), return n, pass.\n"
+);
+
+static const char *nested = "def deep(Int n) -> Int : print ";
+
+/**
+ * Parse the text with either the grammar interpreter or the direct-coded
+ * parser. Returns 1 if the text was parsed.
+ */
+static int parse(PParser *parser,
+                  PGrammar *grammar,
+                  unsigned char *text,
+                  int is_direct,
+                  TreeText *out) {
+    PScanner *scanner = scanner_alloc();
+    int is_parsed;
+
+    scanner_use_string(scanner, text);
+
+    if(is_direct) {
+        is_parsed = parser_parse_tokens_direct(
+            parser,
+            grammar,
+            &lang_grammar_direct,
+            scanner,
+            (PScannerFunc *) &lang_lexer,
+            out
+        );
+    } else {
+        is_parsed = parser_parse_tokens(
+            parser,
+            grammar,
+            scanner,
+            (PScannerFunc *) &lang_lexer,
+            out
+        );
+    }
+
+    scanner_free(scanner);
+    return is_parsed;
+}
+
+int main(void) {
+    PGrammar *grammar = lang_grammar();
+    PParser *parser = parser_alloc();
+    TreeText interpreted = {NULL, 0, 0},
+             direct = {NULL, 0, 0},
+             direct_again = {NULL, 0, 0},
+             broken = {NULL, 0, 0};
+    size_t length = strlen(program),
+           nested_length = strlen(nested),
+           size = (NUM_COPIES * length) + nested_length + (4 * NESTING_DEPTH) + 16;
+    unsigned char *text = mem_alloc(size),
+                  *c = text;
+    unsigned int i;
+    int failed = 0,
+        is_parsed;
+
+    print_trees(grammar);
+
+    for(i = 0; i < NUM_COPIES; ++i, c += length) {
+        memcpy(c, program, length);
+    }
+
+    memcpy(c, nested, nested_length);
+    c += nested_length;
+    for(i = 0; i < NESTING_DEPTH; ++i, c += 3) {
+        memcpy(c, "(f ", 3);
+    }
+    *c++ = 'x';
+    for(i = 0; i < NESTING_DEPTH; ++i) {
+        *c++ = ')';
+    }
+    memcpy(c, ", pass.\n", 9);
+
+    is_parsed = parse(parser, grammar, text, 0, &interpreted);
+    parser_free(parser);
+
+    /* the second direct-coded parse starts out with the stack that the first
+     * one grew */
+    parser = parser_alloc();
+    is_parsed = parse(parser, grammar, text, 1, &direct) && is_parsed;
+    is_parsed = parse(parser, grammar, text, 1, &direct_again) && is_parsed;
+
+    if(!is_parsed) {
+        printf("direct-lang: the program failed to parse.\n");
+        failed = 1;
+    } else if(!is_same_text(&interpreted, &direct)) {
+        printf("direct-lang: direct-coded parse tree differs from interpreted one.\n");
+        failed = 1;
+    } else if(!is_same_text(&interpreted, &direct_again)) {
+        printf("direct-lang: second direct-coded parse tree differs.\n");
+        failed = 1;
+    }
+
+    /* unbalance the nested expression */
+    *c = '.';
+    if(parse(parser, grammar, text, 1, &broken) || 0 != broken.length) {
+        printf("direct-lang: the broken program was parsed.\n");
+        failed = 1;
+    }
+
+    parser_free(parser);
+    grammar_free(grammar);
+    mem_free(text);
+    if(is_not_null(interpreted.text)) {
+        mem_free(interpreted.text);
+    }
+    if(is_not_null(direct.text)) {
+        mem_free(direct.text);
+    }
+    if(is_not_null(direct_again.text)) {
+        mem_free(direct_again.text);
+    }
+    if(is_not_null(broken.text)) {
+        mem_free(broken.text);
+    }
+
+    return failed;
+}
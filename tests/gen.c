@@ -0,0 +1,44 @@
+/*
+ * gen.c
+ *
+ * Generate a grammar and scanner from a grammar file, for the tests to use.
+ * Any arguments after the language name choose the kind of parser and scanner
+ * that are generated: "direct" for a direct-coded parser, "tables" for a
+ * table-driven scanner, and "cursor" for a scanner that reads through a
+ * cursor.
+ */
+
+#include <pgen-gen.h>
+
+int main(int argc, char *argv[]) {
+    unsigned int options = 0;
+    int i;
+
+    if(7 > argc) {
+        printf(
+            "usage: %s <grammar file> <grammar function> <grammar output file> "
+            "<lexer function> <lexer output file> <language name> "
+            "[direct] [tables] [cursor]\n",
+            argv[0]
+        );
+        return 1;
+    }
+
+    for(i = 7; i < argc; ++i) {
+        if(0 == strcmp("direct", argv[i])) {
+            options |= PGEN_DIRECT_PARSER;
+        } else if(0 == strcmp("tables", argv[i])) {
+            options |= PGEN_TABLE_LEXER;
+        } else if(0 == strcmp("cursor", argv[i])) {
+            options |= PGEN_CURSOR_LEXER;
+        } else {
+            printf("%s: unknown option '%s'.\n", argv[0], argv[i]);
+            return 1;
+        }
+    }
+
+    parser_gen_options(
+        argv[1], argv[2], argv[3], argv[4], argv[5], argv[6], options
+    );
+    return 0;
+}
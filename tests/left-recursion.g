@@ -0,0 +1,6 @@
+number : '[0-9]+' ;
+
+Sum
+    : -Sum "+" -number
+    | -number
+    ;
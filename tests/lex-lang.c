@@ -0,0 +1,163 @@
+/*
+ * lex-lang.c
+ *
+ * Scan a lang.g program with each kind of scanner that pgen generates for
+ * lang.g: the switch-coded one, the table-driven one, and those that read
+ * through a cursor. Every scanner must find the same terminals, lexemes and
+ * positions, whether it scans the program in place from memory or reads it
+ * through its buffer from a file.
+ */
+
+#include "lang-lexer.h"
+#include "lang-tables-lexer.h"
+#include "lang-cursor-lexer.h"
+#include "lang-tables-cursor-lexer.h"
+#include "tree-text.h"
+
+#define NUM_COPIES 500
+#define LONG_ID_LENGTH 200
+
+static const char *program = (
+    "type Foo : Bar Baz, Qux.\n"
+    "type A : B.\n"
+    "def main(Int x, y; Str z) -> Int :\n"
+    "    with a { bind Foo(b _ Bar(c)) { print (x), pass. } bind Q(r) { pass. } },\n"
+    "    bind Baz(q) { pass. },\n"
+    "    (f), return (g), pass.\n"
+    "def other(B b) -> Bool : pass.\n"
+    "def nums(Int n) -> Num : print (add 1 2.5 30.125 true false), return n.\n"
+    "\t\tdef  spaced ( Int\tn )\n\n->Int:pass .\n"
+);
+
+static const char *file_name = "build/lex-lang.ln";
+
+/**
+ * Write out the terminal, lexeme, line and column of every token that a
+ * scanner finds in the scanner's input.
+ */
+static void print_tokens(PScanner *scanner,
+                         PScannerFunc *scanner_fnc,
+                         TreeText *out) {
+    char buffer[LONG_ID_LENGTH + 64];
+    const unsigned char *lexeme;
+    G_Terminal term;
+    uint32_t line,
+             column;
+    int length;
+
+    while((term = scanner_fnc(scanner)) >= 0) {
+        lexeme = scanner_get_lexeme_text(scanner);
+        if(is_null(lexeme)) {
+            lexeme = scanner->lexeme.start;
+        }
+
+        length = (int) (scanner->lexeme.end - scanner->lexeme.start);
+        scanner_get_position(
+            scanner,
+            scanner_get_lexeme_offset(scanner),
+            &line,
+            &column
+        );
+
+        sprintf(
+            buffer,
+            " %d'%.*s'@%u:%u",
+            (int) term,
+            length,
+            (const char *) lexeme,
+            line,
+            column
+        );
+        append(out, buffer);
+    }
+}
+
+/**
+ * Scan the text, and the file with the same contents, with a scanner and check
+ * that it finds the same tokens as the switch-coded scanner did.
+ */
+static int is_same_tokens(unsigned char *text,
+                          PScannerFunc *scanner_fnc,
+                          TreeText *expected,
+                          const char *kind) {
+    PScanner *scanner = scanner_alloc();
+    TreeText from_text = {NULL, 0, 0},
+             from_file = {NULL, 0, 0};
+    int is_same = 1;
+
+    scanner_use_string(scanner, text);
+    print_tokens(scanner, scanner_fnc, &from_text);
+
+    if(!scanner_use_file(scanner, file_name)) {
+        printf("lex-lang: unable to open %s.\n", file_name);
+        is_same = 0;
+    } else {
+        print_tokens(scanner, scanner_fnc, &from_file);
+    }
+
+    if(is_same && !is_same_text(expected, &from_text)) {
+        printf("lex-lang: %s scanner's tokens differ on text.\n", kind);
+        is_same = 0;
+    } else if(is_same && !is_same_text(expected, &from_file)) {
+        printf("lex-lang: %s scanner's tokens differ on a file.\n", kind);
+        is_same = 0;
+    }
+
+    scanner_free(scanner);
+    if(is_not_null(from_text.text)) {
+        mem_free(from_text.text);
+    }
+    if(is_not_null(from_file.text)) {
+        mem_free(from_file.text);
+    }
+
+    return is_same;
+}
+
+int main(void) {
+    PScanner *scanner = scanner_alloc();
+    TreeText expected = {NULL, 0, 0};
+    size_t length = strlen(program),
+           size = (NUM_COPIES * (length + LONG_ID_LENGTH + 2)) + 1;
+    unsigned char *text = mem_alloc(size),
+                  *c = text;
+    unsigned int i;
+    FILE *file;
+    int failed = 0;
+
+    /* a long identifier in each copy moves the tokens around the scanner's
+     * buffer when the program is read from a file */
+    for(i = 0; i < NUM_COPIES; ++i) {
+        memcpy(c, program, length);
+        c += length;
+        memset(c, 'a', LONG_ID_LENGTH);
+        c += LONG_ID_LENGTH;
+        *c++ = ' ';
+        *c++ = '\n';
+    }
+    *c = '\0';
+
+    file = fopen(file_name, "wb");
+    if(is_null(file)) {
+        printf("lex-lang: unable to write %s.\n", file_name);
+        return 1;
+    }
+    fwrite(text, 1, (size_t) (c - text), file);
+    fclose(file);
+
+    scanner_use_string(scanner, text);
+    print_tokens(scanner, (PScannerFunc *) &lang_lexer, &expected);
+    scanner_free(scanner);
+
+    if(!is_same_tokens(text, (PScannerFunc *) &lang_lexer, &expected, "switch")
+    || !is_same_tokens(text, (PScannerFunc *) &lang_tables_lexer, &expected, "table")
+    || !is_same_tokens(text, (PScannerFunc *) &lang_cursor_lexer, &expected, "cursor")
+    || !is_same_tokens(text, (PScannerFunc *) &lang_tables_cursor_lexer, &expected, "table cursor")) {
+        failed = 1;
+    }
+
+    mem_free(text);
+    mem_free(expected.text);
+
+    return failed;
+}
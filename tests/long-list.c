@@ -0,0 +1,87 @@
+/*
+ * long-list.c
+ *
+ * Parse a list that has more branches than fit in 16 bits and make sure that
+ * every one of them makes it into the parse tree.
+ */
+
+#include <p-grammar.h>
+#include <p-parser.h>
+#include <p-scanner.h>
+
+#define NUM_ITEMS 70000
+
+enum {
+    L_item=0
+};
+
+enum {
+    P_List=0
+};
+
+static unsigned int num_items = 0;
+
+/**
+ * Scan a single 'x' at a time.
+ */
+static G_Terminal item_lexer(PScanner *S) {
+    int cc;
+    scanner_skip_space(S);
+    scanner_mark_lexeme_start(S);
+    if(!(cc = scanner_advance(S)) || 'x' != cc) {
+        return -1;
+    }
+    scanner_mark_lexeme_end(S);
+    return L_item;
+}
+
+static void count_items(void *state,
+                        unsigned char phrase,
+                        unsigned int num_branches,
+                        PParseTree *branches[]) {
+    unsigned int i;
+    for(i = 0; i < num_branches; ++i) {
+        if(branches[i]->type == PT_TERMINAL) {
+            ++num_items;
+        }
+    }
+}
+
+int main(void) {
+    PGrammar *grammar = grammar_alloc(P_List, 1, 1, 1, 1);
+    PParser *parser = parser_alloc();
+    G_ProductionRuleFunc *actions[1] = {&count_items};
+    unsigned char *text = mem_alloc(NUM_ITEMS * 2);
+    unsigned int i;
+
+    grammar_add_terminal_symbol(grammar, L_item, G_NON_EXCLUDABLE);
+    grammar_repeat_symbol(grammar, G_ONE_OR_MORE);
+    grammar_add_phrase(grammar);
+    grammar_add_production_rule(grammar, P_List);
+    grammar_add_tree_actions(grammar, TREE_TRAVERSE_POSTORDER, actions);
+
+    for(i = 0; i < NUM_ITEMS; ++i) {
+        text[i * 2] = 'x';
+        text[i * 2 + 1] = ' ';
+    }
+
+    parser_parse_text(
+        parser,
+        grammar,
+        (PScannerFunc *) &item_lexer,
+        text,
+        NUM_ITEMS * 2,
+        NULL
+    );
+
+    parser_free(parser);
+    grammar_free(grammar);
+    mem_free(text);
+
+    if(NUM_ITEMS != num_items) {
+        printf("long-list: expected %u items, got %u.\n", NUM_ITEMS, num_items);
+        return 1;
+    }
+
+    return 0;
+}
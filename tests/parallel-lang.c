@@ -0,0 +1,234 @@
+/*
+ * parallel-lang.c
+ *
+ * Parse a lang.g program serially and in parallel, split at the grammar's
+ * synchronization terminals, and make sure that the grammar actions see the
+ * same parse tree both times. The program is parsed with more pieces than
+ * workers, with more workers than units, and with no synchronization terminals
+ * in it at all.
+ */
+
+#include "lang-grammar.h"
+#include "lang-lexer.h"
+#include "tree-text.h"
+
+#define NUM_COPIES 500
+#define NUM_UNITS_PER_COPY 4
+#define NUM_WORKERS 4
+#define MANY_WORKERS (2 * NUM_UNITS_PER_COPY)
+
+static const char *program = (
+    "type Foo : Bar Baz, Qux.\n"
+    "type A : B.\n"
+    "def main(Int x, y; Str z) -> Int :\n"
+    "    with a { bind Foo(b _ Bar(c)) { print (x), pass. } bind Q(r) { pass. } },\n"
+    "    bind Baz(q) { pass. },\n"
+    "    (f), return (g), pass.\n"
+    "def other(B b) -> Bool : pass.\n"
+);
+
+/* the tree of a parse written out as text, and the number of units that the
+ * program has. */
+typedef struct {
+    TreeText tree;
+    unsigned int num_units;
+} ProgramText;
+
+/**
+ * Check that the keywords starting function and type definitions are the
+ * grammar's synchronization terminals, so that the parallel parse really is
+ * split up.
+ */
+static int has_sync_terminals(PGrammar *grammar) {
+    PScanner *scanner = scanner_alloc();
+    G_Terminal def,
+               type;
+
+    scanner_use_string(scanner, (unsigned char *) "def type");
+    def = lang_lexer(scanner);
+    type = lang_lexer(scanner);
+    scanner_free(scanner);
+
+    return def >= 0 && G_is_sync_terminal(grammar, def)
+        && type >= 0 && G_is_sync_terminal(grammar, type);
+}
+
+static void count_units(ProgramText *out,
+                        unsigned char phrase,
+                        unsigned int num_branches,
+                        PParseTree *branches[]) {
+    out->num_units = num_branches;
+}
+
+/**
+ * Parse the text serially and then in parallel with 'num_workers' workers.
+ * Returns 1 if both parses succeed, find 'num_units' units, and give the
+ * grammar actions the same parse tree.
+ */
+static int is_same_parallel(PParser *parser,
+                            PGrammar *grammar,
+                            unsigned char *text,
+                            unsigned int num_units,
+                            unsigned int num_workers) {
+    PScanner *scanner;
+    ProgramText serial = {{NULL, 0, 0}, 0},
+                parallel = {{NULL, 0, 0}, 0};
+    int is_same = 1,
+        is_serial_parsed,
+        is_parallel_parsed;
+
+    scanner = scanner_alloc();
+    scanner_use_string(scanner, text);
+    is_serial_parsed = parser_parse_tokens(
+        parser,
+        grammar,
+        scanner,
+        (PScannerFunc *) &lang_lexer,
+        &serial
+    );
+    scanner_free(scanner);
+
+    scanner = scanner_alloc();
+    scanner_use_string(scanner, text);
+    is_parallel_parsed = parser_parse_tokens_parallel(
+        parser,
+        grammar,
+        scanner,
+        (PScannerFunc *) &lang_lexer,
+        &parallel,
+        num_workers
+    );
+    scanner_free(scanner);
+
+    if(!is_serial_parsed || !is_parallel_parsed) {
+        printf(
+            "parallel-lang: the program failed to parse with %u workers.\n",
+            num_workers
+        );
+        is_same = 0;
+    } else if(num_units != serial.num_units) {
+        printf(
+            "parallel-lang: expected %u units, got %u.\n",
+            num_units,
+            serial.num_units
+        );
+        is_same = 0;
+    } else if(!is_same_text(&(serial.tree), &(parallel.tree))) {
+        printf(
+            "parallel-lang: parallel parse tree with %u workers differs from "
+            "serial one.\n",
+            num_workers
+        );
+        is_same = 0;
+    }
+
+    if(is_not_null(serial.tree.text)) {
+        mem_free(serial.tree.text);
+    }
+    if(is_not_null(parallel.tree.text)) {
+        mem_free(parallel.tree.text);
+    }
+
+    return is_same;
+}
+
+/**
+ * Parse text with a syntax error in parallel. Returns 1 if the parse fails
+ * without performing any actions.
+ */
+static int is_parallel_error(PParser *parser,
+                             PGrammar *grammar,
+                             unsigned char *text) {
+    PScanner *scanner = scanner_alloc();
+    ProgramText broken = {{NULL, 0, 0}, 0};
+    int is_parsed;
+
+    scanner_use_string(scanner, text);
+    is_parsed = parser_parse_tokens_parallel(
+        parser,
+        grammar,
+        scanner,
+        (PScannerFunc *) &lang_lexer,
+        &broken,
+        NUM_WORKERS
+    );
+    scanner_free(scanner);
+
+    if(is_not_null(broken.tree.text)) {
+        mem_free(broken.tree.text);
+        is_parsed = 1;
+    }
+
+    return !is_parsed;
+}
+
+int main(void) {
+    PGrammar *grammar = lang_grammar();
+    PParser *parser = parser_alloc();
+    G_ProductionRuleFunc **actions = mem_alloc(
+        grammar->num_productions * sizeof(G_ProductionRuleFunc *)
+    );
+    size_t length = strlen(program);
+    unsigned char *text = mem_alloc(NUM_COPIES * length + 1),
+                  empty[] = "",
+                  no_sync[] = "pass, (f).";
+    unsigned int i,
+                 num_units = NUM_COPIES * NUM_UNITS_PER_COPY;
+    int failed = 0;
+
+    print_trees(grammar);
+
+    for(i = 0; i < grammar->num_productions; ++i) {
+        actions[i] = &grammar_null_action;
+    }
+    actions[P_lang_Program] = (G_ProductionRuleFunc *) &count_units;
+    grammar_add_tree_actions(grammar, TREE_TRAVERSE_POSTORDER, actions);
+    mem_free(actions);
+
+    for(i = 0; i < NUM_COPIES; ++i) {
+        memcpy(text + i * length, program, length);
+    }
+    text[NUM_COPIES * length] = '\0';
+
+    if(!has_sync_terminals(grammar)) {
+        printf("parallel-lang: \"def\" and \"type\" are not synchronization terminals.\n");
+        failed = 1;
+
+    /* each worker has P_PARALLEL_CHUNKS_PER_WORKER pieces to parse, or a
+     * single worker has all of them */
+    } else if(!is_same_parallel(parser, grammar, text, num_units, NUM_WORKERS)
+           || !is_same_parallel(parser, grammar, text, num_units, 1)) {
+        failed = 1;
+
+    /* there are fewer units to split the last copy into than workers */
+    } else if(!is_same_parallel(
+        parser,
+        grammar,
+        text + (NUM_COPIES - 1) * length,
+        NUM_UNITS_PER_COPY,
+        MANY_WORKERS
+    )) {
+        failed = 1;
+
+    /* there are no synchronization terminals to split at */
+    } else if(!is_same_parallel(parser, grammar, empty, 0, NUM_WORKERS)) {
+        failed = 1;
+    } else if(!is_parallel_error(parser, grammar, no_sync)) {
+        printf("parallel-lang: the program without units was parsed.\n");
+        failed = 1;
+    }
+
+    /* break one of the units in the middle of the program: its piece fails to
+     * parse, and so must the whole parse, without any actions */
+    memcpy(text + (NUM_COPIES / 2) * length, "def ", 4);
+    if(!failed && !is_parallel_error(parser, grammar, text)) {
+        printf("parallel-lang: the broken program was parsed.\n");
+        failed = 1;
+    }
+
+    parser_free(parser);
+    grammar_free(grammar);
+    mem_free(text);
+
+    return failed;
+}
@@ -0,0 +1,178 @@
+/*
+ * parse-files.c
+ *
+ * Parse a batch of lang.g files with parse_files, some of which have syntax
+ * errors and one of which doesn't exist, and make sure that each file's result
+ * is reported and that the grammar actions of every file that could be parsed
+ * see the same parse tree as when the file is parsed on its own.
+ */
+
+#include "lang-grammar.h"
+#include "lang-lexer.h"
+#include "tree-text.h"
+
+#define NUM_FILES 12
+#define NUM_COPIES 20
+#define NUM_WORKERS 3
+
+static const char *program = (
+    "type Foo : Bar Baz, Qux.\n"
+    "def main(Int x, y; Str z) -> Int :\n"
+    "    with a { bind Foo(b _ Bar(c)) { print (x), pass. } bind Q(r) { pass. } },\n"
+    "    (f), return (g), pass.\n"
+);
+
+/* a function definition missing its return type */
+static const char *syntax_error = "def broken(Int x) -> : pass.\n";
+
+/**
+ * Get the name of the i'th file of the batch. Every third file has a syntax
+ * error, and the last file is never written.
+ */
+static void file_name(char *name, unsigned int i) {
+    sprintf(name, "build/parse-files-%u.ln", i);
+}
+
+static P_FileResult expected_result(unsigned int i) {
+    if(NUM_FILES - 1 == i) {
+        return P_FILE_NOT_OPENED;
+    } else if(1 == i % 3) {
+        return P_FILE_NOT_PARSED;
+    }
+    return P_FILE_PARSED;
+}
+
+/**
+ * Write out the i'th file of the batch, with the syntax error, if it has one,
+ * after i copies of the program.
+ */
+static int write_file(const char *name, unsigned int i) {
+    FILE *file = fopen(name, "wb");
+    unsigned int j;
+
+    if(is_null(file)) {
+        return 0;
+    }
+
+    for(j = 0; j < NUM_COPIES + i; ++j) {
+        fputs(program, file);
+        if(P_FILE_NOT_PARSED == expected_result(i) && j == i) {
+            fputs(syntax_error, file);
+        }
+    }
+
+    fclose(file);
+    return 1;
+}
+
+int main(void) {
+    PGrammar *grammar = lang_grammar();
+    PParser *parser = parser_alloc();
+    PScanner *scanner;
+    char names[NUM_FILES][64];
+    const char *file_names[NUM_FILES];
+    void *states[NUM_FILES];
+    TreeText batch[NUM_FILES],
+             single;
+    P_FileResult results[NUM_FILES];
+    unsigned int i,
+                 num_parsed,
+                 num_expected = 0;
+    int failed = 0;
+
+    print_trees(grammar);
+
+    for(i = 0; i < NUM_FILES; ++i) {
+        file_name(names[i], i);
+        file_names[i] = names[i];
+        states[i] = &(batch[i]);
+        batch[i].text = NULL;
+        batch[i].length = 0;
+        batch[i].capacity = 0;
+        results[i] = P_FILE_NOT_OPENED;
+
+        if(P_FILE_NOT_OPENED == expected_result(i)) {
+            remove(names[i]);
+        } else if(!write_file(names[i], i)) {
+            printf("parse-files: unable to write %s.\n", names[i]);
+            return 1;
+        } else if(P_FILE_PARSED == expected_result(i)) {
+            ++num_expected;
+        }
+    }
+
+    num_parsed = parse_files(
+        grammar,
+        (PScannerFunc *) &lang_lexer,
+        file_names,
+        states,
+        results,
+        NUM_FILES,
+        NUM_WORKERS
+    );
+
+    if(num_expected != num_parsed) {
+        printf(
+            "parse-files: expected %u files to be parsed, got %u.\n",
+            num_expected,
+            num_parsed
+        );
+        failed = 1;
+    }
+
+    for(i = 0; i < NUM_FILES && !failed; ++i) {
+        if(expected_result(i) != results[i]) {
+            printf(
+                "parse-files: expected result %d for %s, got %d.\n",
+                (int) expected_result(i),
+                names[i],
+                (int) results[i]
+            );
+            failed = 1;
+            break;
+        }
+
+        if(P_FILE_NOT_OPENED == results[i]) {
+            continue;
+        }
+
+        /* a file with a syntax error has no actions performed for it, so the
+         * parse on its own must fail and leave its text empty as well */
+        single.text = NULL;
+        single.length = 0;
+        single.capacity = 0;
+
+        scanner = scanner_alloc();
+        scanner_use_file(scanner, names[i]);
+        scanner_flush(scanner, 1);
+        if((P_FILE_PARSED == results[i]) != parser_parse_tokens(
+            parser,
+            grammar,
+            scanner,
+            (PScannerFunc *) &lang_lexer,
+            &single
+        )) {
+            printf("parse-files: %s parses differently on its own.\n", names[i]);
+            failed = 1;
+        } else if(!is_same_text(&single, &(batch[i]))) {
+            printf("parse-files: parse tree of %s differs.\n", names[i]);
+            failed = 1;
+        }
+        scanner_free(scanner);
+
+        if(is_not_null(single.text)) {
+            mem_free(single.text);
+        }
+    }
+
+    for(i = 0; i < NUM_FILES; ++i) {
+        if(is_not_null(batch[i].text)) {
+            mem_free(batch[i].text);
+        }
+    }
+
+    parser_free(parser);
+    grammar_free(grammar);
+
+    return failed;
+}
@@ -0,0 +1,261 @@
+/*
+ * profile-lang.c
+ *
+ * Parse a fixed lang.g program with a profiling parser context and check the
+ * counters of a production whose work can be worked out by hand, then make sure
+ * that the profile printed as JSON is well-formed JSON.
+ */
+
+#include "lang-grammar.h"
+#include "lang-lexer.h"
+
+#define NUM_COPIES 10
+
+/* TypeList : -type -Self | -type ;
+ *
+ * In each copy TypeList is pushed at "Bar", "Baz" and "Qux". It can't start at
+ * "," or ".", so both times that it's applied there it misses without being
+ * pushed. Its first phrase fails, and it backtracks into its second one, at
+ * "Baz" and at "Qux". The production never gets applied twice at the same
+ * token, so it never hits the cache. */
+static const char *program = "type Foo : Bar Baz, Qux.\n";
+
+#define TYPE_LIST_PUSHES (3 * NUM_COPIES)
+#define TYPE_LIST_MEMO_HITS 0
+#define TYPE_LIST_MEMO_MISSES (5 * NUM_COPIES)
+#define TYPE_LIST_LOCAL_BACKTRACKS (2 * NUM_COPIES)
+
+static const char *profile_file_name = "build/profile-lang.json";
+
+/* -------------------------------------------------------------------------- */
+
+static void skip_space(const char **c) {
+    while(' ' == **c || '\n' == **c || '\t' == **c || '\r' == **c) {
+        ++*c;
+    }
+}
+
+static int is_json_value(const char **c);
+
+static int is_json_string(const char **c) {
+    if('"' != **c) {
+        return 0;
+    }
+    for(++*c; '"' != **c; ++*c) {
+        if('\0' == **c || '\n' == **c) {
+            return 0;
+        } else if('\\' == **c) {
+            ++*c;
+            if('\0' == **c) {
+                return 0;
+            }
+        }
+    }
+    ++*c;
+    return 1;
+}
+
+static int is_json_number(const char **c) {
+    const char *start;
+
+    if('-' == **c) {
+        ++*c;
+    }
+    for(start = *c; isdigit((unsigned char) **c); ++*c) {
+        /* digits */
+    }
+    return *c > start;
+}
+
+/**
+ * Check that either an object or an array comes next, and skip over it.
+ */
+static int is_json_container(const char **c, char open, char close) {
+    if(open != **c) {
+        return 0;
+    }
+
+    ++*c;
+    skip_space(c);
+    if(close == **c) {
+        ++*c;
+        return 1;
+    }
+
+    for(;;) {
+        skip_space(c);
+        if('{' == open) {
+            if(!is_json_string(c)) {
+                return 0;
+            }
+            skip_space(c);
+            if(':' != **c) {
+                return 0;
+            }
+            ++*c;
+            skip_space(c);
+        }
+        if(!is_json_value(c)) {
+            return 0;
+        }
+        skip_space(c);
+        if(close == **c) {
+            ++*c;
+            return 1;
+        } else if(',' != **c) {
+            return 0;
+        }
+        ++*c;
+    }
+}
+
+/**
+ * Check that a JSON value comes next, and skip over it. Only the kinds of
+ * values that parser_print_profile prints are recognized.
+ */
+static int is_json_value(const char **c) {
+    skip_space(c);
+    switch(**c) {
+        case '{': return is_json_container(c, '{', '}');
+        case '[': return is_json_container(c, '[', ']');
+        case '"': return is_json_string(c);
+        default: return is_json_number(c);
+    }
+}
+
+static int is_json(const char *text) {
+    const char *c = text;
+    if(!is_json_value(&c)) {
+        return 0;
+    }
+    skip_space(&c);
+    return '\0' == *c;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Print the profile of the last parse as JSON into a file and read it back.
+ */
+static char *profile_as_json(PParser *parser) {
+    FILE *file;
+    char *text;
+    long length;
+    int out = dup(STDOUT_FILENO);
+
+    fflush(stdout);
+    if(is_null(freopen(profile_file_name, "w", stdout))) {
+        return NULL;
+    }
+    parser_print_profile(parser, NULL, 1);
+    fflush(stdout);
+    dup2(out, STDOUT_FILENO);
+    close(out);
+
+    file = fopen(profile_file_name, "rb");
+    if(is_null(file)) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    text = mem_alloc((size_t) length + 1);
+    if(is_null(text)) {
+        mem_error("Unable to allocate the profile's text.");
+    }
+    text[fread(text, 1, (size_t) length, file)] = '\0';
+    fclose(file);
+
+    return text;
+}
+
+/**
+ * Parse the program and check the counters of TypeList.
+ */
+static int has_expected_counts(PParser *parser,
+                               PGrammar *grammar,
+                               unsigned char *text) {
+    PScanner *scanner = scanner_alloc();
+    uint32_t *counts;
+    int is_parsed;
+
+    scanner_use_string(scanner, text);
+    is_parsed = parser_parse_tokens(
+        parser,
+        grammar,
+        scanner,
+        (PScannerFunc *) &lang_lexer,
+        NULL
+    );
+    scanner_free(scanner);
+
+    if(!is_parsed) {
+        printf("profile-lang: the program failed to parse.\n");
+        return 0;
+    }
+
+    counts = parser->profile.productions[P_lang_TypeList];
+    if(TYPE_LIST_PUSHES != counts[P_PROFILE_PUSHES]
+    || TYPE_LIST_MEMO_HITS != counts[P_PROFILE_MEMO_HITS]
+    || TYPE_LIST_MEMO_MISSES != counts[P_PROFILE_MEMO_MISSES]
+    || TYPE_LIST_LOCAL_BACKTRACKS != counts[P_PROFILE_LOCAL_BACKTRACKS]) {
+        printf(
+            "profile-lang: expected TypeList to have %u pushes, %u hits, "
+            "%u misses and %u local backtracks, got %u, %u, %u and %u.\n",
+            TYPE_LIST_PUSHES,
+            TYPE_LIST_MEMO_HITS,
+            TYPE_LIST_MEMO_MISSES,
+            TYPE_LIST_LOCAL_BACKTRACKS,
+            counts[P_PROFILE_PUSHES],
+            counts[P_PROFILE_MEMO_HITS],
+            counts[P_PROFILE_MEMO_MISSES],
+            counts[P_PROFILE_LOCAL_BACKTRACKS]
+        );
+        return 0;
+    }
+
+    return 1;
+}
+
+int main(void) {
+    PGrammar *grammar = lang_grammar();
+    PParser *parser = parser_alloc();
+    size_t length = strlen(program);
+    unsigned char *text = mem_alloc(NUM_COPIES * length + 1);
+    char *json;
+    unsigned int i;
+    int failed = 0;
+
+    for(i = 0; i < NUM_COPIES; ++i) {
+        memcpy(text + i * length, program, length);
+    }
+    text[NUM_COPIES * length] = '\0';
+
+    parser_enable_profiling(parser);
+
+    /* the counters are cleared when the second parse starts */
+    if(!has_expected_counts(parser, grammar, text)
+    || !has_expected_counts(parser, grammar, text)) {
+        failed = 1;
+    } else {
+        json = profile_as_json(parser);
+
+        if(is_null(json)) {
+            printf("profile-lang: unable to print the profile.\n");
+            failed = 1;
+        } else {
+            if(!is_json(json)) {
+                printf("profile-lang: the profile is not valid JSON.\n");
+                failed = 1;
+            }
+            mem_free(json);
+        }
+    }
+
+    parser_free(parser);
+    grammar_free(grammar);
+    mem_free(text);
+
+    return failed;
+}
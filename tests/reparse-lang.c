@@ -0,0 +1,289 @@
+/*
+ * reparse-lang.c
+ *
+ * Parse a lang.g program incrementally, edit it all over, and make sure that
+ * after each edit the grammar actions see the same parse tree, down to the ids
+ * and positions of its terminals, as they do when the edited text is parsed
+ * from scratch. Some of the edits type in or erase a definition one character
+ * at a time, so that the text can't be parsed until they are done.
+ */
+
+#include "lang-grammar.h"
+#include "lang-lexer.h"
+#include "tree-text.h"
+
+#define NUM_COPIES 20
+#define NUM_EDITS 400
+#define NUM_TYPED 6
+
+static const char *program = (
+    "type Foo : Bar Baz, Qux.\n"
+    "type A : B.\n"
+    "def main(Int x, y; Str z) -> Int :\n"
+    "    with a { bind Foo(b _ Bar(c)) { print (x), pass. } bind Q(r) { pass. } },\n"
+    "    bind Baz(q) { pass. },\n"
+    "    (f), return (g), pass.\n"
+    "def other(B b) -> Bool : pass.\n"
+);
+
+static const char *typed = "def typed(Int n; Foo f) -> Int : print (n), pass.\n";
+
+typedef struct {
+    unsigned char *text;
+    uint32_t length,
+             capacity;
+} Text;
+
+/**
+ * Replace the characters in [start, end) of some text with 'length' characters
+ * of 'with'.
+ */
+static void edit(Text *text,
+                 uint32_t start,
+                 uint32_t end,
+                 const unsigned char *with,
+                 uint32_t length) {
+
+    uint32_t new_length = text->length - (end - start) + length;
+
+    if(new_length + 1 > text->capacity) {
+        text->capacity = 2 * (new_length + 1);
+        text->text = mem_realloc(text->text, text->capacity);
+        if(is_null(text->text)) {
+            mem_error("Unable to grow text.");
+        }
+    }
+
+    memmove(text->text + start + length, text->text + end, text->length - end);
+    memcpy(text->text + start, with, length);
+    text->length = new_length;
+}
+
+/**
+ * Find the start of the first function or type definition at or after 'i', or
+ * the end of the text if there isn't one.
+ */
+static uint32_t find_definition(Text *text, uint32_t i) {
+    for(; i < text->length; ++i) {
+        if((0 == i || '\n' == text->text[i - 1])
+        && (0 == strncmp((char *) text->text + i, "def ", 4)
+         || 0 == strncmp((char *) text->text + i, "type ", 5))) {
+            break;
+        }
+    }
+    return i;
+}
+
+/**
+ * Make an edit to the text that keeps it a valid program, and make the same
+ * edit to the text being parsed incrementally.
+ */
+static int make_edit(PParser *parser,
+                     Text *text,
+                     Text *cut,
+                     unsigned int n,
+                     TreeText *out) {
+
+    uint32_t i = (uint32_t) ((n * 7919U) % (text->length + 1)),
+             j;
+
+    switch(n % 4) {
+
+    /* add whitespace before whitespace, or before the end of the text */
+    case 0:
+        while(i < text->length
+           && ' ' != text->text[i]
+           && '\n' != text->text[i]) {
+            ++i;
+        }
+        edit(text, i, i, (const unsigned char *) (n % 8 ? " " : "\n"), 1);
+        return parser_reparse_text(
+            parser, i, i, (const unsigned char *) (n % 8 ? " " : "\n"), 1, out
+        );
+
+    /* rename a type */
+    case 1:
+        while(i < text->length
+           && !(text->text[i] >= 'A' && text->text[i] <= 'Z')) {
+            ++i;
+        }
+        if(i < text->length) {
+            edit(text, i + 1, i + 1, (const unsigned char *) "q", 1);
+            return parser_reparse_text(
+                parser, i + 1, i + 1, (const unsigned char *) "q", 1, out
+            );
+        }
+        break;
+
+    /* cut out a definition */
+    case 2:
+        i = find_definition(text, i);
+        j = find_definition(text, i + 1);
+        if(i < text->length && 0 == cut->length) {
+            edit(cut, 0, 0, text->text + i, j - i);
+            edit(text, i, j, (const unsigned char *) "", 0);
+            return parser_reparse_text(
+                parser, i, j, (const unsigned char *) "", 0, out
+            );
+        }
+        break;
+
+    /* put the definition that was cut out back in somewhere else */
+    default:
+        i = find_definition(text, i);
+        edit(text, i, i, cut->text, cut->length);
+        j = cut->length;
+        cut->length = 0;
+        return parser_reparse_text(parser, i, i, text->text + i, j, out);
+    }
+
+    return parser_reparse_text(parser, 0, 0, (const unsigned char *) "", 0, out);
+}
+
+/**
+ * Check that reparsing the text gave the same tree as parsing it from scratch,
+ * or that neither could parse it.
+ */
+static int is_same_tree(PGrammar *grammar,
+                        Text *text,
+                        TreeText *reparsed,
+                        int is_reparsed) {
+    PParser *parser = parser_alloc();
+    TreeText parsed = {NULL, 0, 0};
+    int is_parsed,
+        is_same;
+
+    is_parsed = parser_parse_text(
+        parser,
+        grammar,
+        (PScannerFunc *) &lang_lexer,
+        text->text,
+        text->length,
+        &parsed
+    );
+
+    is_same = (is_parsed == is_reparsed) && is_same_text(&parsed, reparsed);
+
+    parser_free(parser);
+    if(is_not_null(parsed.text)) {
+        mem_free(parsed.text);
+    }
+
+    return is_same;
+}
+
+/**
+ * Type a definition into the text one character at a time, just before the
+ * first definition at or after 'i', and then erase it again one character at a
+ * time from its end. Every edit but the last of each is left unparseable.
+ * Returns the number of edits that gave a different parse tree.
+ */
+static unsigned int type_definition(PParser *parser,
+                                    PGrammar *grammar,
+                                    Text *text,
+                                    uint32_t i,
+                                    TreeText *out) {
+
+    uint32_t j,
+             length = (uint32_t) strlen(typed);
+    unsigned int num_failed = 0;
+    int is_parsed;
+
+    i = find_definition(text, i);
+
+    for(j = 0; j < length; ++j) {
+        out->length = 0;
+        edit(text, i + j, i + j, (const unsigned char *) typed + j, 1);
+        is_parsed = parser_reparse_text(
+            parser, i + j, i + j, (const unsigned char *) typed + j, 1, out
+        );
+        num_failed += !is_same_tree(grammar, text, out, is_parsed);
+    }
+
+    for(j = length; j > 0; --j) {
+        out->length = 0;
+        edit(text, i + j - 1, i + j, (const unsigned char *) "", 0);
+        is_parsed = parser_reparse_text(
+            parser, i + j - 1, i + j, (const unsigned char *) "", 0, out
+        );
+        num_failed += !is_same_tree(grammar, text, out, is_parsed);
+    }
+
+    return num_failed;
+}
+
+int main(void) {
+    PGrammar *grammar = lang_grammar();
+    PParser *parser = parser_alloc();
+    TreeText out = {NULL, 0, 0};
+    Text text = {NULL, 0, 0},
+         cut = {NULL, 0, 0};
+    uint32_t length = (uint32_t) strlen(program);
+    unsigned int i;
+    int failed = 0,
+        is_parsed;
+
+    print_trees(grammar);
+
+    for(i = 0; i < NUM_COPIES; ++i) {
+        edit(&text, text.length, text.length, (const unsigned char *) program, length);
+    }
+
+    parser_parse_text(
+        parser,
+        grammar,
+        (PScannerFunc *) &lang_lexer,
+        text.text,
+        text.length,
+        &out
+    );
+
+    for(i = 0; i < NUM_EDITS && !failed; ++i) {
+        out.length = 0;
+        is_parsed = make_edit(parser, &text, &cut, i, &out);
+
+        if(!is_same_tree(grammar, &text, &out, is_parsed)) {
+            printf("reparse-lang: edit %u gave a different parse tree.\n", i);
+            failed = 1;
+        }
+    }
+
+    for(i = 0; i < NUM_TYPED && !failed; ++i) {
+        if(0 < type_definition(
+            parser,
+            grammar,
+            &text,
+            (uint32_t) ((i * 104729U) % (text.length + 1)),
+            &out
+        )) {
+            printf("reparse-lang: typing %u gave a different parse tree.\n", i);
+            failed = 1;
+        }
+    }
+
+    /* empty the text out, then put all of it back in at once */
+    edit(&cut, 0, cut.length, text.text, text.length);
+    edit(&text, 0, text.length, (const unsigned char *) "", 0);
+
+    out.length = 0;
+    parser_reparse_text(
+        parser, 0, cut.length, (const unsigned char *) "", 0, &out
+    );
+
+    out.length = 0;
+    edit(&text, 0, 0, cut.text, cut.length);
+    is_parsed = parser_reparse_text(parser, 0, 0, cut.text, cut.length, &out);
+
+    if(!failed && !is_same_tree(grammar, &text, &out, is_parsed)) {
+        printf("reparse-lang: refilled text gave a different parse tree.\n");
+        failed = 1;
+    }
+
+    parser_free(parser);
+    grammar_free(grammar);
+    mem_free(text.text);
+    mem_free(cut.text);
+    mem_free(out.text);
+
+    return failed;
+}
@@ -0,0 +1,97 @@
+/*
+ * tree-text.c
+ *
+ * Write out the parse trees that the grammar actions see as text, so that the
+ * trees that different kinds of parses give can be compared.
+ */
+
+#include "tree-text.h"
+
+void append(TreeText *out, const char *text) {
+    size_t length = strlen(text);
+
+    if(out->length + length + 1 > out->capacity) {
+        out->capacity = 2 * (out->length + length + 1);
+        out->text = mem_realloc(out->text, out->capacity);
+        if(is_null(out->text)) {
+            mem_error("Unable to grow tree text.");
+        }
+    }
+
+    memcpy(out->text + out->length, text, length + 1);
+    out->length += length;
+}
+
+/**
+ * Write out a non-terminal along with its terminals and their ids and
+ * positions.
+ */
+void print_tree(TreeText *out,
+                unsigned char phrase,
+                unsigned int num_branches,
+                PParseTree *branches[]) {
+    char buffer[128];
+    unsigned int i;
+    PT_Terminal *term;
+    PString *lexeme;
+
+    sprintf(buffer, "(%u:", phrase);
+    append(out, buffer);
+
+    for(i = 0; i < num_branches; ++i) {
+        if(branches[i]->type == PT_TERMINAL) {
+            term = (PT_Terminal *) branches[i];
+            lexeme = PT_get_lexeme(term);
+            sprintf(
+                buffer,
+                " %d'%.64s'#%u@%u:%u",
+                term->terminal,
+                is_null(lexeme) ? "" : lexeme->str,
+                term->id,
+                term->line,
+                term->column
+            );
+        } else if(branches[i]->type == PT_NON_TERMINAL) {
+            sprintf(
+                buffer,
+                " P%d/%u",
+                ((PT_NonTerminal *) branches[i])->production,
+                tree_get_num_branches((PTree *) branches[i])
+            );
+        } else {
+            sprintf(buffer, " <>");
+        }
+        append(out, buffer);
+    }
+
+    append(out, ")\n");
+}
+
+/**
+ * Make every production of a grammar write out its trees with print_tree.
+ */
+void print_trees(PGrammar *grammar) {
+    G_ProductionRuleFunc **actions = mem_alloc(
+        grammar->num_productions * sizeof(G_ProductionRuleFunc *)
+    );
+    unsigned int i;
+
+    if(is_null(actions)) {
+        mem_error("Unable to allocate tree actions.");
+    }
+
+    for(i = 0; i < grammar->num_productions; ++i) {
+        actions[i] = (G_ProductionRuleFunc *) &print_tree;
+    }
+
+    grammar_add_tree_actions(grammar, TREE_TRAVERSE_POSTORDER, actions);
+    mem_free(actions);
+}
+
+/**
+ * Check that two trees were written out the same way.
+ */
+int is_same_text(TreeText *a, TreeText *b) {
+    return a->length == b->length
+        && (0 == a->length || 0 == memcmp(a->text, b->text, a->length));
+}
@@ -0,0 +1,31 @@
+/*
+ * tree-text.h
+ *
+ * Write out the parse trees that the grammar actions see as text, so that the
+ * trees that different kinds of parses give can be compared.
+ */
+
+#ifndef TREETEXT_H_
+#define TREETEXT_H_
+
+#include <p-grammar.h>
+#include <p-parser.h>
+
+typedef struct {
+    char *text;
+    size_t length,
+           capacity;
+} TreeText;
+
+void append(TreeText *out, const char *text);
+
+void print_tree(TreeText *out,
+                unsigned char phrase,
+                unsigned int num_branches,
+                PParseTree *branches[]);
+
+void print_trees(PGrammar *grammar);
+
+int is_same_text(TreeText *a, TreeText *b);
+
+#endif /* TREETEXT_H_ */